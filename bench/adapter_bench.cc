@@ -0,0 +1,240 @@
+// Microbenchmarks of the adapter hot paths
+//
+// Every benchmark runs without a Wifi stack: frames are injected into and
+// captured from a synthetic NetDevice. Results are written as one JSON
+// object per line (ns/op, allocations/op, bytes/op), see bench/README.md.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include "adapter/vanetza_ns3_adapter.hpp"
+#include "adapter/vanetza_wrapper.hpp"
+#include "adapter/ns3_interface.hpp"
+#include "adapter/local_dynamic_map.hpp"
+#include "adapter/fast_link_net_device.hpp"
+#include "adapter/btp_b_header.hpp"
+#include "messages/cam_codec.hpp"
+#include "messages/uper_cam_encoder.hpp"
+#include "utils/arena.hpp"
+#include "bench_harness.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+using namespace vanetza_ns3;
+
+namespace {
+
+const uint16_t kItsProtocol = 0x8947;
+
+/**
+ * Device that accepts frames without transmitting them; received frames
+ * are injected through FastLinkNetDevice::Receive.
+ */
+class SinkNetDevice : public FastLinkNetDevice {
+public:
+    bool Send(Ptr<Packet> packet, const Address&, uint16_t) override
+    {
+        ++m_sent;
+        bench::doNotOptimize(packet);
+        return true;
+    }
+
+    uint64_t m_sent = 0;
+};
+
+messages::CamMessage
+SampleCam(uint32_t stationId)
+{
+    messages::CamMessage cam;
+    cam.stationId = stationId;
+    cam.timestamp = 42;
+    cam.posX = 512.25f;
+    cam.posY = 3.5f;
+    cam.speed = 27.8f;
+    cam.heading = 90.0f;
+    return cam;
+}
+
+std::vector<uint8_t>
+SamplePayload()
+{
+    std::vector<uint8_t> payload(messages::CamLayout::size);
+    payload.resize(messages::encodeCam(SampleCam(7), payload.data(), payload.size()));
+    return payload;
+}
+
+// CAM as it arrives on the air: GeoNetworking SHB and BTP-B (port 2001)
+// headers in front of the codec payload
+Ptr<Packet>
+SampleFrame(const NS3Interface& interface)
+{
+    const std::vector<uint8_t> payload = SamplePayload();
+    Ptr<Packet> frame = Create<Packet>(payload.data(), payload.size());
+    interface.addShbHeaders(frame, BtpBHeader::kCamPort);
+    return frame;
+}
+
+// Adapter attached to a synthetic device and started by the simulator
+Ptr<VanetzaNS3Adapter>
+StartAdapter(Ptr<SinkNetDevice> device, bool eventArena)
+{
+    Ptr<Node> node = CreateObject<Node>();
+    device->SetAddress(Mac48Address::Allocate());
+    node->AddDevice(device);
+
+    Ptr<VanetzaNS3Adapter> adapter = CreateObject<VanetzaNS3Adapter>();
+    adapter->SetDevice(device);
+    adapter->SetStationId(node->GetId() + 1);
+    adapter->SetAttribute("UseEventArena", BooleanValue(eventArena));
+    adapter->RegisterCamReceiver([](const uint8_t* data, std::size_t size) {
+        bench::doNotOptimize(data);
+        bench::doNotOptimize(size);
+        return true;
+    });
+    adapter->SetStartTime(Seconds(0));
+    node->AddApplication(adapter);
+    return adapter;
+}
+
+void
+RunCodecBenchmarks(bench::Runner& runner)
+{
+    const messages::CamMessage cam = SampleCam(1);
+    uint8_t buffer[messages::CamLayout::size];
+    messages::encodeCam(cam, buffer, sizeof(buffer));
+
+    runner.run("cam_codec_encode", [&](uint64_t n) {
+        uint8_t out[messages::CamLayout::size];
+        for (uint64_t i = 0; i < n; ++i) {
+            bench::doNotOptimize(messages::encodeCam(cam, out, sizeof(out)));
+            bench::doNotOptimize(out);
+        }
+    });
+
+    runner.run("cam_codec_decode", [&](uint64_t n) {
+        messages::CamMessage decoded;
+        for (uint64_t i = 0; i < n; ++i) {
+            bench::doNotOptimize(messages::decodeCam(buffer, sizeof(buffer), decoded));
+            bench::doNotOptimize(decoded);
+        }
+    });
+
+    for (bool cached : { true, false }) {
+        messages::UperCamEncoder encoder(1, messages::CamVehicleProfile(), cached);
+        runner.run(cached ? "uper_cam_encode_cached" : "uper_cam_encode_uncached", [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                vanetza::ByteBuffer encoded = encoder.encode(cam, i * 100, i % 5 == 0);
+                bench::doNotOptimize(encoded.data());
+            }
+        });
+    }
+}
+
+void
+RunLdmBenchmarks(bench::Runner& runner)
+{
+    // 1000 neighbours spread over 2 km of road
+    LocalDynamicMap ldm;
+    for (uint32_t id = 1; id <= 1000; ++id) {
+        ldm.update(id, 2.0f * id, (id % 4) * 3.5f, 25.0f, 90.0f, 0);
+    }
+
+    runner.run("ldm_update_1000", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            uint32_t id = static_cast<uint32_t>(i % 1000) + 1;
+            ldm.update(id, 2.0f * id + 0.1f, (id % 4) * 3.5f, 25.0f, 90.0f, 100);
+        }
+    });
+
+    std::vector<uint32_t> neighbours;
+    runner.run("ldm_neighbours_within_300m", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            bench::doNotOptimize(ldm.neighboursWithin(static_cast<float>(i % 2000), 0.0f, 300.0f, neighbours));
+        }
+    });
+}
+
+void
+RunStackBenchmarks(bench::Runner& runner)
+{
+    Ptr<SinkNetDevice> sinkDevice = CreateObject<SinkNetDevice>();
+    Ptr<SinkNetDevice> arenaDevice = CreateObject<SinkNetDevice>();
+    Ptr<SinkNetDevice> heapDevice = CreateObject<SinkNetDevice>();
+    Ptr<VanetzaNS3Adapter> arenaAdapter = StartAdapter(arenaDevice, true);
+    Ptr<VanetzaNS3Adapter> heapAdapter = StartAdapter(heapDevice, false);
+
+    // Let the simulator start the applications (receive callbacks, stacks)
+    Simulator::Stop(MilliSeconds(1));
+    Simulator::Run();
+
+    sinkDevice->SetAddress(Mac48Address::Allocate());
+    NS3Interface interface(sinkDevice);
+    Ptr<Packet> frame = SampleFrame(interface);
+    const Mac48Address from = Mac48Address::Allocate();
+    const std::vector<uint8_t> payload = SamplePayload();
+
+    // VanetzaNS3Adapter::ReceiveFromNS3Raw through the device's receive callback
+    runner.run("adapter_receive_event_arena", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            arenaDevice->Receive(frame, kItsProtocol, from);
+        }
+    });
+    runner.run("adapter_receive_heap", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            heapDevice->Receive(frame, kItsProtocol, from);
+        }
+    });
+
+    // VanetzaNS3Adapter::SendCam
+    runner.run("adapter_send_cam", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            bench::doNotOptimize(arenaAdapter->SendCam(payload.data(), payload.size()));
+        }
+    });
+
+    // NS3Interface::sendPacket
+    runner.run("ns3_interface_send_packet", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            bench::doNotOptimize(interface.sendPacket(payload.data(), payload.size()));
+        }
+    });
+
+    // VanetzaWrapper::receivePacket
+    VanetzaWrapper wrapper(&interface, 1);
+    runner.run("wrapper_receive_packet", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            wrapper.receivePacket(payload.data(), payload.size());
+        }
+    });
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::string filter;
+    std::string output;
+    double minTime = 0.5;
+
+    CommandLine cmd;
+    cmd.AddValue("filter", "Only run benchmarks whose name contains this text", filter);
+    cmd.AddValue("minTime", "Minimum measured time per benchmark in seconds", minTime);
+    cmd.AddValue("output", "Write the JSON lines to this file instead of stdout", output);
+    cmd.Parse(argc, argv);
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+    }
+    bench::Runner runner(output.empty() ? std::cout : file, filter, minTime);
+
+    RunCodecBenchmarks(runner);
+    RunLdmBenchmarks(runner);
+    RunStackBenchmarks(runner);
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Global operator new/delete replacements counting heap allocations.
+// Linked into benchmark executables only.
+
+#include "bench_harness.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+vanetza_ns3::bench::AllocationCounters g_counters;
+
+void*
+CountedAllocate(std::size_t size)
+{
+    ++g_counters.allocations;
+    g_counters.bytes += size;
+    void* p = std::malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+} // namespace
+
+namespace vanetza_ns3 {
+namespace bench {
+
+AllocationCounters
+allocationCounters()
+{
+    return g_counters;
+}
+
+} // namespace bench
+} // namespace vanetza_ns3
+
+void* operator new(std::size_t size) { return CountedAllocate(size); }
+void* operator new[](std::size_t size) { return CountedAllocate(size); }
+
+void*
+operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return CountedAllocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void*
+operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return CountedAllocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
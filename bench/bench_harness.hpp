@@ -0,0 +1,133 @@
+/**
+ * @file bench_harness.hpp
+ * @brief Minimal microbenchmark harness with allocation accounting
+ */
+
+#ifndef BENCH_HARNESS_HPP
+#define BENCH_HARNESS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vanetza_ns3 {
+namespace bench {
+
+/**
+ * @brief Heap allocation counters, maintained by the replaced operator new
+ */
+struct AllocationCounters {
+    uint64_t allocations = 0;  ///< Calls to operator new
+    uint64_t bytes = 0;        ///< Bytes requested from operator new
+};
+
+/**
+ * @brief Get the allocations made by this process so far
+ * @return The counters (defined in alloc_counter.cpp)
+ */
+AllocationCounters allocationCounters();
+
+/**
+ * @brief Keep the compiler from optimising a value away
+ * @param value The value
+ */
+template<typename T>
+inline void
+doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Result of one benchmark
+ */
+struct Result {
+    std::string name;        ///< Benchmark name
+    uint64_t iterations = 0; ///< Measured iterations
+    double nsPerOp = 0.0;    ///< Wall-clock nanoseconds per iteration
+    double allocsPerOp = 0.0;///< Heap allocations per iteration
+    double bytesPerOp = 0.0; ///< Heap bytes per iteration
+};
+
+/**
+ * @brief Runs benchmarks and writes their results as JSON lines
+ *
+ * A benchmark is a function that performs a given number of iterations
+ * of the measured operation. The runner doubles the iteration count until
+ * a run takes at least the minimum time, then reports that run.
+ */
+class Runner {
+public:
+    /**
+     * @brief Constructor
+     * @param out Stream receiving one JSON object per benchmark
+     * @param filter Only run benchmarks whose name contains this text
+     * @param minTime Minimum duration of the reported run in seconds
+     */
+    Runner(std::ostream& out, std::string filter, double minTime) :
+        m_out(out),
+        m_filter(std::move(filter)),
+        m_minTime(minTime)
+    {
+    }
+
+    /**
+     * @brief Run a benchmark
+     * @param name Benchmark name
+     * @param body Performs the given number of iterations
+     */
+    void run(const std::string& name, const std::function<void(uint64_t)>& body)
+    {
+        if (!m_filter.empty() && name.find(m_filter) == std::string::npos) {
+            return;
+        }
+
+        // Warm up caches, pools and lazily created state
+        body(1);
+
+        Result result;
+        result.name = name;
+        for (uint64_t iterations = 1;; iterations *= 2) {
+            const AllocationCounters before = allocationCounters();
+            const auto start = std::chrono::steady_clock::now();
+            body(iterations);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            const AllocationCounters after = allocationCounters();
+            if (seconds >= m_minTime || iterations >= (uint64_t(1) << 40)) {
+                result.iterations = iterations;
+                result.nsPerOp = seconds * 1e9 / iterations;
+                result.allocsPerOp = static_cast<double>(after.allocations - before.allocations) / iterations;
+                result.bytesPerOp = static_cast<double>(after.bytes - before.bytes) / iterations;
+                break;
+            }
+        }
+
+        m_out << "{\"benchmark\":\"" << result.name << "\""
+              << ",\"iterations\":" << result.iterations
+              << ",\"ns_per_op\":" << result.nsPerOp
+              << ",\"allocs_per_op\":" << result.allocsPerOp
+              << ",\"bytes_per_op\":" << result.bytesPerOp << "}" << std::endl;
+        m_results.push_back(result);
+    }
+
+    /**
+     * @brief Get the results of all benchmarks run so far
+     * @return The results
+     */
+    const std::vector<Result>& results() const { return m_results; }
+
+private:
+    std::ostream& m_out;           ///< JSON lines output
+    std::string m_filter;          ///< Name filter
+    double m_minTime;              ///< Minimum run duration in seconds
+    std::vector<Result> m_results; ///< Results so far
+};
+
+} // namespace bench
+} // namespace vanetza_ns3
+
+#endif // BENCH_HARNESS_HPP
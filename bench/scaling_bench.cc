@@ -0,0 +1,333 @@
+// Macro scaling benchmark built on cam_simulation_example
+//
+// Runs the example scenario for every combination of fleet size and CAM
+// generation mode, one process per point so that memory figures are not
+// polluted by earlier points, and reports wall time, simulator events/s,
+// peak RSS and RSS per vehicle after setup and in steady state as JSON
+// lines. With --gridChannel every point runs on the Wi-Fi link model with
+// both the stock Yans channel and the range-culling GridSpectrumChannel
+// (which also swaps YansWifiPhy for SpectrumWifiPhy), and with --batchedGeneration both with private CAM timers and with the
+// shared CamGenerationEngine; the events/s of all variants of a point are
+// summarised side by side. With --baseline
+// the results are compared against a stored run and the benchmark fails if
+// any point regressed by more than --threshold.
+
+#include "utils/process_utils.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace vanetza_ns3;
+
+#ifndef CAM_EXAMPLE_PATH
+#define CAM_EXAMPLE_PATH "./cam_simulation_example"
+#endif
+
+namespace {
+
+struct ScalingPoint {
+    uint32_t nVehicles = 0;
+    std::string mode;            ///< CAM interval in seconds, or "dynamic"
+    std::string channel;         ///< Channel: fast, yans or grid
+    std::string generation;      ///< CAM timers: private or batched
+    double wallSeconds = 0.0;
+    double eventsPerSecond = 0.0;
+    double peakRssBytes = 0.0;
+    double setupRssPerVehicle = 0.0;
+    double steadyRssPerVehicle = 0.0;
+};
+
+std::vector<std::string>
+SplitList(const std::string& text)
+{
+    std::vector<std::string> items;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Value of "key=..." in the example's RESULT line
+double
+ResultField(const std::string& output, const std::string& key)
+{
+    std::size_t line = output.rfind("RESULT ");
+    if (line == std::string::npos) {
+        return 0.0;
+    }
+    std::size_t pos = output.find(" " + key + "=", line);
+    return pos == std::string::npos ? 0.0 : std::strtod(output.c_str() + pos + key.size() + 2, nullptr);
+}
+
+// Value of "key":... in a JSON line
+double
+JsonField(const std::string& line, const std::string& key)
+{
+    std::size_t pos = line.find("\"" + key + "\":");
+    if (pos == std::string::npos) {
+        return 0.0;
+    }
+    pos += key.size() + 3;
+    if (line[pos] == '"') {
+        ++pos;
+    }
+    return std::strtod(line.c_str() + pos, nullptr);
+}
+
+std::string
+JsonString(const std::string& line, const std::string& key)
+{
+    std::size_t pos = line.find("\"" + key + "\":\"");
+    if (pos == std::string::npos) {
+        return std::string();
+    }
+    pos += key.size() + 4;
+    return line.substr(pos, line.find('"', pos) - pos);
+}
+
+std::string
+PointKey(uint32_t nVehicles, const std::string& mode, const std::string& channel,
+         const std::string& generation)
+{
+    return std::to_string(nVehicles) + "/" + mode + "/" + channel + "/" + generation;
+}
+
+std::string
+ToJson(const ScalingPoint& point)
+{
+    std::ostringstream json;
+    json << "{\"nVehicles\":" << point.nVehicles
+         << ",\"camInterval\":\"" << point.mode << "\""
+         << ",\"channel\":\"" << point.channel << "\""
+         << ",\"generation\":\"" << point.generation << "\""
+         << ",\"wallSeconds\":" << point.wallSeconds
+         << ",\"eventsPerSecond\":" << point.eventsPerSecond
+         << ",\"peakRssBytes\":" << point.peakRssBytes
+         << ",\"setupRssPerVehicle\":" << point.setupRssPerVehicle
+         << ",\"steadyRssPerVehicle\":" << point.steadyRssPerVehicle << "}";
+    return json.str();
+}
+
+// Run the example for one point and fill in its results from the RESULT line
+bool
+RunPoint(const std::string& binary, double simTime, ScalingPoint& point)
+{
+    // The road grows with the fleet to keep the vehicle density constant
+    const std::string count = std::to_string(point.nVehicles);
+    std::vector<std::string> command {
+        binary,
+        "--nVehicles=" + count,
+        "--simTime=" + std::to_string(simTime),
+        "--roadLength=" + std::to_string(10.0 * point.nVehicles),
+        "--linkModel=" + std::string(point.channel == "fast" ? "fast" : "wifi"),
+        "--gridChannel=" + std::string(point.channel == "grid" ? "true" : "false"),
+        "--batchedGeneration=" + std::string(point.generation == "batched" ? "true" : "false"),
+        "--verbose=false",
+    };
+    command.push_back(point.mode == "dynamic" ? std::string("--etsiDynamic=true")
+                                              : "--camInterval=" + point.mode);
+
+    utils::ChildProcess child = utils::spawnProcess(command);
+    if (child.pid < 0) {
+        std::cerr << "Failed to start " << binary << std::endl;
+        return false;
+    }
+    while (utils::readAvailable(child)) {
+        usleep(10000);
+    }
+    if (utils::waitProcess(child) != 0) {
+        return false;
+    }
+
+    point.wallSeconds = ResultField(child.output, "wallSeconds");
+    point.eventsPerSecond = point.wallSeconds > 0.0 ?
+        ResultField(child.output, "events") / point.wallSeconds : 0.0;
+    point.peakRssBytes = ResultField(child.output, "peakRssBytes");
+    point.setupRssPerVehicle = ResultField(child.output, "setupRssBytes") / point.nVehicles;
+    point.steadyRssPerVehicle = ResultField(child.output, "steadyRssBytes") / point.nVehicles;
+    return true;
+}
+
+// Relative change of a metric where larger is worse
+double
+Regression(double current, double baseline)
+{
+    return baseline > 0.0 ? (current - baseline) / baseline : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::string binary = CAM_EXAMPLE_PATH;
+    std::string vehicles = "10,100,1000,10000,50000";
+    std::string modes = "1,0.1,dynamic";
+    std::string linkModel = "fast";
+    bool gridChannel = false;
+    bool batchedGeneration = false;
+    std::string output;
+    std::string baselineFile;
+    double simTime = 20.0;
+    double threshold = 0.10;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+        std::size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+        if (key == "--binary") {
+            binary = value;
+        } else if (key == "--nVehicles") {
+            vehicles = value;
+        } else if (key == "--camIntervals") {
+            modes = value;
+        } else if (key == "--linkModel") {
+            linkModel = value;
+        } else if (key == "--gridChannel") {
+            gridChannel = value.empty() || value == "true" || value == "1";
+        } else if (key == "--batchedGeneration") {
+            batchedGeneration = value.empty() || value == "true" || value == "1";
+        } else if (key == "--simTime") {
+            simTime = std::atof(value.c_str());
+        } else if (key == "--output") {
+            output = value;
+        } else if (key == "--baseline") {
+            baselineFile = value;
+        } else if (key == "--threshold") {
+            threshold = std::atof(value.c_str());
+        } else {
+            std::cerr << "Usage: scaling_bench [--nVehicles=10,100,...] [--camIntervals=1,0.1,dynamic] "
+                      << "[--simTime=s] [--linkModel=fast|wifi] [--gridChannel] [--batchedGeneration] [--binary=path] [--output=file] "
+                      << "[--baseline=file] [--threshold=fraction]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Earlier results to compare against
+    std::map<std::string, ScalingPoint> baseline;
+    if (!baselineFile.empty()) {
+        std::ifstream in(baselineFile);
+        if (!in) {
+            std::cerr << "Cannot read baseline " << baselineFile << std::endl;
+            return 1;
+        }
+        std::string line;
+        while (std::getline(in, line)) {
+            ScalingPoint point;
+            point.nVehicles = static_cast<uint32_t>(JsonField(line, "nVehicles"));
+            point.mode = JsonString(line, "camInterval");
+            point.wallSeconds = JsonField(line, "wallSeconds");
+            point.eventsPerSecond = JsonField(line, "eventsPerSecond");
+            point.peakRssBytes = JsonField(line, "peakRssBytes");
+            point.steadyRssPerVehicle = JsonField(line, "steadyRssPerVehicle");
+            point.channel = JsonString(line, "channel");
+            if (point.channel.empty()) {
+                // Results from before the channel was recorded
+                point.channel = linkModel == "wifi" ? "yans" : "fast";
+            }
+            point.generation = JsonString(line, "generation");
+            if (point.generation.empty()) {
+                point.generation = "private";
+            }
+            baseline[PointKey(point.nVehicles, point.mode, point.channel, point.generation)] = point;
+        }
+    }
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+    }
+    std::ostream& out = output.empty() ? std::cout : file;
+
+    // The grid channel replaces the Yans channel of the Wi-Fi link model
+    std::vector<std::string> channels;
+    if (gridChannel) {
+        channels = {"yans", "grid"};
+    } else {
+        channels = {linkModel == "wifi" ? "yans" : "fast"};
+    }
+    std::vector<std::string> generations;
+    if (batchedGeneration) {
+        generations = {"private", "batched"};
+    } else {
+        generations = {"private"};
+    }
+    std::vector<std::pair<std::string, std::string>> variants;
+    for (const std::string& channel : channels) {
+        for (const std::string& generation : generations) {
+            variants.emplace_back(channel, generation);
+        }
+    }
+
+    // The comparison is not between channels alone, the PHY differs as well
+    if (gridChannel) {
+        std::cerr << "Channel yans: YansWifiPhy on YansWifiChannel, channel grid: SpectrumWifiPhy on "
+                  << "GridSpectrumChannel; the speedup includes the PHY change" << std::endl;
+    }
+
+    unsigned regressions = 0;
+    for (const std::string& mode : SplitList(modes)) {
+        for (const std::string& count : SplitList(vehicles)) {
+            std::vector<ScalingPoint> results;
+            for (const auto& variant : variants) {
+                ScalingPoint point;
+                point.nVehicles = static_cast<uint32_t>(std::atoi(count.c_str()));
+                point.mode = mode;
+                point.channel = variant.first;
+                point.generation = variant.second;
+                if (!RunPoint(binary, simTime, point)) {
+                    std::cerr << "Point " << PointKey(point.nVehicles, mode, point.channel, point.generation)
+                              << " failed" << std::endl;
+                    return 1;
+                }
+                out << ToJson(point) << std::endl;
+                results.push_back(point);
+
+                // Wall time, memory and throughput must not regress
+                auto reference = baseline.find(PointKey(point.nVehicles, point.mode, point.channel,
+                                                        point.generation));
+                if (reference != baseline.end()) {
+                    const ScalingPoint& base = reference->second;
+                    const double worst = std::max({
+                        Regression(point.wallSeconds, base.wallSeconds),
+                        Regression(point.peakRssBytes, base.peakRssBytes),
+                        Regression(point.steadyRssPerVehicle, base.steadyRssPerVehicle),
+                        base.eventsPerSecond > 0.0 ?
+                            (base.eventsPerSecond - point.eventsPerSecond) / base.eventsPerSecond : 0.0 });
+                    if (worst > threshold) {
+                        std::cerr << "Regression at " << reference->first << ": " << worst * 100.0
+                                  << "% worse than baseline (threshold " << threshold * 100.0 << "%)" << std::endl;
+                        ++regressions;
+                    }
+                }
+            }
+
+            // All variants of the point side by side, speedup relative to the first
+            if (results.size() > 1) {
+                const ScalingPoint& reference = results.front();
+                std::cerr << count << " vehicles, camInterval " << mode << ":";
+                for (std::size_t i = 0; i < results.size(); ++i) {
+                    const ScalingPoint& result = results[i];
+                    std::cerr << (i == 0 ? " " : "; ") << result.channel << "/" << result.generation << " "
+                              << result.eventsPerSecond << " events/s, " << result.wallSeconds << " s ("
+                              << (result.wallSeconds > 0.0 ? reference.wallSeconds / result.wallSeconds : 0.0)
+                              << "x)";
+                }
+                std::cerr << std::endl;
+            }
+        }
+    }
+
+    return regressions == 0 ? 0 : 2;
+}
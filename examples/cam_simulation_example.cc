@@ -6,163 +6,615 @@
 #include "ns3/mobility-module.h"
 #include "ns3/wave-module.h"
 #include "ns3/applications-module.h"
+#include "ns3/propagation-module.h"
 
 #include "adapter/vanetza_ns3_adapter.hpp"
 #include "adapter/cam_application.hpp"
+#include "adapter/cam_generation_engine.hpp"
+#include "adapter/grid_spectrum_channel.hpp"
+#include "adapter/fast_link_channel.hpp"
+#include "adapter/fast_link_net_device.hpp"
+#include "adapter/vanetza_stack_factory.hpp"
+#include "adapter/fleet_metrics_collector.hpp"
+#include "adapter/cam_analytics.hpp"
+#include "adapter/its_pcap_capture.hpp"
+#include "adapter/fleet_manager.hpp"
+#include "adapter/vanet_scenario_builder.hpp"
+#include "adapter/scenario_snapshot.hpp"
+#include "adapter/dcc_controller.hpp"
+#include "mobility/fleet_mobility_store.hpp"
+#include "mobility/mobility_trace_loader.hpp"
+#include "trace/trace_writer.hpp"
+#include "utils/process_utils.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <vector>
 
 using namespace ns3;
 using namespace vanetza_ns3;
 
 NS_LOG_COMPONENT_DEFINE("CamSimulationExample");
 
-// Trace callbacks
+// Trace callbacks, they only fill a fixed-size record and queue it for
+// the background writer
 static void
-TraceMobility (Ptr<const MobilityModel> mobility)
+TraceMobility (trace::TraceWriter* writer, uint32_t stationId, Ptr<const MobilityModel> mobility)
 {
-    std::cout << "Node position: " << mobility->GetPosition() << 
-                " velocity: " << dynamic_cast<const ConstantVelocityMobilityModel*>(PeekPointer(mobility))->GetVelocity() << std::endl;
+    const Vector position = mobility->GetPosition();
+    const Vector velocity = mobility->GetVelocity();
+    trace::TraceRecord record;
+    record.timeNs = Simulator::Now().GetNanoSeconds();
+    record.event = trace::TraceEvent::CourseChange;
+    record.station = stationId;
+    record.x = static_cast<float>(position.x);
+    record.y = static_cast<float>(position.y);
+    record.speed = static_cast<float>(std::hypot(velocity.x, velocity.y));
+    record.heading = static_cast<float>(std::atan2(velocity.y, velocity.x) * 180.0 / M_PI);
+    writer->push(record);
 }
 
 // Trace callback for received packets
 static void
-TraceCamPacket (std::string context, uint32_t stationId, const Time& time)
+TraceCamPacket (trace::TraceWriter* writer, uint32_t receiverId,
+                uint32_t stationId, float posX, float posY, float speed, float heading)
 {
-    std::cout << context << " CAM received from station " << stationId << " at time " << time.GetSeconds() << "s" << std::endl;
+    trace::TraceRecord record;
+    record.timeNs = Simulator::Now().GetNanoSeconds();
+    record.event = trace::TraceEvent::CamReceived;
+    record.station = receiverId;
+    record.peer = stationId;
+    record.x = posX;
+    record.y = posY;
+    record.speed = speed;
+    record.heading = heading;
+    writer->push(record);
 }
 
-// Helper function for simulation time logging
+// Sample the memory footprint once every station has started
 static void
-LogSimTime (double timeValue)
+SampleSetupRss (uint64_t* rss, uint32_t nVehicles)
 {
-    std::cout << "Simulation time: " << timeValue << "s" << std::endl;
+    *rss = utils::currentRssBytes();
+    std::cout << "Memory after setup: " << *rss << " bytes RSS, "
+              << (nVehicles ? *rss / nVehicles : 0) << " per vehicle" << std::endl;
+}
+
+// Sample the memory footprint once the simulation runs in steady state
+static void
+SampleSteadyStateRss (uint64_t* rss)
+{
+    *rss = utils::currentRssBytes();
+}
+
+// Place a straight-road vehicle, whichever mobility model drives it
+static void
+DriveVehicle (Ptr<MobilityModel> mobility, const Vector& position, const Vector& velocity)
+{
+    mobility->SetPosition(position);
+    if (Ptr<ConstantVelocityMobilityModel> model = DynamicCast<ConstantVelocityMobilityModel>(mobility)) {
+        model->SetVelocity(velocity);
+    } else if (Ptr<FleetMobilityModel> model = DynamicCast<FleetMobilityModel>(mobility)) {
+        model->SetVelocity(velocity);
+    }
+}
+
+// Straight road: vehicles spread along it with constant velocity (10-30 m/s)
+static void
+InstallStraightRoad (NodeContainer& vehicles, uint32_t nVehicles, double roadLength)
+{
+    ObjectFactory factory("ns3::ConstantVelocityMobilityModel");
+    for (uint32_t i = 0; i < nVehicles; i++) {
+        Ptr<ConstantVelocityMobilityModel> model = factory.Create<ConstantVelocityMobilityModel>();
+        model->SetPosition(Vector(i * (roadLength / nVehicles), 0.0, 0.0));
+        model->SetVelocity(Vector(10.0 + (20.0 * i / nVehicles), 0.0, 0.0));
+        vehicles.Get(i)->AggregateObject(model);
+    }
+}
+
+// Run trace vehicles only between their first and last sample, the model
+// parks them at their end points before departure and after arrival
+static void
+RunStationsDuringTrips (const VanetScenarioBuilder& builder, Time notBefore, Time never)
+{
+    const std::vector<Ptr<VanetzaNS3Adapter>>& adapters = builder.GetAdapters();
+    const std::vector<Ptr<CamApplication>>& applications = builder.GetApplications();
+    for (std::size_t i = 0; i < adapters.size(); i++) {
+        Ptr<TraceMobilityModel> model = adapters[i]->GetNode()->GetObject<TraceMobilityModel>();
+        const Time start = std::max(model->GetFirstTime(), notBefore);
+        const Time stop = model->GetLastTime();
+        if (stop <= start) {
+            // The trip ended before the simulation starts: never start the station
+            adapters[i]->SetStartTime(never);
+            applications[i]->SetStartTime(never);
+            continue;
+        }
+        adapters[i]->SetStartTime(start);
+        adapters[i]->SetStopTime(stop);
+        applications[i]->SetStartTime(start);
+        applications[i]->SetStopTime(stop);
+    }
+}
+
+// Measured Wi-Fi and FastLink PDR per distance bin next to the configured curve
+static void
+WritePdrComparison (std::ostream& os, Ptr<CamAnalytics> wifi, Ptr<CamAnalytics> fast,
+                    Ptr<FastLinkChannel> channel)
+{
+    NS_ASSERT(wifi->GetDistanceBinWidth() == fast->GetDistanceBinWidth());
+    const double binWidth = wifi->GetDistanceBinWidth();
+    const std::size_t bins = std::max(wifi->GetDistanceBins(), fast->GetDistanceBins());
+    os << "# distance_m configured_pdr wifi_pdr fast_pdr wifi_intended fast_intended" << std::endl;
+    for (std::size_t bin = 0; bin < bins; ++bin) {
+        if (wifi->GetIntended(bin) == 0 && fast->GetIntended(bin) == 0) {
+            continue;
+        }
+        const double center = (bin + 0.5) * binWidth;
+        os << std::fixed << std::setprecision(1) << center << " "
+           << std::setprecision(4) << channel->GetPdr(center) << " "
+           << wifi->GetPdr(bin) << " " << fast->GetPdr(bin) << " "
+           << wifi->GetIntended(bin) << " " << fast->GetIntended(bin) << std::endl;
+    }
+}
+
+// Vehicle churn: a station leaves the road and a new one enters at its start
+static void
+ReplaceVehicle (Ptr<FleetManager> fleet, uint32_t stationId, uint32_t* nextStationId,
+                double lifetime, double speed)
+{
+    // Stop before parking, a moving parked node would drift back into range
+    Ptr<MobilityModel> mobility = fleet->GetNode(stationId)->GetObject<MobilityModel>();
+    DriveVehicle(mobility, mobility->GetPosition(), Vector());
+    fleet->Deactivate(stationId);
+    
+    const uint32_t entering = (*nextStationId)++;
+    Ptr<Node> node = fleet->Activate(entering);
+    DriveVehicle(node->GetObject<MobilityModel>(), Vector(0.0, 0.0, 0.0), Vector(speed, 0.0, 0.0));
+    Simulator::Schedule(Seconds(lifetime), &ReplaceVehicle, fleet, entering, nextStationId, lifetime, speed);
+}
+
+// Capture the warmed-up stations, to resume later runs from here
+static void
+SaveSnapshot (const std::string& path, const VanetScenarioBuilder* builder)
+{
+    auto start = std::chrono::steady_clock::now();
+    if (!ScenarioSnapshot::Save(path, builder->GetAdapters(), builder->GetApplications())) {
+        std::cerr << "Cannot write snapshot " << path << std::endl;
+        return;
+    }
+    std::cout << "Snapshot of " << builder->GetAdapters().size() << " stations at "
+              << Simulator::Now().GetSeconds() << " s written to " << path << " in "
+              << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()
+              << " s" << std::endl;
+}
+
+// Simulation progress marker
+static void
+LogSimTime (trace::TraceWriter* writer)
+{
+    trace::TraceRecord record;
+    record.timeNs = Simulator::Now().GetNanoSeconds();
+    record.event = trace::TraceEvent::SimTime;
+    writer->push(record);
 }
 
 int main(int argc, char *argv[])
 {
-    // Enable logging
-    LogComponentEnable("CamSimulationExample", LOG_LEVEL_ALL);
-    LogComponentEnable("VanetzaNS3Adapter", LOG_LEVEL_INFO);
-    LogComponentEnable("CamApplication", LOG_LEVEL_INFO);
+    const auto programStart = std::chrono::steady_clock::now();
     
     // Simulation parameters
     uint32_t nVehicles = 10;
     double simTime = 100.0; // seconds
     double roadLength = 1000.0; // meters
+    bool batchedGeneration = false;
+    bool etsiDynamic = false;
+    bool gridChannel = false;
+    double maxRange = 1000.0; // meters
+    std::string linkModel = "wifi";
+    std::string pdrReport;
+    bool sharedStacks = true;
+    double camInterval = 0.2; // seconds
+    bool verbose = true;
+    std::string metricsFile;
+    bool analytics = true;
+    std::string analyticsFile;
+    std::string traceFile;
+    std::string pcapMode = "its";
+    std::string pcapStations;
+    std::string mobilityTrace;
+    bool fleetMobility = false;
+    double vehicleLifetime = 0.0; // seconds, 0: vehicles stay for the whole run
+    double snapshotAt = 0.0; // seconds, 0: no snapshot
+    std::string snapshotFile = "cam-simulation.snap";
+    std::string restoreFile;
+    std::string dccMode = "none";
+    std::string dccFile;
     
     // Allow command line arguments
     CommandLine cmd;
     cmd.AddValue("nVehicles", "Number of vehicles", nVehicles);
     cmd.AddValue("simTime", "Simulation time in seconds", simTime);
     cmd.AddValue("roadLength", "Length of the road in meters", roadLength);
+    cmd.AddValue("etsiDynamic", "Use ETSI EN 302 637-2 dynamic CAM triggering", etsiDynamic);
+    cmd.AddValue("gridChannel", "Use the range-culling GridSpectrumChannel instead of the Yans channel", gridChannel);
+    cmd.AddValue("maxRange", "Maximum interference range of the grid channel in meters", maxRange);
+    cmd.AddValue("linkModel", "Link layer model: wifi (full 802.11 PHY/MAC) or fast (PDR-curve FastLinkChannel)", linkModel);
+    cmd.AddValue("pdrReport", "Also run the vehicles on the other link model and write measured Wi-Fi and FastLink PDR and the configured curve per distance bin to this file", pdrReport);
+    cmd.AddValue("sharedStacks", "Create all Vanetza stacks from one factory with shared configuration and arena", sharedStacks);
+    cmd.AddValue("camInterval", "CAM generation interval of the CAM applications in seconds", camInterval);
+    cmd.AddValue("metricsFile", "Write the per-station metrics table of the last snapshot to this CSV file", metricsFile);
+    cmd.AddValue("analytics", "Measure CAM latency, PDR per distance and inter-reception time", analytics);
+    cmd.AddValue("analyticsFile", "Write the CAM analytics to this file at the end instead of standard output", analyticsFile);
+    cmd.AddValue("traceFile", "Write CAM receptions, course changes and progress markers to this binary trace", traceFile);
+    cmd.AddValue("pcap", "Packet capture: its (one merged file of ITS frames), full (one file per Wi-Fi device) or none", pcapMode);
+    cmd.AddValue("pcapStations", "With pcap=its, only capture these stations (e.g. \"1-10,42\")", pcapStations);
+    cmd.AddValue("mobilityTrace", "Replay the first nVehicles vehicles of this binary mobility trace (see fcd_to_mobility_trace)", mobilityTrace);
+    cmd.AddValue("fleetMobility", "Keep the straight-road vehicles in one FleetMobilityStore (SoA arrays, batched updates)", fleetMobility);
+    cmd.AddValue("vehicleLifetime", "Replace every vehicle by a new station entering the road after this many seconds, using a pool of nVehicles stations (0: off)", vehicleLifetime);
+    cmd.AddValue("snapshotAt", "Write the state of all stations to snapshotFile at this time in seconds (0: off)", snapshotAt);
+    cmd.AddValue("snapshotFile", "File written by snapshotAt", snapshotFile);
+    cmd.AddValue("restoreFile", "Resume the stations from this snapshot instead of warming up (same nVehicles and options)", restoreFile);
+    cmd.AddValue("dcc", "Congestion control driven by the measured channel busy ratio: none, reactive or adaptive (LIMERIC)", dccMode);
+    cmd.AddValue("dccFile", "With dcc, write the per-station DCC state and counters to this CSV file", dccFile);
+    cmd.AddValue("verbose", "Enable logging", verbose);
+    cmd.AddValue("batchedGeneration", "Drive all CAM timers from one shared generation engine", batchedGeneration);
     cmd.Parse(argc, argv);
     
-    // Create nodes for vehicles
+    if (linkModel != "wifi" && linkModel != "fast") {
+        std::cerr << "Unknown link model '" << linkModel << "', expected wifi or fast" << std::endl;
+        return 1;
+    }
+    const bool fastLink = (linkModel == "fast");
+    if (dccMode != "none" && dccMode != "reactive" && dccMode != "adaptive") {
+        std::cerr << "Unknown DCC mode '" << dccMode << "', expected none, reactive or adaptive" << std::endl;
+        return 1;
+    }
+    if (vehicleLifetime > 0.0 && !mobilityTrace.empty()) {
+        std::cerr << "vehicleLifetime applies to the straight road, not to mobilityTrace" << std::endl;
+        return 1;
+    }
+    if (vehicleLifetime > 0.0 && (snapshotAt > 0.0 || !restoreFile.empty())) {
+        std::cerr << "Snapshots do not cover the station pool of vehicleLifetime" << std::endl;
+        return 1;
+    }
+    if (!pdrReport.empty() && (!analytics || vehicleLifetime > 0.0 || !restoreFile.empty())) {
+        std::cerr << "pdrReport needs analytics and vehicles that stay for the whole run, without restoreFile" << std::endl;
+        return 1;
+    }
+    
+    // Enable logging
+    if (verbose) {
+        LogComponentEnable("CamSimulationExample", LOG_LEVEL_ALL);
+        LogComponentEnable("VanetzaNS3Adapter", LOG_LEVEL_INFO);
+        LogComponentEnable("CamApplication", LOG_LEVEL_INFO);
+        LogComponentEnable("ScenarioSnapshot", LOG_LEVEL_INFO);
+    }
+    
+    // Per-event traces go to a background writer instead of the console
+    std::unique_ptr<trace::TraceWriter> traceWriter;
+    if (!traceFile.empty()) {
+        traceWriter.reset(new trace::TraceWriter(traceFile));
+        if (!traceWriter->isOpen()) {
+            std::cerr << "Cannot write trace " << traceFile << std::endl;
+            return 1;
+        }
+    }
+    
+    // Map the mobility trace before the fleet size is fixed
+    Ptr<MobilityTraceLoader> traceLoader = nullptr;
+    if (!mobilityTrace.empty()) {
+        traceLoader = CreateObject<MobilityTraceLoader>();
+        traceLoader->SetAttribute("TraceFile", StringValue(mobilityTrace));
+        if (!traceLoader->Open()) {
+            std::cerr << "Cannot load mobility trace " << mobilityTrace << std::endl;
+            return 1;
+        }
+        if (nVehicles > traceLoader->GetNVehicles()) {
+            std::cout << "Mobility trace has only " << traceLoader->GetNVehicles() << " vehicles" << std::endl;
+            nVehicles = traceLoader->GetNVehicles();
+        }
+    }
+    
+    // Optionally share one generation engine between all stations
+    Ptr<CamGenerationEngine> engine = nullptr;
+    if (batchedGeneration) {
+        engine = CreateObject<CamGenerationEngine>();
+    }
+    
+    // Share the Vanetza configuration and pool the per-station stacks
+    Ptr<VanetzaStackFactory> stackFactory = nullptr;
+    if (sharedStacks) {
+        stackFactory = CreateObject<VanetzaStackFactory>();
+    }
+    
+    // Latency, PDR-vs-distance and inter-reception histograms, written at Simulator::Destroy
+    Ptr<CamAnalytics> camAnalytics = nullptr;
+    if (analytics) {
+        camAnalytics = CreateObject<CamAnalytics>();
+        camAnalytics->SetAttribute("OutputFile", StringValue(analyticsFile));
+    }
+    
+    // Merged capture of the ITS frames of all stations
+    Ptr<ItsPcapCapture> pcapCapture = nullptr;
+    if (pcapMode == "its") {
+        pcapCapture = CreateObject<ItsPcapCapture>();
+        pcapCapture->SetAttribute("Stations", StringValue(pcapStations));
+    }
+    
+    // Snapshot the per-station counters into one fleet-wide table
+    Ptr<FleetMetricsCollector> metrics = CreateObject<FleetMetricsCollector>();
+    
+    // With churn, the stations are slots of a pool that vehicles enter and leave
+    Ptr<FleetManager> fleet = nullptr;
+    if (vehicleLifetime > 0.0) {
+        fleet = CreateObject<FleetManager>();
+    }
+    
+    // Channel load measurement gating the CAMs of every station
+    Ptr<DccController> dcc = nullptr;
+    if (dccMode != "none") {
+        dcc = CreateObject<DccController>();
+        dcc->SetAttribute("Mode", EnumValue(dccMode == "adaptive" ? DccController::ADAPTIVE
+                                                                 : DccController::REACTIVE));
+    }
+    
+    // Create nodes, devices, adapters and CAM applications in bulk
     std::cout << "Creating " << nVehicles << " vehicles" << std::endl;
-    NodeContainer vehicles;
-    vehicles.Create(nVehicles);
+    VanetScenarioBuilder builder;
+    builder.SetLinkModel(fastLink ? VanetScenarioBuilder::FAST_LINK
+                                  : gridChannel ? VanetScenarioBuilder::WIFI_GRID : VanetScenarioBuilder::WIFI);
+    builder.SetMaxRange(maxRange);
+    builder.SetApplicationAttribute("CamGenerationInterval", DoubleValue(camInterval));
+    if (etsiDynamic) {
+        builder.SetApplicationAttribute("GenerationMode", EnumValue(CamApplication::ETSI_DYNAMIC));
+    }
+    builder.SetGenerationEngine(engine);
+    builder.SetStackFactory(stackFactory);
+    builder.SetAnalytics(camAnalytics);
+    builder.SetPcapCapture(pcapCapture);
+    builder.SetMetricsCollector(metrics);
+    builder.SetFleetManager(fleet);
+    builder.SetDccController(dcc);
     
-    // Set up mobility model (straight line road)
-    MobilityHelper mobility;
+    Ptr<FleetMobilityStore> fleetStore = nullptr;
+    builder.SetMobilityInstaller([&](NodeContainer& vehicles) {
+        if (traceLoader) {
+            // Replay the trace, vehicle i of the trace drives node i
+            traceLoader->Install(vehicles);
+        } else if (fleetMobility) {
+            // Same straight road, with positions and velocities in the store's arrays
+            fleetStore = CreateObject<FleetMobilityStore>();
+            for (uint32_t i = 0; i < nVehicles; i++) {
+                double speed = 10.0 + (20.0 * i / nVehicles); // 10-30 m/s (36-108 km/h)
+                fleetStore->Install(vehicles.Get(i), Vector(i * (roadLength / nVehicles), 0.0, 0.0),
+                                    Vector(speed, 0.0, 0.0));
+            }
+        } else {
+            InstallStraightRoad(vehicles, nVehicles, roadLength);
+        }
+    });
     
-    // Configure positions along a straight road
-    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
-    for (uint32_t i = 0; i < nVehicles; i++) {
-        // Distribute vehicles along the road
-        positionAlloc->Add(Vector(i * (roadLength / nVehicles), 0.0, 0.0));
+    // Per-station trace sinks, bound to the station number without context strings
+    if (traceWriter) {
+        builder.SetStationHook([&](uint32_t i, Ptr<Node> node, Ptr<VanetzaNS3Adapter>, Ptr<CamApplication> camApp) {
+            node->GetObject<MobilityModel>()->TraceConnectWithoutContext(
+                "CourseChange", MakeBoundCallback(&TraceMobility, traceWriter.get(), i + 1));
+            camApp->TraceConnectWithoutContext(
+                "CamReceived", MakeBoundCallback(&TraceCamPacket, traceWriter.get(), i + 1));
+        });
     }
-    mobility.SetPositionAllocator(positionAlloc);
     
-    // Set mobility model with constant velocity
-    mobility.SetMobilityModel("ns3::ConstantVelocityMobilityModel");
-    mobility.Install(vehicles);
+    builder.Build(nVehicles);
+    builder.WriteSetupReport(std::cout);
+    const std::vector<Ptr<VanetzaNS3Adapter>>& adapters = builder.GetAdapters();
+    Ptr<FastLinkChannel> fastChannel = builder.GetFastLinkChannel();
     
-    // Set vehicle speeds (between 10-30 m/s)
-    for (uint32_t i = 0; i < nVehicles; i++) {
-        Ptr<ConstantVelocityMobilityModel> model = vehicles.Get(i)->GetObject<ConstantVelocityMobilityModel>();
-        // Vary speeds to create realistic scenario
-        double speed = 10.0 + (20.0 * i / nVehicles); // 10-30 m/s (36-108 km/h)
-        model->SetVelocity(Vector(speed, 0.0, 0.0));
-        
-        // Connect mobility trace
-        Ptr<MobilityModel> mobility = vehicles.Get(i)->GetObject<MobilityModel>();
-        mobility->TraceConnectWithoutContext("CourseChange", MakeCallback(&TraceMobility));
-    }
-    
-    // Create and configure Wi-Fi devices instead of WAVE
-    YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default();
-    YansWifiPhyHelper wifiPhy;  
-    wifiPhy.SetChannel(wifiChannel.Create());
-    
-    // Enable PCAP tracing on all WiFi devices
-    wifiPhy.SetPcapDataLinkType(WifiPhyHelper::DLT_IEEE802_11);
-    
-    // Use regular Wi-Fi MAC instead of WAVE
-    WifiMacHelper wifiMac;
-    wifiMac.SetType("ns3::AdhocWifiMac");
-    
-    WifiHelper wifi;
-    wifi.SetStandard(WIFI_STANDARD_80211a); // Similar to 802.11p used in WAVE
-    
-    // Install devices
-    NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, vehicles);
-    
-    // Set MAC addresses explicitly
-    for (uint32_t i = 0; i < devices.GetN(); i++) {
-        Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(devices.Get(i));
-        if (device) {
-            std::stringstream ss;
-            ss << "00:00:00:00:00:" << std::hex << (i + 1);
-            Mac48Address addr = Mac48Address(ss.str().c_str());
-            
-            device->SetAddress(addr);
-            
-            std::cout << "Configured WifiNetDevice " << i << " with MAC address " 
-                << device->GetAddress() << std::endl;
+    // Validation twin for pdrReport: the same vehicles and traffic on the other
+    // link model, on a channel of their own, measured by separate analytics
+    VanetScenarioBuilder twin;
+    Ptr<CamAnalytics> twinAnalytics = nullptr;
+    if (!pdrReport.empty()) {
+        std::cout << "Creating " << nVehicles << " validation vehicles on the "
+                  << (fastLink ? "wifi" : "fast") << " link model" << std::endl;
+        twinAnalytics = CreateObject<CamAnalytics>();
+        twinAnalytics->SetAttribute("OutputFile", StringValue(pdrReport + (fastLink ? ".wifi" : ".fast")));
+        twin.SetLinkModel(fastLink ? (gridChannel ? VanetScenarioBuilder::WIFI_GRID : VanetScenarioBuilder::WIFI)
+                                   : VanetScenarioBuilder::FAST_LINK);
+        twin.SetMaxRange(maxRange);
+        twin.SetFirstStationId(nVehicles + 1);
+        twin.SetApplicationAttribute("CamGenerationInterval", DoubleValue(camInterval));
+        if (etsiDynamic) {
+            twin.SetApplicationAttribute("GenerationMode", EnumValue(CamApplication::ETSI_DYNAMIC));
+        }
+        twin.SetGenerationEngine(engine);
+        twin.SetStackFactory(stackFactory);
+        twin.SetAnalytics(twinAnalytics);
+        if (dcc) {
+            Ptr<DccController> twinDcc = CreateObject<DccController>();
+            twinDcc->SetAttribute("Mode", EnumValue(dccMode == "adaptive" ? DccController::ADAPTIVE
+                                                                         : DccController::REACTIVE));
+            twin.SetDccController(twinDcc);
+        }
+        twin.SetMobilityInstaller([&](NodeContainer& vehicles) {
+            if (traceLoader) {
+                traceLoader->Install(vehicles);
+            } else {
+                InstallStraightRoad(vehicles, nVehicles, roadLength);
+            }
+        });
+        twin.Build(nVehicles);
+        if (!fastChannel) {
+            fastChannel = twin.GetFastLinkChannel();
         }
     }
     
-    // Install Vanetza-NS3 adapter and CAM application on each vehicle
-    for (uint32_t i = 0; i < nVehicles; i++) {
-        // Create and configure the Vanetza-NS3 adapter
-        Ptr<VanetzaNS3Adapter> adapter = CreateObject<VanetzaNS3Adapter>();
-        adapter->SetDevice(devices.Get(i));  // Use Wi-Fi devices
-        adapter->SetStationId(i + 1); // Station IDs start from 1
-        
-        // Create and configure the CAM application
-        Ptr<CamApplication> camApp = CreateObject<CamApplication>();
-        camApp->SetAdapter(adapter);
-        camApp->SetAttribute("StationId", UintegerValue(i + 1));
-        camApp->SetAttribute("CamGenerationInterval", DoubleValue(0.2)); // 200ms interval for more traffic
-        
-        // Connect trace source for received CAMs
-        std::ostringstream context;
-        context << "Vehicle[" << i << "] ";
-        camApp->TraceConnect("CamReceived", context.str(), MakeCallback(&TraceCamPacket));
-        
-        // Install applications on the vehicle
-        vehicles.Get(i)->AddApplication(adapter);
-        vehicles.Get(i)->AddApplication(camApp);
-        
-        std::cout << "Installed Vanetza adapter and CAM application on vehicle " << i << std::endl;
-    }
-    
-    // Schedule logging during simulation
-    for (double t = 1.0; t < simTime; t += 1.0) {
-        // Use a helper function
-        Simulator::Schedule(Seconds(t), &LogSimTime, t);
+    // Start the initial population, one vehicle leaves every vehicleLifetime / nVehicles
+    uint32_t nextStationId = nVehicles + 1;
+    if (fleet) {
+        for (uint32_t i = 0; i < nVehicles; i++) {
+            double speed = 10.0 + (20.0 * i / nVehicles); // 10-30 m/s (36-108 km/h)
+            Ptr<Node> node = fleet->Activate(i + 1);
+            DriveVehicle(node->GetObject<MobilityModel>(), Vector(i * (roadLength / nVehicles), 0.0, 0.0),
+                         Vector(speed, 0.0, 0.0));
+            Simulator::Schedule(Seconds(vehicleLifetime * (i + 1) / nVehicles), &ReplaceVehicle,
+                                fleet, i + 1, &nextStationId, vehicleLifetime, speed);
+        }
+    }
+    
+    // Resume from a snapshot: the stations start at its time with their saved state
+    Time resumeTime = Seconds(0);
+    if (!restoreFile.empty()) {
+        if (!ScenarioSnapshot::Restore(restoreFile, adapters, builder.GetApplications(), &resumeTime)) {
+            std::cerr << "Cannot restore snapshot " << restoreFile << std::endl;
+            return 1;
+        }
+        std::cout << "Resuming " << nVehicles << " stations at " << resumeTime.GetSeconds()
+                  << " s from " << restoreFile << std::endl;
     }
     
+    // Trace vehicles only take part while they are on the road
+    if (traceLoader) {
+        RunStationsDuringTrips(builder, resumeTime, Seconds(simTime + 1.0));
+        RunStationsDuringTrips(twin, resumeTime, Seconds(simTime + 1.0));
+    }
+    if (snapshotAt > 0.0) {
+        Simulator::Schedule(Seconds(snapshotAt), &SaveSnapshot, snapshotFile, &builder);
+    }
+    
+    // Progress markers in the trace, one per simulated second
+    if (traceWriter) {
+        for (double t = 1.0; t < simTime; t += 1.0) {
+            Simulator::Schedule(Seconds(t), &LogSimTime, traceWriter.get());
+        }
+    }
+    
+    // Memory footprint after setup and late in the run. The stacks are created
+    // in StartApplication, so the setup sample follows the start events
+    uint64_t setupRss = 0;
+    uint64_t steadyRss = 0;
+    Simulator::Schedule(resumeTime + NanoSeconds(1), &SampleSetupRss, &setupRss, nVehicles);
+    Simulator::Schedule(Seconds(simTime * 0.9), &SampleSteadyStateRss, &steadyRss);
+    
     // Run simulation
     std::cout << "Running simulation for " << simTime << " seconds" << std::endl;
     
-    // Enable PCAP tracing for all devices
-    wifiPhy.EnablePcap("cam-simulation", devices);
+    // Per-device capture of every Wi-Fi frame
+    if (pcapMode == "full") {
+        builder.EnableWifiPcap("cam-simulation");
+    }
     
     Simulator::Stop(Seconds(simTime));
+    auto wallStart = std::chrono::steady_clock::now();
+    const double startupSeconds = std::chrono::duration<double>(wallStart - programStart).count();
+    std::cout << "Startup: " << startupSeconds << " s to the first event" << std::endl;
     Simulator::Run();
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    
+    if (pcapCapture) {
+        pcapCapture->Flush();
+        std::cout << "ITS capture: " << pcapCapture->GetFrames() << " frames, "
+                  << pcapCapture->GetBytesWritten() << " bytes in "
+                  << pcapCapture->GetFiles() << " file(s)" << std::endl;
+    }
+    if (traceWriter) {
+        traceWriter->close();
+        std::cout << "Trace: " << traceWriter->written() << " records written to " << traceFile
+                  << ", " << traceWriter->dropped() << " dropped" << std::endl;
+    }
+    
+    // Report the cost of the receive path
+    ReceivePathStats rx;
+    for (const Ptr<VanetzaNS3Adapter>& adapter : adapters) {
+        const ReceivePathStats& stats = adapter->GetReceivePathStats();
+        rx.packets += stats.packets;
+        rx.nanoseconds += stats.nanoseconds;
+        rx.arenaAllocations += stats.arenaAllocations;
+        rx.arenaBytes += stats.arenaBytes;
+    }
+    if (rx.packets > 0) {
+        std::cout << "Receive path: "
+                  << rx.packets << " packets, "
+                  << rx.nanoseconds / rx.packets << " ns/packet, "
+                  << rx.arenaAllocations << " event arena allocations ("
+                  << rx.arenaBytes << " bytes)" << std::endl;
+    }
+    
+    // Fleet-wide counters at the end of the run
+    metrics->Snapshot();
+    const StationMetrics& totals = metrics->GetTotals();
+    std::cout << "Station metrics: "
+              << totals.camsGenerated << " CAMs generated, "
+              << totals.camsSent << " sent, "
+              << totals.sendFailures << " send failures, "
+              << totals.camsReceived << " received, "
+              << totals.camsRejected << " rejected, "
+              << totals.forwardedToVanetza << " forwarded to Vanetza" << std::endl;
+    if (!metricsFile.empty()) {
+        std::ofstream table(metricsFile);
+        metrics->WriteTable(table);
+    }
+    
+    // Channel load and what congestion control held back
+    DccCounters dccTotals;
+    if (dcc) {
+        dccTotals = dcc->GetTotals();
+        std::cout << "DCC (" << dccMode << "): mean CBR "
+                  << (dccTotals.samples ? dccTotals.cbrSum / dccTotals.samples : 0.0) << ", "
+                  << dccTotals.allowed << " transmissions allowed, "
+                  << dccTotals.gated << " held back, "
+                  << dccTotals.transitions << " state changes" << std::endl;
+        if (!dccFile.empty()) {
+            std::ofstream table(dccFile);
+            dcc->WriteTable(table);
+        }
+    }
+    
+    // One machine-readable summary line, collected by cam_sweep_runner
+    std::cout << "RESULT nVehicles=" << nVehicles
+              << " simTime=" << simTime
+              << " wallSeconds=" << wallSeconds
+              << " setupSeconds=" << builder.GetSetupSeconds()
+              << " startupSeconds=" << startupSeconds
+              << " events=" << Simulator::GetEventCount()
+              << " rxPackets=" << rx.packets
+              << " camsSent=" << totals.camsSent
+              << " sendFailures=" << totals.sendFailures
+              << " dccGated=" << dccTotals.gated
+              << " rxNsPerPacket=" << (rx.packets ? rx.nanoseconds / rx.packets : 0)
+              << " bytesPerStack=" << (stackFactory ? stackFactory->GetBytesPerStack() : 0.0)
+              << " setupRssBytes=" << setupRss
+              << " steadyRssBytes=" << steadyRss
+              << " peakRssBytes=" << utils::peakRssBytes()
+              << std::endl;
+    
+    if (stackFactory) {
+        stackFactory->WriteMemoryReport(std::cout);
+    }
+    if (fleet) {
+        std::cout << "Station pool: " << fleet->GetNSlots() << " slots, "
+                  << fleet->GetActivations() << " activations, peak "
+                  << fleet->GetPeakActive() << " active, "
+                  << fleet->GetRejected() << " rejected" << std::endl;
+    }
+    if (fleetStore) {
+        std::cout << "Fleet mobility: " << fleetStore->GetBatchUpdates() << " batch updates, "
+                  << fleetStore->GetArrayHits() << " queries answered from the arrays" << std::endl;
+    }
+    
+    // Compare the delivery ratio measured on both link models with the configured curve
+    if (!pdrReport.empty()) {
+        std::ofstream report(pdrReport);
+        WritePdrComparison(report, fastLink ? twinAnalytics : camAnalytics,
+                           fastLink ? camAnalytics : twinAnalytics, fastChannel);
+        std::cout << "PDR report written to " << pdrReport << std::endl;
+    }
+    
     Simulator::Destroy();
     
     std::cout << "Simulation completed successfully" << std::endl;
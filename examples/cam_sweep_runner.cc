@@ -0,0 +1,341 @@
+// Parallel parameter sweep over cam_simulation_example
+//
+// Usage:
+//   cam_sweep_runner --sweep=<file> [--output=<file>] [--jobs=<n>] [--binary=<path>] [--dryRun]
+//
+// The sweep file lists one example argument per line with its values; the
+// runner executes the cartesian product of all values, one worker process
+// per point, on up to --jobs cores:
+//
+//   # capacity study
+//   nVehicles = 100, 1000, 10000
+//   simTime = 30
+//   linkModel = fast
+//   seeds = 1..8
+//
+// "seeds" is expanded into ns-3's --RngRun. Every point is identified by a
+// hash of its arguments; results are appended to the output file as JSON
+// lines as soon as a worker finishes, and points whose hash is already in
+// the output file are skipped, so an interrupted sweep resumes where it
+// stopped.
+
+#include "utils/process_utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <poll.h>
+
+using namespace vanetza_ns3;
+
+namespace {
+
+typedef std::vector<std::pair<std::string, std::string> > Arguments;
+
+struct SweepPoint {
+    Arguments arguments;  ///< Example arguments, sorted by name
+    std::string hash;     ///< Hash identifying the point
+};
+
+struct RunningPoint {
+    utils::ChildProcess process;
+    SweepPoint point;
+    std::chrono::steady_clock::time_point start;
+};
+
+std::string
+Trim(const std::string& text)
+{
+    const std::size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return std::string();
+    }
+    const std::size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+// Split "a, b, c" into values; "1..8" expands to an integer range
+std::vector<std::string>
+ParseValues(const std::string& text)
+{
+    std::vector<std::string> values;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        item = Trim(item);
+        std::size_t dots = item.find("..");
+        if (dots != std::string::npos) {
+            long first = std::strtol(item.substr(0, dots).c_str(), nullptr, 10);
+            long last = std::strtol(item.substr(dots + 2).c_str(), nullptr, 10);
+            for (long v = first; v <= last; ++v) {
+                values.push_back(std::to_string(v));
+            }
+        } else if (!item.empty()) {
+            values.push_back(item);
+        }
+    }
+    return values;
+}
+
+bool
+ReadSweep(const std::string& path, std::map<std::string, std::vector<std::string> >& axes)
+{
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        line = Trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+        std::size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            std::cerr << "Ignoring malformed sweep line: " << line << std::endl;
+            continue;
+        }
+        std::string key = Trim(line.substr(0, eq));
+        if (key == "seeds") {
+            key = "RngRun";
+        }
+        axes[key] = ParseValues(line.substr(eq + 1));
+    }
+    return true;
+}
+
+std::string
+HashArguments(const Arguments& arguments)
+{
+    std::string canonical;
+    for (const auto& argument : arguments) {
+        canonical += argument.first + "=" + argument.second + ";";
+    }
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx",
+                  static_cast<unsigned long long>(utils::fnv1a64(canonical)));
+    return hex;
+}
+
+// Cartesian product of all axes
+std::vector<SweepPoint>
+ExpandSweep(const std::map<std::string, std::vector<std::string> >& axes)
+{
+    std::vector<SweepPoint> points(1);
+    for (const auto& axis : axes) {
+        std::vector<SweepPoint> expanded;
+        for (const SweepPoint& point : points) {
+            for (const std::string& value : axis.second) {
+                SweepPoint next = point;
+                next.arguments.emplace_back(axis.first, value);
+                expanded.push_back(next);
+            }
+        }
+        points.swap(expanded);
+    }
+    for (SweepPoint& point : points) {
+        point.hash = HashArguments(point.arguments);
+    }
+    return points;
+}
+
+std::set<std::string>
+ReadCompletedHashes(const std::string& path)
+{
+    std::set<std::string> hashes;
+    std::ifstream in(path);
+    std::string line;
+    const std::string key = "\"hash\":\"";
+    while (std::getline(in, line)) {
+        std::size_t pos = line.find(key);
+        if (pos != std::string::npos && line.find("\"exit\":0") != std::string::npos) {
+            hashes.insert(line.substr(pos + key.size(), 16));
+        }
+    }
+    return hashes;
+}
+
+std::string
+JsonValue(const std::string& text)
+{
+    char* end = nullptr;
+    std::strtod(text.c_str(), &end);
+    if (!text.empty() && end && *end == '\0') {
+        return text;
+    }
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// Turn the example's "RESULT key=value ..." line into a JSON object
+std::string
+ParseResult(const std::string& output)
+{
+    std::size_t pos = output.rfind("RESULT ");
+    if (pos == std::string::npos) {
+        return "{}";
+    }
+    std::istringstream in(output.substr(pos + 7, output.find('\n', pos) - pos - 7));
+    std::string field;
+    std::string json = "{";
+    while (in >> field) {
+        std::size_t eq = field.find('=');
+        if (eq == std::string::npos) {
+            continue;
+        }
+        json += (json.size() > 1 ? "," : "");
+        json += "\"" + field.substr(0, eq) + "\":" + JsonValue(field.substr(eq + 1));
+    }
+    return json + "}";
+}
+
+std::string
+DefaultBinary(const char* self)
+{
+    std::string path(self);
+    std::size_t slash = path.rfind('/');
+    return (slash == std::string::npos ? std::string(".") : path.substr(0, slash)) + "/cam_simulation_example";
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::string sweepFile;
+    std::string outputFile = "sweep_results.jsonl";
+    std::string binary = DefaultBinary(argv[0]);
+    unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    bool dryRun = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+        std::string value = arg.substr(arg.find('=') + 1);
+        if (arg.compare(0, 8, "--sweep=") == 0) {
+            sweepFile = value;
+        } else if (arg.compare(0, 9, "--output=") == 0) {
+            outputFile = value;
+        } else if (arg.compare(0, 7, "--jobs=") == 0) {
+            jobs = std::max(1, std::atoi(value.c_str()));
+        } else if (arg.compare(0, 9, "--binary=") == 0) {
+            binary = value;
+        } else if (arg == "--dryRun") {
+            dryRun = true;
+        } else {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::map<std::string, std::vector<std::string> > axes;
+    if (sweepFile.empty() || !ReadSweep(sweepFile, axes)) {
+        std::cerr << "Usage: cam_sweep_runner --sweep=<file> [--output=<file>] [--jobs=<n>] "
+                  << "[--binary=<path>] [--dryRun]" << std::endl;
+        return 1;
+    }
+
+    // Skip points that already have results on disk
+    std::vector<SweepPoint> points = ExpandSweep(axes);
+    const std::set<std::string> completed = ReadCompletedHashes(outputFile);
+    std::vector<SweepPoint> pending;
+    for (const SweepPoint& point : points) {
+        if (!completed.count(point.hash)) {
+            pending.push_back(point);
+        }
+    }
+    std::cout << points.size() << " sweep points, " << points.size() - pending.size()
+              << " already done, " << pending.size() << " to run on " << jobs << " workers" << std::endl;
+    if (dryRun) {
+        for (const SweepPoint& point : pending) {
+            std::cout << point.hash;
+            for (const auto& argument : point.arguments) {
+                std::cout << " --" << argument.first << "=" << argument.second;
+            }
+            std::cout << std::endl;
+        }
+        return 0;
+    }
+
+    std::ofstream output(outputFile, std::ios::app);
+    if (!output) {
+        std::cerr << "Cannot open " << outputFile << std::endl;
+        return 1;
+    }
+
+    std::reverse(pending.begin(), pending.end());
+    std::vector<RunningPoint> running;
+    std::size_t finished = 0;
+    std::size_t failed = 0;
+    const std::size_t total = pending.size();
+
+    while (!pending.empty() || !running.empty()) {
+        // Keep every worker slot busy
+        while (!pending.empty() && running.size() < jobs) {
+            RunningPoint worker;
+            worker.point = pending.back();
+            pending.pop_back();
+            std::vector<std::string> command { binary };
+            for (const auto& argument : worker.point.arguments) {
+                command.push_back("--" + argument.first + "=" + argument.second);
+            }
+            worker.process = utils::spawnProcess(command);
+            worker.start = std::chrono::steady_clock::now();
+            if (worker.process.pid < 0) {
+                std::cerr << "Failed to start " << binary << std::endl;
+                return 1;
+            }
+            running.push_back(std::move(worker));
+        }
+
+        std::vector<pollfd> fds(running.size());
+        for (std::size_t i = 0; i < running.size(); ++i) {
+            fds[i].fd = running[i].process.stdoutFd;
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+        }
+        poll(fds.data(), fds.size(), 1000);
+
+        // Collect output and merge the results of finished workers
+        for (std::size_t i = running.size(); i-- > 0;) {
+            if (fds[i].revents == 0 || utils::readAvailable(running[i].process)) {
+                continue;
+            }
+            RunningPoint& worker = running[i];
+            const int status = utils::waitProcess(worker.process);
+            const double seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - worker.start).count();
+
+            output << "{\"hash\":\"" << worker.point.hash << "\",\"exit\":" << status << ",\"params\":{";
+            for (std::size_t a = 0; a < worker.point.arguments.size(); ++a) {
+                const auto& argument = worker.point.arguments[a];
+                output << (a ? "," : "") << "\"" << argument.first << "\":" << JsonValue(argument.second);
+            }
+            output << "},\"wallSeconds\":" << seconds
+                   << ",\"results\":" << ParseResult(worker.process.output) << "}" << std::endl;
+
+            ++finished;
+            failed += (status != 0);
+            std::cout << "[" << finished << "/" << total << "] " << worker.point.hash
+                      << (status == 0 ? " done" : " FAILED") << " in " << seconds << " s" << std::endl;
+            running.erase(running.begin() + i);
+        }
+    }
+
+    std::cout << "Sweep finished: " << finished - failed << " succeeded, " << failed << " failed" << std::endl;
+    return failed == 0 ? 0 : 2;
+}
@@ -0,0 +1,100 @@
+// Converts a SUMO floating car data trace (sumo --fcd-output) into the
+// binary mobility trace read by MobilityTraceLoader
+//
+// The XML is read as a stream and the samples are written as they come,
+// so the conversion needs memory for the vehicle table only.
+
+#include "mobility/mobility_trace_writer.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace vanetza_ns3;
+
+namespace {
+
+// Value of name="..." in the text of an XML tag, empty if missing
+std::string
+Attribute(const std::string& tag, const char* name)
+{
+    const std::string key = std::string(" ") + name + "=\"";
+    const std::size_t begin = tag.find(key);
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    const std::size_t value = begin + key.size();
+    return tag.substr(value, tag.find('"', value) - value);
+}
+
+bool
+StartsWith(const std::string& text, std::size_t pos, const char* prefix)
+{
+    return text.compare(pos, std::char_traits<char>::length(prefix), prefix) == 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3) {
+        std::cerr << "Usage: fcd_to_mobility_trace <fcd.xml> <trace file>" << std::endl;
+        return 1;
+    }
+    
+    std::ifstream in(argv[1]);
+    if (!in) {
+        std::cerr << "Cannot read " << argv[1] << std::endl;
+        return 1;
+    }
+    mobility::MobilityTraceWriter writer(argv[2]);
+    if (!writer.isOpen()) {
+        std::cerr << "Cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+    
+    // FCD attributes never contain '>', so every chunk holds one tag
+    double time = 0.0;
+    uint64_t skipped = 0;
+    std::string chunk;
+    while (std::getline(in, chunk, '>')) {
+        const std::size_t open = chunk.find('<');
+        if (open == std::string::npos) {
+            continue;
+        }
+        if (StartsWith(chunk, open + 1, "timestep ")) {
+            time = std::atof(Attribute(chunk, "time").c_str());
+        } else if (StartsWith(chunk, open + 1, "vehicle ")) {
+            const std::string id = Attribute(chunk, "id");
+            const std::string x = Attribute(chunk, "x");
+            const std::string y = Attribute(chunk, "y");
+            if (id.empty() || x.empty() || y.empty()) {
+                ++skipped;
+                continue;
+            }
+            if (!writer.add(writer.vehicle(id), time,
+                            static_cast<float>(std::atof(x.c_str())),
+                            static_cast<float>(std::atof(y.c_str())),
+                            static_cast<float>(std::atof(Attribute(chunk, "speed").c_str())),
+                            static_cast<float>(std::atof(Attribute(chunk, "angle").c_str())))) {
+                std::cerr << "Cannot add sample of " << id << " at " << time
+                          << "s (time steps out of order or write error)" << std::endl;
+                return 1;
+            }
+        }
+    }
+    
+    const uint64_t samples = writer.samples();
+    const uint32_t vehicles = writer.vehicles();
+    if (!writer.finish()) {
+        std::cerr << "Cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+    std::cerr << samples << " samples of " << vehicles << " vehicles converted";
+    if (skipped > 0) {
+        std::cerr << ", " << skipped << " incomplete samples skipped";
+    }
+    std::cerr << std::endl;
+    return 0;
+}
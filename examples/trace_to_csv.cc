@@ -0,0 +1,46 @@
+// Converts a binary trace written by cam_simulation_example --traceFile
+// into CSV (one line per record)
+
+#include "trace/trace_reader.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+using namespace vanetza_ns3;
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: trace_to_csv <trace file> [csv file]" << std::endl;
+        return 1;
+    }
+    
+    trace::TraceReader reader(argv[1]);
+    if (!reader.isOpen()) {
+        std::cerr << "Cannot read trace " << argv[1] << std::endl;
+        return 1;
+    }
+    
+    std::FILE* out = argc == 3 ? std::fopen(argv[2], "w") : stdout;
+    if (!out) {
+        std::cerr << "Cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+    
+    std::fputs("time_s,event,station,peer,x,y,speed,heading\n", out);
+    trace::TraceRecord record;
+    uint64_t records = 0;
+    while (reader.next(record)) {
+        std::fprintf(out, "%.9f,%s,%u,%u,%.3f,%.3f,%.3f,%.2f\n",
+                     record.timeNs * 1e-9, trace::traceEventName(record.event),
+                     record.station, record.peer, record.x, record.y, record.speed, record.heading);
+        ++records;
+    }
+    
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    std::cerr << records << " records converted" << std::endl;
+    return 0;
+}
@@ -0,0 +1,93 @@
+#!/usr/bin/env bash
+# Optimised build with link-time and profile-guided optimisation
+#
+# Builds cam_simulation_example in three configurations and reports the
+# wall time of a benchmark workload for each, relative to the baseline:
+#
+#   baseline  the configuration before this script: default build type,
+#             debug ns-3, adapter logging compiled out, no LTO
+#   release   Release, optimised ns-3, logging compiled out, LTO
+#   pgo       release, first instrumented to run the training workload,
+#             then rebuilt with the collected profiles
+#
+# Both PGO stages use the same build directory because GCC names the
+# profile files after the object file paths.
+#
+# The last configuration is the one to use for production runs:
+#   <build dir>/pgo/examples/cam_simulation_example
+#
+# Usage: scripts/pgo_build.sh [build dir] [extra cmake arguments...]
+# Environment: JOBS (parallel build jobs), RUNS (timed runs per build)
+
+set -euo pipefail
+
+SOURCE_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+BUILD_ROOT="$(mkdir -p "${1:-$SOURCE_DIR/build-pgo}" && cd "${1:-$SOURCE_DIR/build-pgo}" && pwd)"
+shift || true
+CMAKE_ARGS=("$@")
+JOBS="${JOBS:-$(nproc)}"
+RUNS="${RUNS:-3}"
+PROFILE_DIR="$BUILD_ROOT/profiles"
+
+# Training covers both link models and both CAM generation modes
+TRAINING_RUNS=(
+    "--linkModel=fast --nVehicles=1000 --simTime=20 --verbose=false"
+    "--linkModel=fast --nVehicles=500 --simTime=20 --etsiDynamic=true --verbose=false"
+    "--linkModel=wifi --nVehicles=50 --simTime=10 --verbose=false"
+)
+# The benchmark differs from the training runs on purpose
+BENCHMARK_RUN="--linkModel=fast --nVehicles=2000 --simTime=30 --camInterval=0.1 --verbose=false"
+
+build() {
+    local name="$1"
+    shift
+    cmake -S "$SOURCE_DIR" -B "$BUILD_ROOT/$name" -DBUILD_EXAMPLES=ON ${CMAKE_ARGS[@]+"${CMAKE_ARGS[@]}"} "$@" > /dev/null
+    cmake --build "$BUILD_ROOT/$name" -j "$JOBS" --target cam_simulation_example > /dev/null
+}
+
+run() {
+    local name="$1"
+    shift
+    (cd "$BUILD_ROOT/$name" && ./examples/cam_simulation_example "$@")
+}
+
+# Median wall time of the benchmark workload in seconds
+measure() {
+    local name="$1"
+    for _ in $(seq "$RUNS"); do
+        # shellcheck disable=SC2086
+        run "$name" $BENCHMARK_RUN | sed -n 's/^RESULT .*wallSeconds=\([^ ]*\).*/\1/p'
+    done | sort -g | awk '{ t[NR] = $1 } END { print t[int((NR + 1) / 2)] }'
+}
+
+echo "Building baseline"
+build baseline -DCMAKE_BUILD_TYPE= -DNS3_PROFILE=debug -DENABLE_ADAPTER_LOGGING=OFF -DENABLE_LTO=OFF -DPGO_MODE=off
+
+echo "Building release (LTO)"
+build release -DCMAKE_BUILD_TYPE=Release -DPGO_MODE=off
+
+echo "Building instrumented release"
+rm -rf "$PROFILE_DIR"
+build pgo -DCMAKE_BUILD_TYPE=Release -DPGO_MODE=generate -DPGO_PROFILE_DIR="$PROFILE_DIR"
+
+echo "Training"
+for args in "${TRAINING_RUNS[@]}"; do
+    # shellcheck disable=SC2086
+    run pgo $args > /dev/null
+done
+if ls "$PROFILE_DIR"/*.profraw > /dev/null 2>&1; then
+    # Clang writes raw profiles that have to be merged first
+    llvm-profdata merge -output="$PROFILE_DIR/default.profdata" "$PROFILE_DIR"/*.profraw
+fi
+
+echo "Building profile-optimised release"
+build pgo -DCMAKE_BUILD_TYPE=Release -DPGO_MODE=use -DPGO_PROFILE_DIR="$PROFILE_DIR"
+
+echo "Benchmark: cam_simulation_example $BENCHMARK_RUN (median of $RUNS runs)"
+baseline=$(measure baseline)
+printf "  %-10s %10s s\n" baseline "$baseline"
+for name in release pgo; do
+    seconds=$(measure "$name")
+    speedup=$(awk -v b="$baseline" -v t="$seconds" 'BEGIN { printf "%.2f", t > 0 ? b / t : 0 }')
+    printf "  %-10s %10s s  %sx\n" "$name" "$seconds" "$speedup"
+done
@@ -0,0 +1,67 @@
+#include "btp_b_header.hpp"
+
+namespace vanetza_ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED(BtpBHeader);
+
+constexpr uint32_t BtpBHeader::kSerializedSize;
+constexpr uint16_t BtpBHeader::kCamPort;
+
+BtpBHeader::BtpBHeader(uint16_t destinationPort, uint16_t destinationPortInfo) :
+    m_destinationPort(destinationPort),
+    m_destinationPortInfo(destinationPortInfo)
+{
+}
+
+ns3::TypeId
+BtpBHeader::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::BtpBHeader")
+        .SetParent<ns3::Header>()
+        .SetGroupName("VANET")
+        .AddConstructor<BtpBHeader>();
+    return tid;
+}
+
+ns3::TypeId
+BtpBHeader::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+BtpBHeader::GetSerializedSize() const
+{
+    return kSerializedSize;
+}
+
+void
+BtpBHeader::Serialize(ns3::Buffer::Iterator start) const
+{
+    start.WriteHtonU16(m_destinationPort);
+    start.WriteHtonU16(m_destinationPortInfo);
+}
+
+uint32_t
+BtpBHeader::Deserialize(ns3::Buffer::Iterator start)
+{
+    uint8_t bytes[kSerializedSize];
+    start.Read(bytes, kSerializedSize);
+    return DeserializeFrom(bytes);
+}
+
+uint32_t
+BtpBHeader::DeserializeFrom(const uint8_t* data)
+{
+    m_destinationPort = static_cast<uint16_t>((data[0] << 8) | data[1]);
+    m_destinationPortInfo = static_cast<uint16_t>((data[2] << 8) | data[3]);
+    return kSerializedSize;
+}
+
+void
+BtpBHeader::Print(std::ostream& os) const
+{
+    os << "BTP-B port=" << m_destinationPort << " info=" << m_destinationPortInfo;
+}
+
+} // namespace vanetza_ns3
@@ -0,0 +1,68 @@
+#ifndef BTP_B_HEADER_HPP
+#define BTP_B_HEADER_HPP
+
+#include <cstdint>
+#include <ns3/header.h>
+
+namespace vanetza_ns3 {
+
+/**
+ * @brief Non-interactive BTP header (BTP-B) of ETSI EN 302 636-5-1
+ *
+ * Destination port and destination port info, 4 bytes on the wire.
+ */
+class BtpBHeader : public ns3::Header {
+public:
+    static constexpr uint32_t kSerializedSize = 4;  ///< Destination port and port info
+    static constexpr uint16_t kCamPort = 2001;      ///< Well-known port of the CA basic service
+
+    /**
+     * @brief Constructor
+     * @param destinationPort The destination port
+     * @param destinationPortInfo The destination port info, 0 if unused
+     */
+    explicit BtpBHeader(uint16_t destinationPort = 0, uint16_t destinationPortInfo = 0);
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    // ns3::Header interface
+    virtual ns3::TypeId GetInstanceTypeId() const override;
+    virtual uint32_t GetSerializedSize() const override;
+    virtual void Serialize(ns3::Buffer::Iterator start) const override;
+    virtual uint32_t Deserialize(ns3::Buffer::Iterator start) override;
+    virtual void Print(std::ostream& os) const override;
+
+    /**
+     * @brief Deserialize the header from contiguous wire bytes
+     *
+     * Same result as Deserialize() without going through an ns3::Buffer,
+     * for frames that were already copied out of their packet.
+     * @param data At least kSerializedSize bytes
+     * @return The number of bytes read
+     */
+    uint32_t DeserializeFrom(const uint8_t* data);
+
+    /**
+     * @brief Get the destination port
+     * @return The port
+     */
+    uint16_t GetDestinationPort() const { return m_destinationPort; }
+
+    /**
+     * @brief Get the destination port info
+     * @return The port info
+     */
+    uint16_t GetDestinationPortInfo() const { return m_destinationPortInfo; }
+
+private:
+    uint16_t m_destinationPort;      ///< Destination port
+    uint16_t m_destinationPortInfo;  ///< Destination port info
+};
+
+} // namespace vanetza_ns3
+
+#endif // BTP_B_HEADER_HPP
@@ -0,0 +1,352 @@
+#include "cam_analytics.hpp"
+#include "cam_tx_tag.hpp"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/uinteger.h>
+#include <ns3/string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("CamAnalytics");
+
+NS_OBJECT_ENSURE_REGISTERED(CamAnalytics);
+
+constexpr uint32_t CamAnalytics::kInvalidIndex;
+
+namespace {
+
+void
+WriteHistogram(std::ostream& os, const char* name, const utils::Histogram& histogram)
+{
+    os << "# " << name << ": samples " << histogram.samples()
+       << ", mean " << histogram.mean()
+       << ", min " << histogram.min()
+       << ", p50 " << histogram.quantile(0.5)
+       << ", p95 " << histogram.quantile(0.95)
+       << ", p99 " << histogram.quantile(0.99)
+       << ", max " << histogram.max() << std::endl;
+    os << "# bin_start_ms count" << std::endl;
+    for (std::size_t bin = 0; bin <= histogram.bins(); ++bin) {
+        if (histogram.count(bin) == 0) {
+            continue;
+        }
+        if (bin == histogram.bins()) {
+            os << ">=";
+        }
+        os << bin * histogram.binWidth() << " " << histogram.count(bin) << std::endl;
+    }
+}
+
+} // namespace
+
+CamAnalytics::CamAnalytics() :
+    m_distanceBinWidth(10.0),
+    m_maxDistance(1000.0),
+    m_latencyBinWidth(ns3::MicroSeconds(100)),
+    m_latencyBins(1000),
+    m_interReceptionBinWidth(ns3::MilliSeconds(10)),
+    m_interReceptionBins(200),
+    m_linkTableSize(1 << 16),
+    m_refreshInterval(ns3::MilliSeconds(100)),
+    m_lastRefresh(ns3::Seconds(0)),
+    m_stale(true),
+    m_allocated(false),
+    m_transmissions(0),
+    m_receptions(0),
+    m_linkEvictions(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+CamAnalytics::~CamAnalytics()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ns3::TypeId
+CamAnalytics::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::CamAnalytics")
+        .SetParent<ns3::Object>()
+        .SetGroupName("VANET")
+        .AddConstructor<CamAnalytics>()
+        .AddAttribute("DistanceBinWidth",
+                      "Width of a PDR-vs-distance bin in meters",
+                      ns3::DoubleValue(10.0),
+                      ns3::MakeDoubleAccessor(&CamAnalytics::m_distanceBinWidth),
+                      ns3::MakeDoubleChecker<double>(0.1))
+        .AddAttribute("MaxDistance",
+                      "Stations within this distance of a sender count as intended receivers (meters)",
+                      ns3::DoubleValue(1000.0),
+                      ns3::MakeDoubleAccessor(&CamAnalytics::m_maxDistance),
+                      ns3::MakeDoubleChecker<double>(1.0))
+        .AddAttribute("LatencyBinWidth",
+                      "Width of a latency histogram bin",
+                      ns3::TimeValue(ns3::MicroSeconds(100)),
+                      ns3::MakeTimeAccessor(&CamAnalytics::m_latencyBinWidth),
+                      ns3::MakeTimeChecker(ns3::NanoSeconds(1)))
+        .AddAttribute("LatencyBins",
+                      "Number of latency histogram bins",
+                      ns3::UintegerValue(1000),
+                      ns3::MakeUintegerAccessor(&CamAnalytics::m_latencyBins),
+                      ns3::MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("InterReceptionBinWidth",
+                      "Width of an inter-reception time histogram bin",
+                      ns3::TimeValue(ns3::MilliSeconds(10)),
+                      ns3::MakeTimeAccessor(&CamAnalytics::m_interReceptionBinWidth),
+                      ns3::MakeTimeChecker(ns3::NanoSeconds(1)))
+        .AddAttribute("InterReceptionBins",
+                      "Number of inter-reception time histogram bins",
+                      ns3::UintegerValue(200),
+                      ns3::MakeUintegerAccessor(&CamAnalytics::m_interReceptionBins),
+                      ns3::MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("LinkTableSize",
+                      "Entries of the direct-mapped table of sender/receiver links",
+                      ns3::UintegerValue(1 << 16),
+                      ns3::MakeUintegerAccessor(&CamAnalytics::m_linkTableSize),
+                      ns3::MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("PositionRefreshInterval",
+                      "Maximum age of the station positions used to count intended receivers",
+                      ns3::TimeValue(ns3::MilliSeconds(100)),
+                      ns3::MakeTimeAccessor(&CamAnalytics::m_refreshInterval),
+                      ns3::MakeTimeChecker())
+        .AddAttribute("OutputFile",
+                      "File the report is written to at simulator destruction, standard output if empty",
+                      ns3::StringValue(""),
+                      ns3::MakeStringAccessor(&CamAnalytics::m_outputFile),
+                      ns3::MakeStringChecker());
+    return tid;
+}
+
+void
+CamAnalytics::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_mobility.clear();
+    ns3::Object::DoDispose();
+}
+
+void
+CamAnalytics::Allocate()
+{
+    // Attributes are final once the first station registers
+    m_latency = utils::Histogram(m_latencyBinWidth.GetSeconds() * 1000.0, m_latencyBins);
+    m_interReception = utils::Histogram(m_interReceptionBinWidth.GetSeconds() * 1000.0, m_interReceptionBins);
+    const std::size_t distanceBins = static_cast<std::size_t>(std::ceil(m_maxDistance / m_distanceBinWidth));
+    m_intended.assign(distanceBins, 0);
+    m_delivered.assign(distanceBins, 0);
+    m_links.assign(m_linkTableSize, Link());
+    m_grid.setCellSize(m_maxDistance);
+    m_allocated = true;
+    
+    ns3::Simulator::ScheduleDestroy(&CamAnalytics::Dump, ns3::Ptr<CamAnalytics>(this));
+}
+
+uint32_t
+CamAnalytics::AddStation(uint32_t stationId, ns3::Ptr<ns3::MobilityModel> mobility)
+{
+    NS_LOG_FUNCTION(this << stationId << mobility);
+    if (!m_allocated) {
+        Allocate();
+    }
+    m_stationIds.push_back(stationId);
+    m_mobility.push_back(mobility);
+    m_active.push_back(1);
+    m_stale = true;
+    return static_cast<uint32_t>(m_stationIds.size() - 1);
+}
+
+void
+CamAnalytics::SetStationId(uint32_t index, uint32_t stationId)
+{
+    NS_LOG_FUNCTION(this << index << stationId);
+    m_stationIds[index] = stationId;
+    m_stale = true;
+}
+
+void
+CamAnalytics::SetStationActive(uint32_t index, bool active)
+{
+    NS_LOG_FUNCTION(this << index << active);
+    m_active[index] = active ? 1 : 0;
+}
+
+void
+CamAnalytics::RefreshPositions()
+{
+    ns3::Time now = ns3::Simulator::Now();
+    if (!m_stale && now - m_lastRefresh < m_refreshInterval) {
+        return;
+    }
+    
+    const std::size_t n = m_mobility.size();
+    m_x.resize(n);
+    m_y.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        ns3::Vector position = m_mobility[i] ? m_mobility[i]->GetPosition() : ns3::Vector();
+        m_x[i] = static_cast<float>(position.x);
+        m_y[i] = static_cast<float>(position.y);
+    }
+    m_grid.build(m_x.data(), m_y.data(), n);
+    m_lastRefresh = now;
+    m_stale = false;
+}
+
+void
+CamAnalytics::OnTransmit(uint32_t index, ns3::Ptr<ns3::Packet> packet)
+{
+    NS_LOG_FUNCTION(this << index << packet);
+    if (!m_mobility[index]) {
+        return;
+    }
+    const ns3::Vector position = m_mobility[index]->GetPosition();
+    packet->AddPacketTag(CamTxTag(m_stationIds[index], ns3::Simulator::Now(),
+                                  static_cast<float>(position.x), static_cast<float>(position.y)));
+}
+
+void
+CamAnalytics::OnSent(uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+    if (!m_mobility[index]) {
+        return;
+    }
+    RefreshPositions();
+    ++m_transmissions;
+    
+    // Every other running station within range is an intended receiver
+    const ns3::Vector position = m_mobility[index]->GetPosition();
+    const float maxDistance = static_cast<float>(m_maxDistance);
+    m_grid.forEachWithin(static_cast<float>(position.x), static_cast<float>(position.y), maxDistance,
+                         [this, index](uint32_t i, float squaredDistance) {
+        if (i == index || !m_active[i]) {
+            return;
+        }
+        const std::size_t bin = static_cast<std::size_t>(std::sqrt(squaredDistance) / m_distanceBinWidth);
+        if (bin < m_intended.size()) {
+            ++m_intended[bin];
+        }
+    });
+}
+
+void
+CamAnalytics::OnReceive(uint32_t index, ns3::Ptr<const ns3::Packet> packet)
+{
+    NS_LOG_FUNCTION(this << index << packet);
+    CamTxTag tag;
+    if (!packet->PeekPacketTag(tag) || !m_mobility[index]) {
+        return;
+    }
+    ++m_receptions;
+    
+    const ns3::Time now = ns3::Simulator::Now();
+    m_latency.add((now - tag.GetGenerationTime()).GetSeconds() * 1000.0);
+    
+    const ns3::Vector position = m_mobility[index]->GetPosition();
+    const double dx = position.x - tag.GetPosX();
+    const double dy = position.y - tag.GetPosY();
+    const std::size_t bin = static_cast<std::size_t>(std::sqrt(dx * dx + dy * dy) / m_distanceBinWidth);
+    if (bin < m_delivered.size()) {
+        ++m_delivered[bin];
+    }
+    
+    // Inter-reception time of this sender at this receiver, keyed by station
+    // so that a reused index does not continue the links of its previous station
+    const uint64_t key = (static_cast<uint64_t>(m_stationIds[index]) + 1) << 32 | tag.GetStationId();
+    Link& link = m_links[(key * 0x9E3779B97F4A7C15ull >> 32) % m_links.size()];
+    if (link.key == key) {
+        m_interReception.add((now.GetNanoSeconds() - link.lastReception) * 1e-6);
+    } else if (link.key != 0) {
+        ++m_linkEvictions;
+    }
+    link.key = key;
+    link.lastReception = now.GetNanoSeconds();
+}
+
+const utils::Histogram&
+CamAnalytics::GetLatency() const
+{
+    return m_latency;
+}
+
+const utils::Histogram&
+CamAnalytics::GetInterReceptionTime() const
+{
+    return m_interReception;
+}
+
+double
+CamAnalytics::GetPdr(std::size_t bin) const
+{
+    if (bin >= m_intended.size() || m_intended[bin] == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(m_delivered[bin]) / m_intended[bin];
+}
+
+uint64_t
+CamAnalytics::GetIntended(std::size_t bin) const
+{
+    return bin < m_intended.size() ? m_intended[bin] : 0;
+}
+
+std::size_t
+CamAnalytics::GetDistanceBins() const
+{
+    return m_intended.size();
+}
+
+double
+CamAnalytics::GetDistanceBinWidth() const
+{
+    return m_distanceBinWidth;
+}
+
+void
+CamAnalytics::WriteReport(std::ostream& os) const
+{
+    os << "# CAM analytics: " << m_stationIds.size() << " stations, "
+       << m_transmissions << " CAMs sent, " << m_receptions << " received, "
+       << m_linkEvictions << " link table evictions" << std::endl;
+    
+    WriteHistogram(os, "latency_ms", m_latency);
+    WriteHistogram(os, "inter_reception_ms", m_interReception);
+    
+    os << "# pdr: distance_m pdr intended delivered" << std::endl;
+    for (std::size_t bin = 0; bin < m_intended.size(); ++bin) {
+        if (m_intended[bin] == 0) {
+            continue;
+        }
+        os << std::fixed << std::setprecision(1) << (bin + 0.5) * m_distanceBinWidth << " "
+           << std::setprecision(4) << GetPdr(bin) << " "
+           << m_intended[bin] << " " << m_delivered[bin] << std::endl;
+        os.unsetf(std::ios::floatfield);
+        os << std::setprecision(6);
+    }
+}
+
+void
+CamAnalytics::Dump()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_outputFile.empty()) {
+        WriteReport(std::cout);
+        return;
+    }
+    std::ofstream out(m_outputFile);
+    if (!out) {
+        NS_LOG_ERROR("Cannot write CAM analytics to " << m_outputFile);
+        return;
+    }
+    WriteReport(out);
+}
+
+} // namespace vanetza_ns3
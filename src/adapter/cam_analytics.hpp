@@ -0,0 +1,222 @@
+#ifndef CAM_ANALYTICS_HPP
+#define CAM_ANALYTICS_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/packet.h>
+#include <ns3/mobility-model.h>
+
+#include "utils/histogram.hpp"
+#include "utils/uniform_grid.hpp"
+
+namespace vanetza_ns3 {
+
+/**
+ * @brief Streaming end-to-end statistics of CAM dissemination
+ * 
+ * Sending adapters tag every CAM with its generation time and the
+ * sender's position (CamTxTag). Receiving adapters hand the frame back to
+ * the analytics, which measure latency and distance from the tag and
+ * aggregate them into fixed-bucket histograms:
+ * 
+ * - end-to-end latency,
+ * - packet delivery ratio per distance bin, where every running station
+ *   within MaxDistance of the sender at transmission time counts as an
+ *   intended receiver,
+ * - inter-reception time per sender/receiver link.
+ * 
+ * Memory is fixed when the stations are registered and does not grow with
+ * the run length: the link table for inter-reception times is a
+ * direct-mapped table of LinkTableSize entries, where a collision replaces
+ * the older link and only costs that link one sample.
+ * 
+ * The results are written when the simulator is destroyed, to OutputFile
+ * or to standard output.
+ */
+class CamAnalytics : public ns3::Object {
+public:
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;  ///< Index of an unregistered station
+
+    /**
+     * @brief Constructor
+     */
+    CamAnalytics();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~CamAnalytics();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    /**
+     * @brief Register a station as potential receiver
+     * @param stationId The station ID
+     * @param mobility The station's mobility model
+     * @return The index to pass to OnTransmit and OnReceive
+     */
+    uint32_t AddStation(uint32_t stationId, ns3::Ptr<ns3::MobilityModel> mobility);
+
+    /**
+     * @brief Hand a registered index to another station
+     * 
+     * Used when a pooled station slot is reused, see FleetManager.
+     * @param index The index returned by AddStation
+     * @param stationId The new station ID
+     */
+    void SetStationId(uint32_t index, uint32_t stationId);
+
+    /**
+     * @brief Mark a station as running or stopped
+     * 
+     * Stopped stations do not count as intended receivers, e.g. pooled
+     * slots between occupants or trace vehicles outside their trip.
+     * Stations are running when registered.
+     * @param index The index returned by AddStation
+     * @param active False while the station is stopped
+     */
+    void SetStationActive(uint32_t index, bool active);
+
+    /**
+     * @brief Tag a CAM about to be sent
+     * @param index Index of the sending station
+     * @param packet The CAM
+     */
+    void OnTransmit(uint32_t index, ns3::Ptr<ns3::Packet> packet);
+
+    /**
+     * @brief Count the intended receivers of a CAM the device accepted
+     * 
+     * Only called after a successful send, so failed sends do not add to
+     * the PDR denominators.
+     * @param index Index of the sending station
+     */
+    void OnSent(uint32_t index);
+
+    /**
+     * @brief Account a received CAM
+     * 
+     * Frames without CamTxTag are ignored.
+     * @param index Index of the receiving station
+     * @param packet The received frame
+     */
+    void OnReceive(uint32_t index, ns3::Ptr<const ns3::Packet> packet);
+
+    /**
+     * @brief Get the latency histogram
+     * @return Latencies in milliseconds
+     */
+    const utils::Histogram& GetLatency() const;
+
+    /**
+     * @brief Get the inter-reception time histogram
+     * @return Inter-reception times in milliseconds
+     */
+    const utils::Histogram& GetInterReceptionTime() const;
+
+    /**
+     * @brief Get the delivery ratio of a distance bin
+     * @param bin The bin index
+     * @return The ratio of delivered to intended receptions, 0 without transmissions
+     */
+    double GetPdr(std::size_t bin) const;
+
+    /**
+     * @brief Get the number of intended receptions of a distance bin
+     * @param bin The bin index
+     * @return The intended receptions, 0 for bins out of range
+     */
+    uint64_t GetIntended(std::size_t bin) const;
+
+    /**
+     * @brief Get the number of distance bins
+     * @return The number of PDR bins, 0 before the first station registers
+     */
+    std::size_t GetDistanceBins() const;
+
+    /**
+     * @brief Get the width of a distance bin
+     * @return The width in meters
+     */
+    double GetDistanceBinWidth() const;
+
+    /**
+     * @brief Write all statistics
+     * @param os The output stream
+     */
+    void WriteReport(std::ostream& os) const;
+
+protected:
+    /**
+     * @brief Dispose of the analytics
+     */
+    virtual void DoDispose() override;
+
+private:
+    /**
+     * @brief Slot of a sender/receiver link in the link table
+     */
+    struct Link {
+        uint64_t key = 0;        ///< (receiver station ID + 1) << 32 | sender station ID, 0 if free
+        int64_t lastReception = 0;  ///< Time of the last reception in nanoseconds
+    };
+
+    /**
+     * @brief Allocate the histograms and tables from the attributes
+     */
+    void Allocate();
+
+    /**
+     * @brief Rebuild the position grid if positions are outdated
+     */
+    void RefreshPositions();
+
+    /**
+     * @brief Write the report at simulator destruction
+     */
+    void Dump();
+
+    // Configuration
+    double m_distanceBinWidth;                          ///< Width of a PDR bin in meters
+    double m_maxDistance;                               ///< Range of intended receivers in meters
+    ns3::Time m_latencyBinWidth;                        ///< Width of a latency bin
+    uint32_t m_latencyBins;                             ///< Number of latency bins
+    ns3::Time m_interReceptionBinWidth;                 ///< Width of an inter-reception bin
+    uint32_t m_interReceptionBins;                      ///< Number of inter-reception bins
+    uint32_t m_linkTableSize;                           ///< Entries of the link table
+    ns3::Time m_refreshInterval;                        ///< Maximum age of the position grid
+    std::string m_outputFile;                           ///< Report file, standard output if empty
+
+    // Stations
+    std::vector<uint32_t> m_stationIds;                 ///< Station ID per index
+    std::vector<ns3::Ptr<ns3::MobilityModel>> m_mobility;  ///< Mobility model per index
+    std::vector<uint8_t> m_active;                      ///< Running flag per index
+    std::vector<float> m_x;                             ///< Cached X coordinate per index
+    std::vector<float> m_y;                             ///< Cached Y coordinate per index
+    utils::UniformGrid m_grid;                          ///< Grid over the cached positions
+    ns3::Time m_lastRefresh;                            ///< Time of the last grid rebuild
+    bool m_stale;                                       ///< Stations were added since the last rebuild
+
+    // Statistics
+    bool m_allocated;                                   ///< Histograms and tables are allocated
+    utils::Histogram m_latency;                         ///< End-to-end latency in milliseconds
+    utils::Histogram m_interReception;                  ///< Inter-reception time in milliseconds
+    std::vector<uint64_t> m_intended;                   ///< Intended receptions per distance bin
+    std::vector<uint64_t> m_delivered;                  ///< Delivered receptions per distance bin
+    std::vector<Link> m_links;                          ///< Direct-mapped link table
+    uint64_t m_transmissions;                           ///< Tagged CAMs sent
+    uint64_t m_receptions;                              ///< Tagged CAMs received
+    uint64_t m_linkEvictions;                           ///< Links replaced by a colliding link
+};
+
+} // namespace vanetza_ns3
+
+#endif // CAM_ANALYTICS_HPP
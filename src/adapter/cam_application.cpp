@@ -1,12 +1,19 @@
 #include "cam_application.hpp"
 #include "vanetza_ns3_adapter.hpp"
+#include "cam_generation_engine.hpp"
+#include "messages/cam_codec.hpp"
 
 #include <ns3/log.h>
 #include <ns3/simulator.h>
 #include <ns3/uinteger.h>
 #include <ns3/double.h>
+#include <ns3/enum.h>
 #include <ns3/mobility-model.h>
 #include <ns3/vector.h>
+#include <ns3/trace-source-accessor.h>
+
+#include <algorithm>
+#include <cmath>
 
 namespace vanetza_ns3 {
 
@@ -16,8 +23,14 @@ NS_OBJECT_ENSURE_REGISTERED(CamApplication);
 
 CamApplication::CamApplication() :
     m_adapter(nullptr),
+    m_engine(nullptr),
+    m_engineHandle(CamGenerationEngine::kInvalidHandle),
+    m_restoredNextNs(-1),
     m_stationId(0),
-    m_camGenerationInterval(1.0) // Default: 1 second
+    m_camGenerationInterval(1.0), // Default: 1 second
+    m_generationMode(PERIODIC),
+    m_checkInterval(0.1),
+    m_ldmLifetime(ns3::MilliSeconds(1100))
 {
     NS_LOG_FUNCTION(this);
 }
@@ -43,7 +56,27 @@ CamApplication::GetTypeId()
                       "Interval between CAM generations in seconds",
                       ns3::DoubleValue(1.0),
                       ns3::MakeDoubleAccessor(&CamApplication::m_camGenerationInterval),
-                      ns3::MakeDoubleChecker<double>(0.1, 10.0));
+                      ns3::MakeDoubleChecker<double>(0.1, 10.0))
+        .AddAttribute("GenerationMode",
+                      "Periodic generation or ETSI EN 302 637-2 dynamic triggering",
+                      ns3::EnumValue(PERIODIC),
+                      ns3::MakeEnumAccessor(&CamApplication::m_generationMode),
+                      ns3::MakeEnumChecker(PERIODIC, "Periodic",
+                                           ETSI_DYNAMIC, "EtsiDynamic"))
+        .AddAttribute("CheckInterval",
+                      "Interval between trigger checks in ETSI dynamic mode (T_CheckCamGen) in seconds",
+                      ns3::DoubleValue(0.1),
+                      ns3::MakeDoubleAccessor(&CamApplication::m_checkInterval),
+                      ns3::MakeDoubleChecker<double>(0.01, 1.0))
+        .AddAttribute("LdmLifetime",
+                      "Time after which a neighbour without CAM is removed from the Local Dynamic Map",
+                      ns3::TimeValue(ns3::MilliSeconds(1100)),
+                      ns3::MakeTimeAccessor(&CamApplication::m_ldmLifetime),
+                      ns3::MakeTimeChecker(ns3::MilliSeconds(1)))
+        .AddTraceSource("CamReceived",
+                        "A CAM was received and decoded",
+                        ns3::MakeTraceSourceAccessor(&CamApplication::m_camReceivedSignal),
+                        "vanetza_ns3::CamApplication::CamReceivedCallback");
     return tid;
 }
 
@@ -61,6 +94,101 @@ CamApplication::SetAdapter(ns3::Ptr<VanetzaNS3Adapter> adapter)
     }
 }
 
+void
+CamApplication::SetStationId(uint32_t id)
+{
+    NS_LOG_FUNCTION(this << id);
+    m_stationId = id;
+}
+
+void
+CamApplication::SetGenerationEngine(ns3::Ptr<CamGenerationEngine> engine)
+{
+    NS_LOG_FUNCTION(this << engine);
+    m_engine = engine;
+}
+
+void
+CamApplication::SetGenCamDcc(ns3::Time interval)
+{
+    NS_LOG_FUNCTION(this << interval);
+    
+    int64_t ms = std::max<int64_t>(interval.GetMilliSeconds(), m_triggerParams.genCamMinMs);
+    m_triggerState.genCamDccMs = static_cast<uint16_t>(std::min<int64_t>(ms, m_triggerParams.genCamMaxMs));
+}
+
+const CamTriggerCounters&
+CamApplication::GetTriggerCounters() const
+{
+    return m_triggerCounters;
+}
+
+const LocalDynamicMap&
+CamApplication::GetLocalDynamicMap() const
+{
+    return m_ldm;
+}
+
+double
+CamApplication::GetGenerationCheckInterval() const
+{
+    return m_generationMode == ETSI_DYNAMIC ? m_checkInterval : m_camGenerationInterval;
+}
+
+void
+CamApplication::Activate(uint32_t stationId)
+{
+    NS_LOG_FUNCTION(this << stationId);
+    m_stationId = stationId;
+    m_ldm.clear();
+    
+    // The DCC limit follows the channel, not the station
+    const uint16_t genCamDccMs = m_triggerState.genCamDccMs;
+    m_triggerState = CamTriggerState();
+    m_triggerState.genCamDccMs = genCamDccMs;
+    StartApplication();
+}
+
+void
+CamApplication::Deactivate()
+{
+    NS_LOG_FUNCTION(this);
+    StopApplication();
+}
+
+CamApplicationSnapshot
+CamApplication::SaveState() const
+{
+    CamApplicationSnapshot state;
+    state.stationId = m_stationId;
+    state.trigger = m_triggerState;
+    if (m_engine && m_engineHandle != CamGenerationEngine::kInvalidHandle) {
+        state.nextGenerationNs = (m_engine->GetNextTime(m_engineHandle) - ns3::Simulator::Now()).GetNanoSeconds();
+    } else if (m_camEvent.IsRunning()) {
+        state.nextGenerationNs = ns3::Simulator::GetDelayLeft(m_camEvent).GetNanoSeconds();
+    }
+    return state;
+}
+
+void
+CamApplication::RestoreState(const CamApplicationSnapshot& state)
+{
+    NS_LOG_FUNCTION(this << state.stationId);
+    
+    m_stationId = state.stationId;
+    m_triggerState = state.trigger;
+    m_restoredNextNs = state.nextGenerationNs;
+    m_ldm.clear();
+    m_ldm.setLifetime(m_ldmLifetime.GetMilliSeconds());
+}
+
+void
+CamApplication::RestoreNeighbour(uint32_t stationId, float x, float y, float speed, float heading,
+                                 int64_t lastUpdateMs)
+{
+    m_ldm.update(stationId, x, y, speed, heading, lastUpdateMs);
+}
+
 void
 CamApplication::StartApplication()
 {
@@ -71,8 +199,10 @@ CamApplication::StartApplication()
         return;
     }
     
-    // Schedule first CAM generation
-    ScheduleNextCamGeneration();
+    m_ldm.setLifetime(m_ldmLifetime.GetMilliSeconds());
+    m_mobility = GetNode()->GetObject<ns3::MobilityModel>();
+    
+    ScheduleFirstCamGeneration();
 }
 
 void
@@ -84,6 +214,10 @@ CamApplication::StopApplication()
     if (m_camEvent.IsRunning()) {
         m_camEvent.Cancel();
     }
+    if (m_engine) {
+        m_engine->Unregister(m_engineHandle);
+        m_engineHandle = CamGenerationEngine::kInvalidHandle;
+    }
 }
 
 void
@@ -93,95 +227,125 @@ CamApplication::ScheduleNextCamGeneration()
     
     // Schedule next CAM generation
     m_camEvent = ns3::Simulator::Schedule(
-        ns3::Seconds(m_camGenerationInterval),
-        &CamApplication::GenerateCam,
+        ns3::Seconds(GetGenerationCheckInterval()),
+        &CamApplication::HandleCamTimer,
         this);
 }
 
+void
+CamApplication::ScheduleFirstCamGeneration()
+{
+    ns3::Callback<void> generate = ns3::MakeCallback(&CamApplication::GenerateCam, this);
+    const ns3::Time period = ns3::Seconds(GetGenerationCheckInterval());
+    
+    // A restored application keeps the phase it had when the snapshot was taken
+    if (m_restoredNextNs >= 0) {
+        const ns3::Time delay = ns3::NanoSeconds(m_restoredNextNs);
+        m_restoredNextNs = -1;
+        if (m_engine) {
+            m_engineHandle = m_engine->Register(generate, period, delay);
+        } else {
+            m_camEvent = ns3::Simulator::Schedule(delay, &CamApplication::HandleCamTimer, this);
+        }
+        return;
+    }
+    
+    if (m_engine) {
+        m_engineHandle = m_engine->Register(generate, period);
+    } else {
+        ScheduleNextCamGeneration();
+    }
+}
+
+void
+CamApplication::HandleCamTimer()
+{
+    NS_LOG_FUNCTION(this);
+    
+    GenerateCam();
+    ScheduleNextCamGeneration();
+}
+
 void
 CamApplication::GenerateCam()
 {
     NS_LOG_FUNCTION(this);
     
+    // Drop neighbours that went silent
+    m_ldm.purgeExpired(ns3::Simulator::Now().GetMilliSeconds());
+    
     // Get node's current position and speed from mobility model
-    ns3::Ptr<ns3::MobilityModel> mobility = GetNode()->GetObject<ns3::MobilityModel>();
-    if (!mobility) {
+    if (!m_mobility) {
         NS_LOG_WARN("No mobility model found for node");
-        ScheduleNextCamGeneration();
         return;
     }
     
-    ns3::Vector position = mobility->GetPosition();
-    ns3::Vector velocity = mobility->GetVelocity();
+    ns3::Vector position = m_mobility->GetPosition();
+    ns3::Vector velocity = m_mobility->GetVelocity();
+    float speed = static_cast<float>(std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y));
+    float heading = static_cast<float>(std::atan2(velocity.y, velocity.x) * 180.0 / M_PI);
+    
+    if (m_generationMode == ETSI_DYNAMIC) {
+        CamTriggerDecision decision = evaluateCamTrigger(
+            m_triggerParams, m_triggerState, m_triggerCounters,
+            ns3::Simulator::Now().GetMilliSeconds(),
+            static_cast<float>(position.x), static_cast<float>(position.y), speed, heading);
+        if (decision.reason == CamTriggerReason::None) {
+            return;
+        }
+        NS_LOG_LOGIC("CAM triggered by rule " << static_cast<int>(decision.reason)
+                     << (decision.lowFrequency ? " with low-frequency container" : ""));
+    }
     
     // Create CAM message with position, speed, and other vehicle data
     // In a real implementation, this would create a proper CAM message according to ETSI standards
-    // For now, we'll create a simple binary message with basic information
-    
-    // Simple CAM format (example):
-    // - 4 bytes: Station ID
-    // - 4 bytes: Timestamp (seconds since simulation start)
-    // - 4 bytes: X position (in meters)
-    // - 4 bytes: Y position (in meters)
-    // - 4 bytes: Speed (in m/s)
-    // - 4 bytes: Heading (in degrees)
-    
-    uint8_t cam_buffer[24];
-    uint32_t* station_id_ptr = reinterpret_cast<uint32_t*>(&cam_buffer[0]);
-    uint32_t* timestamp_ptr = reinterpret_cast<uint32_t*>(&cam_buffer[4]);
-    float* pos_x_ptr = reinterpret_cast<float*>(&cam_buffer[8]);
-    float* pos_y_ptr = reinterpret_cast<float*>(&cam_buffer[12]);
-    float* speed_ptr = reinterpret_cast<float*>(&cam_buffer[16]);
-    float* heading_ptr = reinterpret_cast<float*>(&cam_buffer[20]);
-    
-    // Fill in the values
-    *station_id_ptr = m_stationId;
-    *timestamp_ptr = static_cast<uint32_t>(ns3::Simulator::Now().GetSeconds());
-    *pos_x_ptr = static_cast<float>(position.x);
-    *pos_y_ptr = static_cast<float>(position.y);
-    *speed_ptr = static_cast<float>(std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y));
-    *heading_ptr = static_cast<float>(std::atan2(velocity.y, velocity.x) * 180.0 / M_PI);
+    // For now, we use the simplified wire format from messages/cam_codec.hpp
+    messages::CamMessage cam;
+    cam.stationId = m_stationId;
+    cam.timestamp = static_cast<uint32_t>(ns3::Simulator::Now().GetSeconds());
+    cam.posX = static_cast<float>(position.x);
+    cam.posY = static_cast<float>(position.y);
+    cam.speed = speed;
+    cam.heading = heading;
+    
+    uint8_t cam_buffer[messages::CamLayout::size];
+    std::size_t cam_size = messages::encodeCam(cam, cam_buffer, sizeof(cam_buffer));
     
     // Send CAM message using the adapter
     if (m_adapter) {
-        m_adapter->SendCam(cam_buffer, sizeof(cam_buffer));
+        ++m_adapter->GetMetrics().camsGenerated;
+        m_adapter->SendCam(cam_buffer, cam_size);
     }
-    
-    // Schedule next CAM generation
-    ScheduleNextCamGeneration();
 }
 
-void
+bool
 CamApplication::ReceiveCam(const uint8_t* data, std::size_t size)
 {
     NS_LOG_FUNCTION(this << data << size);
     
     // Process received CAM message
     // In a real implementation, this would parse the CAM message according to ETSI standards
-    // For now, we'll parse our simple binary format
-    
-    if (size < 24) {
-        NS_LOG_WARN("Received CAM message is too small: " << size << " bytes");
-        return;
+    // For now, we parse the simplified wire format from messages/cam_codec.hpp
+    messages::CamMessage cam;
+    if (!messages::decodeCam(data, size, cam)) {
+        NS_LOG_WARN("Received malformed CAM message: " << size << " bytes");
+        return false;
     }
     
-    // Parse the CAM message
-    uint32_t station_id = *reinterpret_cast<const uint32_t*>(&data[0]);
-    uint32_t timestamp = *reinterpret_cast<const uint32_t*>(&data[4]);
-    float pos_x = *reinterpret_cast<const float*>(&data[8]);
-    float pos_y = *reinterpret_cast<const float*>(&data[12]);
-    float speed = *reinterpret_cast<const float*>(&data[16]);
-    float heading = *reinterpret_cast<const float*>(&data[20]);
-    
     // Log the received CAM information
-    NS_LOG_INFO("Received CAM from station " << station_id
-                << " at time " << timestamp
-                << ": position=" << pos_x << "," << pos_y
-                << ", speed=" << speed
-                << ", heading=" << heading);
+    NS_LOG_INFO("Received CAM from station " << cam.stationId
+                << " at time " << cam.timestamp
+                << ": position=" << cam.posX << "," << cam.posY
+                << ", speed=" << cam.speed
+                << ", heading=" << cam.heading);
+    
+    // Keep the neighbour's latest state
+    m_ldm.update(cam.stationId, cam.posX, cam.posY, cam.speed, cam.heading,
+                 ns3::Simulator::Now().GetMilliSeconds());
     
     // Emit signal for received CAM
-    m_camReceivedSignal(station_id, pos_x, pos_y, speed, heading);
+    m_camReceivedSignal(cam.stationId, cam.posX, cam.posY, cam.speed, cam.heading);
+    return true;
 }
 
 } // namespace vanetza_ns3
\ No newline at end of file
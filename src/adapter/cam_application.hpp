@@ -5,15 +5,32 @@
 #include <ns3/ptr.h>
 #include <ns3/event-id.h>
 #include <ns3/traced-callback.h>
+#include <ns3/nstime.h>
+
+#include "cam_trigger.hpp"
+#include "local_dynamic_map.hpp"
 
 namespace ns3 {
     class NetDevice;
+    class MobilityModel;
 }
 
 namespace vanetza_ns3 {
 
 // Forward declarations
 class VanetzaNS3Adapter;
+class CamGenerationEngine;
+
+/**
+ * @brief Generation state of a running CAM application, see ScenarioSnapshot
+ * 
+ * The Local Dynamic Map is captured separately, entry by entry.
+ */
+struct CamApplicationSnapshot {
+    uint32_t stationId = 0;          ///< Station ID
+    int64_t nextGenerationNs = -1;   ///< Time until the next generation check, -1 if none is pending
+    CamTriggerState trigger;         ///< ETSI trigger state
+};
 
 /**
  * @brief Application class for generating and processing CAM messages
@@ -46,6 +63,21 @@ public:
      */
     void SetAdapter(ns3::Ptr<VanetzaNS3Adapter> adapter);
 
+    /**
+     * @brief Set the station ID written into generated CAMs
+     * @param id The station ID
+     */
+    void SetStationId(uint32_t id);
+
+    /**
+     * @brief Drive CAM generation from a shared generation engine
+     * 
+     * When set before the application starts, no per-application timer is
+     * used; the engine invokes the generation in its slot loop instead.
+     * @param engine The engine, or nullptr to use a private timer
+     */
+    void SetGenerationEngine(ns3::Ptr<CamGenerationEngine> engine);
+
     /**
      * @brief Traced callback for received CAM messages
      * 
@@ -53,6 +85,75 @@ public:
      */
     typedef ns3::TracedCallback<uint32_t, float, float, float, float> CamReceivedCallback;
 
+    /**
+     * @brief How CAM generation is decided
+     */
+    enum GenerationMode {
+        PERIODIC,       ///< One CAM every CamGenerationInterval
+        ETSI_DYNAMIC    ///< Trigger conditions of ETSI EN 302 637-2
+    };
+
+    /**
+     * @brief Set T_GenCam_DCC, the lower bound imposed by congestion control
+     * 
+     * Only used in ETSI_DYNAMIC mode.
+     * @param interval The minimum interval between two CAMs
+     */
+    void SetGenCamDcc(ns3::Time interval);
+
+    /**
+     * @brief Get the number of CAMs triggered by each generation rule
+     * @return The trigger counters
+     */
+    const CamTriggerCounters& GetTriggerCounters() const;
+
+    /**
+     * @brief Get the Local Dynamic Map fed by received CAMs
+     * @return The Local Dynamic Map of this station
+     */
+    const LocalDynamicMap& GetLocalDynamicMap() const;
+
+    /**
+     * @brief Start generating CAMs in a pooled slot under a new station ID
+     * 
+     * Clears the Local Dynamic Map and the generation state of the previous
+     * station. Used instead of the application start time, see FleetManager.
+     * @param stationId The station ID
+     */
+    void Activate(uint32_t stationId);
+
+    /**
+     * @brief Stop generating CAMs until the next Activate()
+     */
+    void Deactivate();
+
+    /**
+     * @brief Capture the generation state of the running application
+     * @return The state, relative to the current simulation time
+     */
+    CamApplicationSnapshot SaveState() const;
+
+    /**
+     * @brief Resume the application from a captured state when it starts
+     * 
+     * Must be called before the application starts. Clears the Local
+     * Dynamic Map, which is refilled through RestoreNeighbour().
+     * @param state The captured state
+     */
+    void RestoreState(const CamApplicationSnapshot& state);
+
+    /**
+     * @brief Put a captured neighbour back into the Local Dynamic Map
+     * @param stationId Station ID of the neighbour
+     * @param x X position in meters
+     * @param y Y position in meters
+     * @param speed Speed in m/s
+     * @param heading Heading in degrees
+     * @param lastUpdateMs Time of the neighbour's last CAM in milliseconds
+     */
+    void RestoreNeighbour(uint32_t stationId, float x, float y, float speed, float heading,
+                          int64_t lastUpdateMs);
+
 protected:
     /**
      * @brief Start the application
@@ -77,7 +178,23 @@ private:
     void ScheduleNextCamGeneration();
 
     /**
-     * @brief Generate and send a CAM message
+     * @brief Schedule the first CAM generation after the start
+     */
+    void ScheduleFirstCamGeneration();
+
+    /**
+     * @brief Handle expiry of the private CAM generation timer
+     */
+    void HandleCamTimer();
+
+    /**
+     * @brief Get the interval at which GenerateCam is invoked
+     * @return The interval in seconds
+     */
+    double GetGenerationCheckInterval() const;
+
+    /**
+     * @brief Generate and send a CAM message if one is due
      */
     void GenerateCam();
 
@@ -85,16 +202,32 @@ private:
      * @brief Process a received CAM message
      * @param data The message data
      * @param size The size of the message data
+     * @return True if the message decoded as a CAM
      */
-    void ReceiveCam(const uint8_t* data, std::size_t size);
+    bool ReceiveCam(const uint8_t* data, std::size_t size);
 
     // NS3 components
     ns3::Ptr<VanetzaNS3Adapter> m_adapter;  ///< The Vanetza-NS3 adapter
     ns3::EventId m_camEvent;                ///< Event for CAM generation
+    ns3::Ptr<CamGenerationEngine> m_engine; ///< Optional shared generation engine
+    uint32_t m_engineHandle;                ///< Registration with the engine
+    ns3::Ptr<ns3::MobilityModel> m_mobility;  ///< Mobility of the node, looked up on start
+    int64_t m_restoredNextNs;               ///< Captured phase of the first generation, -1 if none
 
     // Configuration
     uint32_t m_stationId;                   ///< Station ID
     double m_camGenerationInterval;         ///< Interval between CAM generations in seconds
+    GenerationMode m_generationMode;        ///< How CAM generation is decided
+    double m_checkInterval;                 ///< T_CheckCamGen in seconds (ETSI_DYNAMIC mode)
+
+    // ETSI dynamic generation
+    CamTriggerParameters m_triggerParams;   ///< Generation rules
+    CamTriggerState m_triggerState;         ///< Generation state of this station
+    CamTriggerCounters m_triggerCounters;   ///< CAMs triggered per rule
+
+    // Local Dynamic Map
+    LocalDynamicMap m_ldm;                  ///< Latest state of neighbouring stations
+    ns3::Time m_ldmLifetime;                ///< Time after which a silent neighbour is purged
 
     // Traced callbacks
     CamReceivedCallback m_camReceivedSignal;  ///< Signal for received CAM messages
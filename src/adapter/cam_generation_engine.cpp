@@ -0,0 +1,237 @@
+#include "cam_generation_engine.hpp"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/boolean.h>
+#include <ns3/random-variable-stream.h>
+
+#include <algorithm>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("CamGenerationEngine");
+
+NS_OBJECT_ENSURE_REGISTERED(CamGenerationEngine);
+
+constexpr uint32_t CamGenerationEngine::kInvalidHandle;
+
+CamGenerationEngine::CamGenerationEngine() :
+    m_slotDuration(ns3::MilliSeconds(100)),
+    m_phaseStagger(true),
+    m_phaseRng(ns3::CreateObject<ns3::UniformRandomVariable>()),
+    m_nActive(0),
+    m_scheduledSlot(0),
+    m_slotEvents(0),
+    m_generations(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+CamGenerationEngine::~CamGenerationEngine()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ns3::TypeId
+CamGenerationEngine::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::CamGenerationEngine")
+        .SetParent<ns3::Object>()
+        .SetGroupName("VANET")
+        .AddConstructor<CamGenerationEngine>()
+        .AddAttribute("SlotDuration",
+                      "Granularity of the generation schedule",
+                      ns3::TimeValue(ns3::MilliSeconds(100)),
+                      ns3::MakeTimeAccessor(&CamGenerationEngine::m_slotDuration),
+                      ns3::MakeTimeChecker(ns3::MilliSeconds(1)))
+        .AddAttribute("PhaseStagger",
+                      "Randomise the first generation of each station within its period",
+                      ns3::BooleanValue(true),
+                      ns3::MakeBooleanAccessor(&CamGenerationEngine::m_phaseStagger),
+                      ns3::MakeBooleanChecker());
+    return tid;
+}
+
+void
+CamGenerationEngine::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    
+    if (m_slotEvent.IsRunning()) {
+        m_slotEvent.Cancel();
+    }
+    m_callbacks.clear();
+    m_phaseRng = nullptr;
+    ns3::Object::DoDispose();
+}
+
+uint32_t
+CamGenerationEngine::Register(ns3::Callback<void> cb, ns3::Time period)
+{
+    NS_LOG_FUNCTION(this << period);
+    
+    uint32_t periodSlots = ToSlots(period);
+    uint64_t firstSlot = CurrentSlot();
+    if (m_phaseStagger) {
+        firstSlot += 1 + m_phaseRng->GetInteger(0, periodSlots - 1);
+    } else {
+        firstSlot += periodSlots;
+    }
+    
+    return AddStation(cb, periodSlots, firstSlot);
+}
+
+uint32_t
+CamGenerationEngine::Register(ns3::Callback<void> cb, ns3::Time period, ns3::Time delay)
+{
+    NS_LOG_FUNCTION(this << period << delay);
+    
+    const uint64_t now = CurrentSlot();
+    const uint64_t due = static_cast<uint64_t>((ns3::Simulator::Now() + delay).GetTimeStep() / m_slotDuration.GetTimeStep());
+    return AddStation(cb, ToSlots(period), std::max(due, now + 1));
+}
+
+ns3::Time
+CamGenerationEngine::GetNextTime(uint32_t handle) const
+{
+    if (handle >= m_active.size() || !m_active[handle]) {
+        return ns3::TimeStep(-1);
+    }
+    return ns3::TimeStep(m_nextSlot[handle] * m_slotDuration.GetTimeStep());
+}
+
+uint32_t
+CamGenerationEngine::AddStation(ns3::Callback<void> cb, uint32_t periodSlots, uint64_t firstSlot)
+{
+    uint32_t handle;
+    if (!m_freeHandles.empty()) {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+        m_nextSlot[handle] = firstSlot;
+        m_periodSlots[handle] = periodSlots;
+        m_active[handle] = 1;
+        m_callbacks[handle] = cb;
+    } else {
+        handle = static_cast<uint32_t>(m_nextSlot.size());
+        m_nextSlot.push_back(firstSlot);
+        m_periodSlots.push_back(periodSlots);
+        m_active.push_back(1);
+        m_callbacks.push_back(cb);
+    }
+    ++m_nActive;
+    
+    ScheduleSlot(firstSlot);
+    return handle;
+}
+
+void
+CamGenerationEngine::Unregister(uint32_t handle)
+{
+    NS_LOG_FUNCTION(this << handle);
+    
+    if (handle >= m_active.size() || !m_active[handle]) {
+        return;
+    }
+    
+    m_active[handle] = 0;
+    m_callbacks[handle] = ns3::Callback<void>();
+    m_freeHandles.push_back(handle);
+    --m_nActive;
+    
+    if (m_nActive == 0 && m_slotEvent.IsRunning()) {
+        m_slotEvent.Cancel();
+    }
+}
+
+void
+CamGenerationEngine::SetPeriod(uint32_t handle, ns3::Time period)
+{
+    NS_LOG_FUNCTION(this << handle << period);
+    
+    if (handle < m_active.size() && m_active[handle]) {
+        m_periodSlots[handle] = ToSlots(period);
+    }
+}
+
+uint32_t
+CamGenerationEngine::GetNStations() const
+{
+    return m_nActive;
+}
+
+uint64_t
+CamGenerationEngine::GetSlotEventCount() const
+{
+    return m_slotEvents;
+}
+
+uint64_t
+CamGenerationEngine::GetGenerationCount() const
+{
+    return m_generations;
+}
+
+uint32_t
+CamGenerationEngine::ToSlots(ns3::Time period) const
+{
+    int64_t slots = (period.GetTimeStep() + m_slotDuration.GetTimeStep() / 2) / m_slotDuration.GetTimeStep();
+    return static_cast<uint32_t>(std::max<int64_t>(slots, 1));
+}
+
+uint64_t
+CamGenerationEngine::CurrentSlot() const
+{
+    return static_cast<uint64_t>(ns3::Simulator::Now().GetTimeStep() / m_slotDuration.GetTimeStep());
+}
+
+void
+CamGenerationEngine::ScheduleSlot(uint64_t slot)
+{
+    if (m_slotEvent.IsRunning()) {
+        if (m_scheduledSlot <= slot) {
+            return;
+        }
+        m_slotEvent.Cancel();
+    }
+    
+    ns3::Time at = ns3::TimeStep(slot * m_slotDuration.GetTimeStep());
+    m_scheduledSlot = slot;
+    m_slotEvent = ns3::Simulator::Schedule(at - ns3::Simulator::Now(),
+                                           &CamGenerationEngine::ProcessSlot, this);
+}
+
+void
+CamGenerationEngine::ProcessSlot()
+{
+    NS_LOG_FUNCTION(this);
+    
+    const uint64_t slot = m_scheduledSlot;
+    ++m_slotEvents;
+    
+    // Stations registered from within a callback are appended behind 'n'
+    // and scheduled by Register itself, so the loop bound stays fixed.
+    const std::size_t n = m_nextSlot.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!m_active[i] || m_nextSlot[i] > slot) {
+            continue;
+        }
+        m_nextSlot[i] = slot + m_periodSlots[i];
+        ++m_generations;
+        // Copy the callback: the station may unregister itself while running
+        ns3::Callback<void> cb = m_callbacks[i];
+        cb();
+    }
+    
+    // Find the earliest slot with work and skip empty slots in between
+    uint64_t next = UINT64_MAX;
+    for (std::size_t i = 0; i < m_nextSlot.size(); ++i) {
+        if (m_active[i]) {
+            next = std::min(next, m_nextSlot[i]);
+        }
+    }
+    if (next != UINT64_MAX) {
+        ScheduleSlot(next);
+    }
+}
+
+} // namespace vanetza_ns3
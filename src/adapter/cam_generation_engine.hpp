@@ -0,0 +1,172 @@
+#ifndef CAM_GENERATION_ENGINE_HPP
+#define CAM_GENERATION_ENGINE_HPP
+
+#include <cstdint>
+#include <vector>
+#include <ns3/object.h>
+#include <ns3/callback.h>
+#include <ns3/event-id.h>
+#include <ns3/nstime.h>
+#include <ns3/ptr.h>
+
+namespace ns3 {
+    class UniformRandomVariable;
+}
+
+namespace vanetza_ns3 {
+
+/**
+ * @brief Shared generation engine driving periodic CAM work of many stations
+ * 
+ * Instead of every CamApplication and VanetzaNS3Adapter keeping its own
+ * Simulator::Schedule timer, stations register a callback and a period with
+ * a single engine. The engine keeps the station table in contiguous arrays,
+ * fires one simulator event per generation slot and invokes every station
+ * that is due in that slot. Initial phases can be staggered randomly so that
+ * stations with the same period do not transmit in lock-step.
+ */
+class CamGenerationEngine : public ns3::Object {
+public:
+    /**
+     * @brief Handle value returned for invalid registrations
+     */
+    static constexpr uint32_t kInvalidHandle = UINT32_MAX;
+
+    /**
+     * @brief Constructor
+     */
+    CamGenerationEngine();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~CamGenerationEngine();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    /**
+     * @brief Register a station with the engine
+     * @param cb The callback invoked whenever the station is due
+     * @param period The generation period of the station
+     * @return Handle identifying the registration
+     */
+    uint32_t Register(ns3::Callback<void> cb, ns3::Time period);
+
+    /**
+     * @brief Register a station whose first generation is already known
+     * 
+     * Used to resume a station from a snapshot; the phase is not staggered.
+     * @param cb The callback invoked whenever the station is due
+     * @param period The generation period of the station
+     * @param delay Time until the first generation (at least one slot)
+     * @return Handle identifying the registration
+     */
+    uint32_t Register(ns3::Callback<void> cb, ns3::Time period, ns3::Time delay);
+
+    /**
+     * @brief Remove a station from the engine
+     * @param handle The handle returned by Register
+     */
+    void Unregister(uint32_t handle);
+
+    /**
+     * @brief Change the period of a registered station
+     * 
+     * The new period takes effect after the next generation of the station.
+     * @param handle The handle returned by Register
+     * @param period The new generation period
+     */
+    void SetPeriod(uint32_t handle, ns3::Time period);
+
+    /**
+     * @brief Get the time at which a registered station is due next
+     * @param handle The handle returned by Register
+     * @return The time of the next generation, or a negative time if the handle is not registered
+     */
+    ns3::Time GetNextTime(uint32_t handle) const;
+
+    /**
+     * @brief Get the number of active stations
+     * @return The number of active stations
+     */
+    uint32_t GetNStations() const;
+
+    /**
+     * @brief Get the number of slot events executed so far
+     * @return The number of slot events
+     */
+    uint64_t GetSlotEventCount() const;
+
+    /**
+     * @brief Get the number of station callbacks invoked so far
+     * @return The number of station callbacks
+     */
+    uint64_t GetGenerationCount() const;
+
+protected:
+    /**
+     * @brief Dispose of the engine and cancel the pending slot event
+     */
+    virtual void DoDispose() override;
+
+private:
+    /**
+     * @brief Convert a duration into a number of slots (at least one)
+     * @param period The duration
+     * @return The number of slots
+     */
+    uint32_t ToSlots(ns3::Time period) const;
+
+    /**
+     * @brief Get the index of the slot containing the current time
+     * @return The current slot index
+     */
+    uint64_t CurrentSlot() const;
+
+    /**
+     * @brief Enter a station into the table and schedule its first slot
+     * @param cb The callback invoked whenever the station is due
+     * @param periodSlots The period in slots
+     * @param firstSlot The slot of the first generation
+     * @return Handle identifying the registration
+     */
+    uint32_t AddStation(ns3::Callback<void> cb, uint32_t periodSlots, uint64_t firstSlot);
+
+    /**
+     * @brief Make sure a slot event is pending for the given slot
+     * @param slot The slot that needs processing
+     */
+    void ScheduleSlot(uint64_t slot);
+
+    /**
+     * @brief Invoke all stations that are due in the current slot
+     */
+    void ProcessSlot();
+
+    // Configuration
+    ns3::Time m_slotDuration;                          ///< Duration of one generation slot
+    bool m_phaseStagger;                               ///< Randomise initial phases
+    ns3::Ptr<ns3::UniformRandomVariable> m_phaseRng;   ///< Random source for phases
+
+    // Station table (structure of arrays, indexed by handle)
+    std::vector<uint64_t> m_nextSlot;                  ///< Slot in which the station is due next
+    std::vector<uint32_t> m_periodSlots;               ///< Period of the station in slots
+    std::vector<uint8_t> m_active;                     ///< Non-zero if the entry is in use
+    std::vector<ns3::Callback<void> > m_callbacks;     ///< Generation callbacks
+    std::vector<uint32_t> m_freeHandles;               ///< Recycled table entries
+    uint32_t m_nActive;                                ///< Number of active entries
+
+    // Scheduling state
+    ns3::EventId m_slotEvent;                          ///< Pending slot event
+    uint64_t m_scheduledSlot;                          ///< Slot of the pending event
+    uint64_t m_slotEvents;                             ///< Number of slot events executed
+    uint64_t m_generations;                            ///< Number of callbacks invoked
+};
+
+} // namespace vanetza_ns3
+
+#endif // CAM_GENERATION_ENGINE_HPP
@@ -0,0 +1,88 @@
+#include "cam_trigger.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vanetza_ns3 {
+
+namespace {
+
+float headingDelta(float a, float b)
+{
+    float delta = std::fabs(a - b);
+    return delta > 180.0f ? 360.0f - delta : delta;
+}
+
+} // namespace
+
+CamTriggerDecision
+evaluateCamTrigger(const CamTriggerParameters& params,
+                   CamTriggerState& state,
+                   CamTriggerCounters& counters,
+                   int64_t nowMs,
+                   float x, float y, float speed, float heading)
+{
+    CamTriggerDecision decision;
+    
+    if (state.lastCamMs < 0) {
+        // The first CAM of a station is sent right away
+        decision.reason = CamTriggerReason::Time;
+        state.genCamMs = params.genCamMaxMs;
+    } else {
+        const int64_t elapsed = nowMs - state.lastCamMs;
+        const int64_t dcc = std::max<int64_t>(state.genCamDccMs, params.genCamMinMs);
+        if (elapsed < dcc) {
+            return decision;
+        }
+        
+        // Condition 1: vehicle dynamics changed since the last CAM
+        const float dx = x - state.lastX;
+        const float dy = y - state.lastY;
+        if (headingDelta(heading, state.lastHeading) > params.headingThresholdDeg) {
+            decision.reason = CamTriggerReason::Heading;
+        } else if (dx * dx + dy * dy > params.positionThresholdM * params.positionThresholdM) {
+            decision.reason = CamTriggerReason::Position;
+        } else if (std::fabs(speed - state.lastSpeed) > params.speedThresholdMps) {
+            decision.reason = CamTriggerReason::Speed;
+        }
+        
+        if (decision.reason != CamTriggerReason::None) {
+            // T_GenCam follows the dynamics for the next N_GenCam CAMs
+            state.genCamMs = static_cast<uint16_t>(std::min<int64_t>(
+                std::max<int64_t>(elapsed, params.genCamMinMs), params.genCamMaxMs));
+            state.nGenCamCount = 0;
+        } else if (elapsed >= state.genCamMs) {
+            // Condition 2: T_GenCam (and T_GenCam_DCC) elapsed
+            decision.reason = CamTriggerReason::Time;
+            if (++state.nGenCamCount >= params.nGenCam) {
+                state.genCamMs = params.genCamMaxMs;
+                state.nGenCamCount = 0;
+            }
+        } else {
+            return decision;
+        }
+    }
+    
+    switch (decision.reason) {
+        case CamTriggerReason::Heading: ++counters.heading; break;
+        case CamTriggerReason::Position: ++counters.position; break;
+        case CamTriggerReason::Speed: ++counters.speed; break;
+        default: ++counters.time; break;
+    }
+    
+    if (state.lastLowFrequencyMs < 0 ||
+        nowMs - state.lastLowFrequencyMs >= params.lowFrequencyIntervalMs) {
+        decision.lowFrequency = true;
+        state.lastLowFrequencyMs = nowMs;
+        ++counters.lowFrequency;
+    }
+    
+    state.lastCamMs = nowMs;
+    state.lastX = x;
+    state.lastY = y;
+    state.lastSpeed = speed;
+    state.lastHeading = heading;
+    return decision;
+}
+
+} // namespace vanetza_ns3
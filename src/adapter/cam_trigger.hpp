@@ -0,0 +1,90 @@
+#ifndef CAM_TRIGGER_HPP
+#define CAM_TRIGGER_HPP
+
+#include <cstdint>
+
+namespace vanetza_ns3 {
+
+/**
+ * @brief Reason why a CAM generation was triggered
+ */
+enum class CamTriggerReason : uint8_t {
+    None,       ///< No CAM is due
+    Heading,    ///< Heading changed by more than the threshold
+    Position,   ///< Position changed by more than the threshold
+    Speed,      ///< Speed changed by more than the threshold
+    Time        ///< T_GenCam elapsed (or first CAM of the station)
+};
+
+/**
+ * @brief Generation rules of ETSI EN 302 637-2, section 6.1.3
+ */
+struct CamTriggerParameters {
+    uint16_t genCamMinMs = 100;             ///< T_GenCamMin
+    uint16_t genCamMaxMs = 1000;            ///< T_GenCamMax
+    uint16_t lowFrequencyIntervalMs = 500;  ///< Minimum spacing of low-frequency containers
+    uint8_t nGenCam = 3;                    ///< N_GenCam
+    float headingThresholdDeg = 4.0f;       ///< Heading change trigger
+    float positionThresholdM = 4.0f;        ///< Position change trigger
+    float speedThresholdMps = 0.5f;         ///< Speed change trigger
+};
+
+/**
+ * @brief Per-station generation state, kept compact for large fleets
+ */
+struct CamTriggerState {
+    int64_t lastCamMs = -1;                 ///< Time of the last CAM, -1 if none yet
+    int64_t lastLowFrequencyMs = -1;        ///< Time of the last low-frequency container
+    float lastX = 0.0f;                     ///< Position of the last CAM (x)
+    float lastY = 0.0f;                     ///< Position of the last CAM (y)
+    float lastSpeed = 0.0f;                 ///< Speed of the last CAM
+    float lastHeading = 0.0f;               ///< Heading of the last CAM in degrees
+    uint16_t genCamMs = 1000;               ///< Current T_GenCam
+    uint16_t genCamDccMs = 100;             ///< Current T_GenCam_DCC
+    uint8_t nGenCamCount = 0;               ///< Consecutive CAMs generated with the current T_GenCam
+};
+
+/**
+ * @brief Number of CAMs triggered by each rule
+ */
+struct CamTriggerCounters {
+    uint64_t heading = 0;                   ///< CAMs triggered by heading change
+    uint64_t position = 0;                  ///< CAMs triggered by position change
+    uint64_t speed = 0;                     ///< CAMs triggered by speed change
+    uint64_t time = 0;                      ///< CAMs triggered by T_GenCam expiry
+    uint64_t lowFrequency = 0;              ///< CAMs carrying a low-frequency container
+};
+
+/**
+ * @brief Outcome of a generation check
+ */
+struct CamTriggerDecision {
+    CamTriggerReason reason = CamTriggerReason::None;  ///< Why a CAM is due
+    bool lowFrequency = false;                         ///< Include the low-frequency container
+};
+
+/**
+ * @brief Check whether a CAM has to be generated now
+ * 
+ * Evaluates the dynamic triggering conditions against the station's last
+ * generated CAM. If a CAM is due, the state and counters are updated as if
+ * the CAM had been generated.
+ * @param params The generation rules
+ * @param state The station's generation state
+ * @param counters The station's trigger counters
+ * @param nowMs The current time in milliseconds
+ * @param x The current position (x) in meters
+ * @param y The current position (y) in meters
+ * @param speed The current speed in m/s
+ * @param heading The current heading in degrees
+ * @return The decision
+ */
+CamTriggerDecision evaluateCamTrigger(const CamTriggerParameters& params,
+                                      CamTriggerState& state,
+                                      CamTriggerCounters& counters,
+                                      int64_t nowMs,
+                                      float x, float y, float speed, float heading);
+
+} // namespace vanetza_ns3
+
+#endif // CAM_TRIGGER_HPP
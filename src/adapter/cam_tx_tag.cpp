@@ -0,0 +1,71 @@
+#include "cam_tx_tag.hpp"
+
+namespace vanetza_ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED(CamTxTag);
+
+CamTxTag::CamTxTag() :
+    m_stationId(0),
+    m_posX(0.0f),
+    m_posY(0.0f)
+{
+}
+
+CamTxTag::CamTxTag(uint32_t stationId, ns3::Time generationTime, float posX, float posY) :
+    m_stationId(stationId),
+    m_generationTime(generationTime),
+    m_posX(posX),
+    m_posY(posY)
+{
+}
+
+ns3::TypeId
+CamTxTag::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::CamTxTag")
+        .SetParent<ns3::Tag>()
+        .SetGroupName("VANET")
+        .AddConstructor<CamTxTag>();
+    return tid;
+}
+
+ns3::TypeId
+CamTxTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+CamTxTag::GetSerializedSize() const
+{
+    // Station ID, generation time in nanoseconds, position
+    return 4 + 8 + 4 + 4;
+}
+
+void
+CamTxTag::Serialize(ns3::TagBuffer buffer) const
+{
+    buffer.WriteU32(m_stationId);
+    buffer.WriteU64(static_cast<uint64_t>(m_generationTime.GetNanoSeconds()));
+    buffer.Write(reinterpret_cast<const uint8_t*>(&m_posX), sizeof(m_posX));
+    buffer.Write(reinterpret_cast<const uint8_t*>(&m_posY), sizeof(m_posY));
+}
+
+void
+CamTxTag::Deserialize(ns3::TagBuffer buffer)
+{
+    m_stationId = buffer.ReadU32();
+    m_generationTime = ns3::NanoSeconds(static_cast<int64_t>(buffer.ReadU64()));
+    buffer.Read(reinterpret_cast<uint8_t*>(&m_posX), sizeof(m_posX));
+    buffer.Read(reinterpret_cast<uint8_t*>(&m_posY), sizeof(m_posY));
+}
+
+void
+CamTxTag::Print(std::ostream& os) const
+{
+    os << "station=" << m_stationId
+       << " generated=" << m_generationTime.GetSeconds() << "s"
+       << " pos=(" << m_posX << "," << m_posY << ")";
+}
+
+} // namespace vanetza_ns3
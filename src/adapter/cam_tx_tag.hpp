@@ -0,0 +1,79 @@
+#ifndef CAM_TX_TAG_HPP
+#define CAM_TX_TAG_HPP
+
+#include <cstdint>
+#include <ns3/tag.h>
+#include <ns3/nstime.h>
+
+namespace vanetza_ns3 {
+
+/**
+ * @brief Packet tag carrying the transmission metadata of a CAM
+ * 
+ * Attached by the sending adapter, so receivers can measure latency and
+ * distance without parsing the payload. The tag is simulation metadata
+ * only and does not add to the frame size on the channel.
+ */
+class CamTxTag : public ns3::Tag {
+public:
+    /**
+     * @brief Constructor
+     */
+    CamTxTag();
+
+    /**
+     * @brief Constructor
+     * @param stationId The sending station
+     * @param generationTime Time the CAM was generated
+     * @param posX X coordinate of the sender at generation time
+     * @param posY Y coordinate of the sender at generation time
+     */
+    CamTxTag(uint32_t stationId, ns3::Time generationTime, float posX, float posY);
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    // ns3::Tag interface
+    virtual ns3::TypeId GetInstanceTypeId() const override;
+    virtual uint32_t GetSerializedSize() const override;
+    virtual void Serialize(ns3::TagBuffer buffer) const override;
+    virtual void Deserialize(ns3::TagBuffer buffer) override;
+    virtual void Print(std::ostream& os) const override;
+
+    /**
+     * @brief Get the sending station
+     * @return The station ID
+     */
+    uint32_t GetStationId() const { return m_stationId; }
+
+    /**
+     * @brief Get the generation time of the CAM
+     * @return The generation time
+     */
+    ns3::Time GetGenerationTime() const { return m_generationTime; }
+
+    /**
+     * @brief Get the X coordinate of the sender at generation time
+     * @return The X coordinate in meters
+     */
+    float GetPosX() const { return m_posX; }
+
+    /**
+     * @brief Get the Y coordinate of the sender at generation time
+     * @return The Y coordinate in meters
+     */
+    float GetPosY() const { return m_posY; }
+
+private:
+    uint32_t m_stationId;         ///< Sending station
+    ns3::Time m_generationTime;   ///< Generation time of the CAM
+    float m_posX;                 ///< Sender X coordinate
+    float m_posY;                 ///< Sender Y coordinate
+};
+
+} // namespace vanetza_ns3
+
+#endif // CAM_TX_TAG_HPP
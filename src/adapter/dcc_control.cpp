@@ -0,0 +1,123 @@
+#include "dcc_control.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace vanetza_ns3 {
+
+namespace {
+
+DccState stateForCbr(const DccParameters& params, float cbr)
+{
+    std::size_t state = 0;
+    while (state < kDccStateCount - 1 && cbr >= params.stateThresholds[state]) {
+        ++state;
+    }
+    return static_cast<DccState>(state);
+}
+
+// Lowest (or highest) CBR among the latest samples of the ring
+template<typename Compare>
+float latestExtreme(const DccStationState& state, std::size_t samples, Compare better)
+{
+    const std::size_t n = std::min<std::size_t>(samples, state.historyCount);
+    float extreme = state.cbrHistory[(state.historyHead + kDccCbrHistory - 1) % kDccCbrHistory];
+    for (std::size_t i = 2; i <= n; ++i) {
+        const float cbr = state.cbrHistory[(state.historyHead + kDccCbrHistory - i) % kDccCbrHistory];
+        if (better(cbr, extreme)) {
+            extreme = cbr;
+        }
+    }
+    return extreme;
+}
+
+void updateReactive(const DccParameters& params, DccStationState& state, DccCounters& counters)
+{
+    // Up if even the quietest recent sample is above the current state,
+    // down only if even the busiest of a longer history is below it
+    DccState next = state.state;
+    const DccState up = state.historyCount >= params.upSamples ?
+        stateForCbr(params, latestExtreme(state, params.upSamples, std::less<float>())) : state.state;
+    if (up > state.state) {
+        next = up;
+    } else if (state.historyCount >= params.downSamples) {
+        const DccState down = stateForCbr(params, latestExtreme(state, params.downSamples, std::greater<float>()));
+        if (down < state.state) {
+            next = down;
+        }
+    }
+    
+    if (next != state.state) {
+        state.state = next;
+        ++counters.transitions;
+    }
+    ++counters.samplesInState[static_cast<std::size_t>(state.state)];
+}
+
+void updateAdaptive(const DccParameters& params, DccStationState& state, float cbr)
+{
+    // LIMERIC runs every second measurement interval on the mean of both
+    if (++state.pendingSamples < 2) {
+        return;
+    }
+    state.pendingSamples = 0;
+    
+    const float previous = state.cbrHistory[(state.historyHead + kDccCbrHistory - 2) % kDccCbrHistory];
+    state.cbrIts = 0.5f * state.cbrIts + 0.5f * (cbr + previous) / 2.0f;
+    
+    float offset = params.beta * (params.cbrTarget - state.cbrIts);
+    offset = offset > 0.0f ? std::min(offset, params.gainPlusMax) : std::max(offset, params.gainMinusMax);
+    state.delta = std::min(std::max((1.0f - params.alpha) * state.delta + offset, params.deltaMin), params.deltaMax);
+}
+
+} // namespace
+
+void
+updateDcc(const DccParameters& params, DccMode mode,
+          DccStationState& state, DccCounters& counters, float cbr)
+{
+    state.cbrHistory[state.historyHead] = cbr;
+    state.historyHead = static_cast<uint8_t>((state.historyHead + 1) % kDccCbrHistory);
+    if (state.historyCount < kDccCbrHistory) {
+        ++state.historyCount;
+    }
+    ++counters.samples;
+    counters.cbrSum += cbr;
+    
+    if (mode == DccMode::Reactive) {
+        updateReactive(params, state, counters);
+    } else {
+        updateAdaptive(params, state, cbr);
+    }
+}
+
+int64_t
+dccIntervalNs(const DccParameters& params, DccMode mode, const DccStationState& state)
+{
+    const int64_t ms = 1000000;
+    if (mode == DccMode::Reactive) {
+        return params.stateIntervalMs[static_cast<std::size_t>(state.state)] * ms;
+    }
+    
+    // T_off = T_on / delta; before the first frame only the lower bound applies
+    const int64_t interval = static_cast<int64_t>(state.airtimeNs / state.delta);
+    return std::min(std::max(interval, params.minIntervalMs * ms), params.maxIntervalMs * ms);
+}
+
+bool
+requestDccTransmission(const DccParameters& params, DccMode mode,
+                       DccStationState& state, DccCounters& counters,
+                       int64_t nowNs, uint32_t airtimeNs)
+{
+    if (state.lastTxNs >= 0 && nowNs - state.lastTxNs < dccIntervalNs(params, mode, state)) {
+        ++counters.gated;
+        return false;
+    }
+    
+    state.lastTxNs = nowNs;
+    state.airtimeNs = airtimeNs;
+    ++counters.allowed;
+    return true;
+}
+
+} // namespace vanetza_ns3
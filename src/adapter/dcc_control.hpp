@@ -0,0 +1,139 @@
+#ifndef DCC_CONTROL_HPP
+#define DCC_CONTROL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vanetza_ns3 {
+
+/**
+ * @brief Decentralized congestion control approach of ETSI TS 102 687
+ */
+enum class DccMode : uint8_t {
+    Reactive,   ///< State machine mapping the channel busy ratio to a packet interval
+    Adaptive    ///< LIMERIC, converging to a target channel busy ratio
+};
+
+/**
+ * @brief States of the reactive approach (five-state table)
+ */
+enum class DccState : uint8_t {
+    Relaxed,
+    Active1,
+    Active2,
+    Active3,
+    Restrictive
+};
+
+static const std::size_t kDccStateCount = 5;    ///< Number of reactive states
+static const std::size_t kDccCbrHistory = 50;   ///< CBR samples kept per station
+
+/**
+ * @brief Parameters of both DCC approaches, ETSI TS 102 687 V1.2.1 defaults
+ */
+struct DccParameters {
+    // Reactive approach (Table A.2)
+    float stateThresholds[kDccStateCount - 1] = { 0.30f, 0.40f, 0.50f, 0.60f };  ///< Lowest CBR of Active1..Restrictive
+    uint16_t stateIntervalMs[kDccStateCount] = { 100, 200, 400, 500, 1000 };    ///< Packet interval per state
+    uint8_t upSamples = 10;                 ///< Samples that must all reach a higher state before moving up
+    uint8_t downSamples = 50;               ///< Samples that must all stay in a lower state before moving down
+
+    // Adaptive approach (LIMERIC, section 5.4)
+    float alpha = 0.016f;                   ///< Weight of the previous delta
+    float beta = 0.0012f;                   ///< Gain of the CBR error
+    float cbrTarget = 0.68f;                ///< Target channel busy ratio
+    float deltaMin = 0.0006f;               ///< Smallest allowed duty cycle
+    float deltaMax = 0.03f;                 ///< Largest allowed duty cycle
+    float gainPlusMax = 0.0005f;            ///< Largest increase of delta per update
+    float gainMinusMax = -0.00025f;         ///< Largest decrease of delta per update
+    uint16_t minIntervalMs = 25;            ///< Shortest packet interval
+    uint16_t maxIntervalMs = 1000;          ///< Longest packet interval
+};
+
+/**
+ * @brief Per-station DCC state
+ */
+struct DccStationState {
+    float cbrHistory[kDccCbrHistory] = {};  ///< Ring of the latest CBR samples
+    uint8_t historyHead = 0;                ///< Next slot of the ring
+    uint8_t historyCount = 0;               ///< Valid samples in the ring
+    DccState state = DccState::Relaxed;     ///< Reactive state
+    uint8_t pendingSamples = 0;             ///< Samples since the last LIMERIC update
+    float cbrIts = 0.0f;                    ///< Smoothed CBR of the adaptive approach
+    float delta = 0.03f;                    ///< Allowed duty cycle of the adaptive approach
+    uint32_t airtimeNs = 0;                 ///< Air time of the last transmitted frame
+    int64_t lastTxNs = -1;                  ///< Time of the last transmission, -1 if none yet
+};
+
+/**
+ * @brief Per-station DCC counters
+ */
+struct DccCounters {
+    uint64_t samples = 0;                           ///< CBR samples evaluated
+    uint64_t samplesInState[kDccStateCount] = {};   ///< Samples spent in each reactive state
+    uint64_t transitions = 0;                       ///< Reactive state changes
+    uint64_t allowed = 0;                           ///< Transmissions let through
+    uint64_t gated = 0;                             ///< Transmissions held back
+    double cbrSum = 0.0;                            ///< Sum of the CBR samples
+
+    DccCounters& operator+=(const DccCounters& other)
+    {
+        samples += other.samples;
+        for (std::size_t i = 0; i < kDccStateCount; ++i) {
+            samplesInState[i] += other.samplesInState[i];
+        }
+        transitions += other.transitions;
+        allowed += other.allowed;
+        gated += other.gated;
+        cbrSum += other.cbrSum;
+        return *this;
+    }
+};
+
+/**
+ * @brief Feed one channel busy ratio sample into a station's DCC
+ *
+ * The reactive approach moves up as soon as the last upSamples samples all
+ * belong to a higher state, and down once the last downSamples samples all
+ * belong to a lower one. The adaptive approach smooths every two samples
+ * into CBR_ITS and updates the duty cycle delta with LIMERIC.
+ * @param params The DCC parameters
+ * @param mode The approach
+ * @param state The station's DCC state
+ * @param counters The station's counters
+ * @param cbr The channel busy ratio of the last measurement interval
+ */
+void updateDcc(const DccParameters& params, DccMode mode,
+               DccStationState& state, DccCounters& counters, float cbr);
+
+/**
+ * @brief Get the minimum interval between two transmissions of a station
+ *
+ * Reactive: the interval of the current state. Adaptive: the air time of
+ * the last frame divided by delta, within [minIntervalMs, maxIntervalMs].
+ * @param params The DCC parameters
+ * @param mode The approach
+ * @param state The station's DCC state
+ * @return The interval in nanoseconds
+ */
+int64_t dccIntervalNs(const DccParameters& params, DccMode mode, const DccStationState& state);
+
+/**
+ * @brief Decide whether a station may transmit a frame now
+ *
+ * If it may, the transmission is recorded in the state and counters.
+ * @param params The DCC parameters
+ * @param mode The approach
+ * @param state The station's DCC state
+ * @param counters The station's counters
+ * @param nowNs The current time in nanoseconds
+ * @param airtimeNs The air time of the frame
+ * @return True if the frame may be sent
+ */
+bool requestDccTransmission(const DccParameters& params, DccMode mode,
+                            DccStationState& state, DccCounters& counters,
+                            int64_t nowNs, uint32_t airtimeNs);
+
+} // namespace vanetza_ns3
+
+#endif // DCC_CONTROL_HPP
@@ -0,0 +1,312 @@
+#include "dcc_controller.hpp"
+#include "cam_application.hpp"
+#include "fast_link_net_device.hpp"
+#include "fast_link_channel.hpp"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/enum.h>
+#include <ns3/wifi-net-device.h>
+#include <ns3/wifi-phy.h>
+#include <ns3/wifi-phy-state-helper.h>
+
+#include <algorithm>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("DccController");
+
+NS_OBJECT_ENSURE_REGISTERED(DccController);
+
+constexpr std::size_t DccController::kBusyWindows;
+
+namespace {
+
+// WifiPhy State trace sink, bound to the controller and the station index
+void
+NotifyPhyState(DccController* controller, uint32_t index,
+               ns3::Time start, ns3::Time duration, ns3::WifiPhyState state)
+{
+    if (state == ns3::WifiPhyState::TX || state == ns3::WifiPhyState::RX ||
+        state == ns3::WifiPhyState::CCA_BUSY) {
+        controller->AddBusyTime(index, start, duration);
+    }
+}
+
+const char* const kStateNames[kDccStateCount] = {
+    "relaxed", "active1", "active2", "active3", "restrictive"
+};
+
+} // namespace
+
+DccController::DccController() :
+    m_mode(REACTIVE),
+    m_interval(ns3::MilliSeconds(100)),
+    m_dataRate("6Mbps"),
+    m_frameOverhead(ns3::MicroSeconds(100)),
+    m_targetCbr(0.68),
+    m_evaluated(-1)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+DccController::~DccController()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ns3::TypeId
+DccController::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::DccController")
+        .SetParent<ns3::Object>()
+        .SetGroupName("VANET")
+        .AddConstructor<DccController>()
+        .AddAttribute("Mode",
+                      "Reactive state machine or adaptive LIMERIC control",
+                      ns3::EnumValue(REACTIVE),
+                      ns3::MakeEnumAccessor(&DccController::m_mode),
+                      ns3::MakeEnumChecker(REACTIVE, "Reactive",
+                                           ADAPTIVE, "Adaptive"))
+        .AddAttribute("MeasurementInterval",
+                      "Interval over which the channel busy ratio is measured (T_CBR)",
+                      ns3::TimeValue(ns3::MilliSeconds(100)),
+                      ns3::MakeTimeAccessor(&DccController::m_interval),
+                      ns3::MakeTimeChecker(ns3::MilliSeconds(1)))
+        .AddAttribute("TargetCbr",
+                      "Channel busy ratio the adaptive approach converges to",
+                      ns3::DoubleValue(0.68),
+                      ns3::MakeDoubleAccessor(&DccController::m_targetCbr),
+                      ns3::MakeDoubleChecker<double>(0.0, 1.0))
+        .AddAttribute("DataRate",
+                      "PHY rate used to estimate the air time of a frame",
+                      ns3::DataRateValue(ns3::DataRate("6Mbps")),
+                      ns3::MakeDataRateAccessor(&DccController::m_dataRate),
+                      ns3::MakeDataRateChecker())
+        .AddAttribute("FrameOverhead",
+                      "Air time of the preamble and MAC overhead of a frame",
+                      ns3::TimeValue(ns3::MicroSeconds(100)),
+                      ns3::MakeTimeAccessor(&DccController::m_frameOverhead),
+                      ns3::MakeTimeChecker(ns3::Seconds(0)));
+    return tid;
+}
+
+void
+DccController::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    
+    if (m_evaluateEvent.IsRunning()) {
+        m_evaluateEvent.Cancel();
+    }
+    m_fastDevices.clear();
+    m_applications.clear();
+    ns3::Object::DoDispose();
+}
+
+uint32_t
+DccController::AddStation(ns3::Ptr<ns3::NetDevice> device, ns3::Ptr<CamApplication> application)
+{
+    NS_LOG_FUNCTION(this << device << application);
+    
+    m_params.cbrTarget = static_cast<float>(m_targetCbr);
+    
+    const uint32_t index = static_cast<uint32_t>(m_states.size());
+    ns3::Ptr<FastLinkNetDevice> fast = ns3::DynamicCast<FastLinkNetDevice>(device);
+    if (fast) {
+        // FastLink devices measure over the channel's window: make it the
+        // measurement interval, or samples would repeat or skip windows
+        ns3::Ptr<FastLinkChannel> channel = ns3::DynamicCast<FastLinkChannel>(fast->GetChannel());
+        ns3::TimeValue window;
+        if (channel) {
+            channel->GetAttribute("CbrWindow", window);
+            if (window.Get() != m_interval) {
+                NS_LOG_INFO("Setting CbrWindow of " << channel << " to the measurement interval " << m_interval);
+                channel->SetAttribute("CbrWindow", ns3::TimeValue(m_interval));
+            }
+        }
+    } else {
+        ns3::Ptr<ns3::WifiNetDevice> wifi = ns3::DynamicCast<ns3::WifiNetDevice>(device);
+        if (wifi && wifi->GetPhy()) {
+            wifi->GetPhy()->GetState()->TraceConnectWithoutContext(
+                "State", ns3::MakeBoundCallback(&NotifyPhyState, this, index));
+        } else {
+            NS_LOG_WARN("Cannot measure the channel busy ratio of device " << device);
+        }
+    }
+    
+    m_fastDevices.push_back(fast);
+    m_applications.push_back(application);
+    m_busy.resize(m_busy.size() + kBusyWindows, 0);
+    m_cbr.push_back(0.0f);
+    m_intervalNs.push_back(-1);
+    m_states.emplace_back();
+    m_states.back().delta = m_params.deltaMax;
+    m_counters.emplace_back();
+    
+    if (!m_evaluateEvent.IsRunning()) {
+        ScheduleEvaluation();
+    }
+    return index;
+}
+
+bool
+DccController::RequestTransmission(uint32_t index, uint32_t bytes)
+{
+    const ns3::Time airtime = m_frameOverhead + m_dataRate.CalculateBytesTxTime(bytes);
+    return requestDccTransmission(m_params, m_mode == ADAPTIVE ? DccMode::Adaptive : DccMode::Reactive,
+                                  m_states[index], m_counters[index],
+                                  ns3::Simulator::Now().GetNanoSeconds(),
+                                  static_cast<uint32_t>(airtime.GetNanoSeconds()));
+}
+
+void
+DccController::ResetStation(uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+    
+    m_states[index] = DccStationState();
+    m_states[index].delta = m_params.deltaMax;
+    m_intervalNs[index] = -1;
+}
+
+void
+DccController::AddBusyTime(uint32_t index, ns3::Time start, ns3::Time duration)
+{
+    const int64_t window = m_interval.GetTimeStep();
+    int64_t from = start.GetTimeStep();
+    const int64_t to = from + duration.GetTimeStep();
+    int64_t* busy = &m_busy[index * kBusyWindows];
+    
+    // Split the period at interval boundaries, intervals already evaluated are skipped
+    while (from < to) {
+        const int64_t w = from / window;
+        const int64_t end = std::min(to, (w + 1) * window);
+        if (w > m_evaluated) {
+            busy[w % kBusyWindows] += end - from;
+        }
+        from = end;
+    }
+}
+
+uint32_t
+DccController::GetNStations() const
+{
+    return static_cast<uint32_t>(m_states.size());
+}
+
+double
+DccController::GetChannelBusyRatio(uint32_t index) const
+{
+    return m_cbr[index];
+}
+
+ns3::Time
+DccController::GetInterval(uint32_t index) const
+{
+    return ns3::NanoSeconds(dccIntervalNs(m_params, m_mode == ADAPTIVE ? DccMode::Adaptive : DccMode::Reactive,
+                                          m_states[index]));
+}
+
+const DccStationState&
+DccController::GetState(uint32_t index) const
+{
+    return m_states[index];
+}
+
+const DccCounters&
+DccController::GetCounters(uint32_t index) const
+{
+    return m_counters[index];
+}
+
+DccCounters
+DccController::GetTotals() const
+{
+    DccCounters totals;
+    for (const DccCounters& counters : m_counters) {
+        totals += counters;
+    }
+    return totals;
+}
+
+void
+DccController::WriteTable(std::ostream& os) const
+{
+    os << "index,state,cbr,meanCbr,delta,intervalMs,allowed,gated,transitions";
+    for (const char* name : kStateNames) {
+        os << ",samples_" << name;
+    }
+    os << "\n";
+    
+    for (uint32_t i = 0; i < m_states.size(); ++i) {
+        const DccStationState& state = m_states[i];
+        const DccCounters& counters = m_counters[i];
+        os << i << ',' << kStateNames[static_cast<std::size_t>(state.state)]
+           << ',' << m_cbr[i]
+           << ',' << (counters.samples ? counters.cbrSum / counters.samples : 0.0)
+           << ',' << (m_mode == ADAPTIVE ? state.delta : 0.0f)
+           << ',' << GetInterval(i).GetMilliSeconds()
+           << ',' << counters.allowed
+           << ',' << counters.gated
+           << ',' << counters.transitions;
+        for (uint64_t samples : counters.samplesInState) {
+            os << ',' << samples;
+        }
+        os << "\n";
+    }
+}
+
+void
+DccController::ScheduleEvaluation()
+{
+    const int64_t window = m_interval.GetTimeStep();
+    const int64_t next = (ns3::Simulator::Now().GetTimeStep() / window + 1) * window;
+    m_evaluateEvent = ns3::Simulator::Schedule(ns3::TimeStep(next) - ns3::Simulator::Now(),
+                                               &DccController::Evaluate, this);
+}
+
+void
+DccController::Evaluate()
+{
+    NS_LOG_FUNCTION(this);
+    
+    const DccMode mode = m_mode == ADAPTIVE ? DccMode::Adaptive : DccMode::Reactive;
+    const int64_t window = m_interval.GetTimeStep();
+    
+    // The interval before the one that just ended is complete: busy periods
+    // are reported when they end, and none is longer than an interval
+    const int64_t evaluate = ns3::Simulator::Now().GetTimeStep() / window - 2;
+    if (evaluate < 0) {
+        ScheduleEvaluation();
+        return;
+    }
+    m_evaluated = evaluate;
+    
+    for (uint32_t i = 0; i < m_states.size(); ++i) {
+        float cbr;
+        if (m_fastDevices[i]) {
+            cbr = static_cast<float>(m_fastDevices[i]->GetChannelBusyRatio());
+        } else {
+            int64_t& busy = m_busy[i * kBusyWindows + evaluate % kBusyWindows];
+            cbr = std::min(1.0f, static_cast<float>(busy) / window);
+            busy = 0;
+        }
+        m_cbr[i] = cbr;
+        updateDcc(m_params, mode, m_states[i], m_counters[i], cbr);
+    
+        // Generation follows the gate, only tell the application about changes
+        const int64_t intervalNs = dccIntervalNs(m_params, mode, m_states[i]);
+        if (intervalNs != m_intervalNs[i]) {
+            m_intervalNs[i] = intervalNs;
+            if (m_applications[i]) {
+                m_applications[i]->SetGenCamDcc(ns3::NanoSeconds(intervalNs));
+            }
+        }
+    }
+    
+    ScheduleEvaluation();
+}
+
+} // namespace vanetza_ns3
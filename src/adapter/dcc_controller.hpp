@@ -0,0 +1,194 @@
+#ifndef DCC_CONTROLLER_HPP
+#define DCC_CONTROLLER_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include <ns3/object.h>
+#include <ns3/event-id.h>
+#include <ns3/nstime.h>
+#include <ns3/ptr.h>
+#include <ns3/data-rate.h>
+
+#include "dcc_control.hpp"
+
+namespace ns3 {
+    class NetDevice;
+}
+
+namespace vanetza_ns3 {
+
+// Forward declarations
+class CamApplication;
+class FastLinkNetDevice;
+
+/**
+ * @brief Decentralized congestion control of all stations of a scenario
+ *
+ * Measures the channel busy ratio (CBR) of every station once per
+ * MeasurementInterval and runs the reactive or the adaptive (LIMERIC)
+ * approach of ETSI TS 102 687 on it. Wi-Fi stations are measured from the
+ * WifiPhy State trace: TX, RX and CCA_BUSY periods are summed per interval,
+ * and an interval is evaluated one interval late so that the periods still
+ * in progress at its end are complete. FastLink stations report the CBR
+ * of their device; AddStation() sets the CbrWindow of their channel to
+ * the MeasurementInterval so that every evaluation sees one new window.
+ *
+ * The resulting packet interval gates the station's transmissions through
+ * RequestTransmission() and is handed to its CAM application as
+ * T_GenCam_DCC. One event evaluates all stations; the per-station state
+ * and counters are kept in arrays indexed by station.
+ */
+class DccController : public ns3::Object {
+public:
+    /**
+     * @brief The DCC approach
+     */
+    enum Mode {
+        REACTIVE,   ///< Five-state machine
+        ADAPTIVE    ///< LIMERIC
+    };
+
+    /**
+     * @brief Constructor
+     */
+    DccController();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~DccController();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    /**
+     * @brief Put a station under congestion control
+     * @param device The station's device, a WifiNetDevice or FastLinkNetDevice
+     * @param application The CAM application receiving T_GenCam_DCC, may be nullptr
+     * @return The index of the station
+     */
+    uint32_t AddStation(ns3::Ptr<ns3::NetDevice> device, ns3::Ptr<CamApplication> application);
+
+    /**
+     * @brief Ask whether a station may transmit a frame now
+     *
+     * Records the transmission if it may.
+     * @param index The station index
+     * @param bytes The size of the frame
+     * @return True if the frame may be sent, false if DCC holds it back
+     */
+    bool RequestTransmission(uint32_t index, uint32_t bytes);
+
+    /**
+     * @brief Forget the DCC state of a station whose slot is reused by another vehicle
+     * 
+     * The counters are kept, they add up over all vehicles of the slot.
+     * @param index The station index
+     */
+    void ResetStation(uint32_t index);
+
+    /**
+     * @brief Account a busy period of a station's channel
+     *
+     * Called from the WifiPhy State trace; periods may span several
+     * measurement intervals.
+     * @param index The station index
+     * @param start The start of the period
+     * @param duration The length of the period
+     */
+    void AddBusyTime(uint32_t index, ns3::Time start, ns3::Time duration);
+
+    /**
+     * @brief Get the number of stations
+     * @return The number of stations
+     */
+    uint32_t GetNStations() const;
+
+    /**
+     * @brief Get the last CBR sample of a station
+     * @param index The station index
+     * @return The busy ratio between 0 and 1
+     */
+    double GetChannelBusyRatio(uint32_t index) const;
+
+    /**
+     * @brief Get the current packet interval of a station
+     * @param index The station index
+     * @return The minimum time between two transmissions
+     */
+    ns3::Time GetInterval(uint32_t index) const;
+
+    /**
+     * @brief Get the DCC state of a station
+     * @param index The station index
+     * @return The state
+     */
+    const DccStationState& GetState(uint32_t index) const;
+
+    /**
+     * @brief Get the DCC counters of a station
+     * @param index The station index
+     * @return The counters
+     */
+    const DccCounters& GetCounters(uint32_t index) const;
+
+    /**
+     * @brief Get the sum of the counters of all stations
+     * @return The totals
+     */
+    DccCounters GetTotals() const;
+
+    /**
+     * @brief Write one CSV row per station
+     * @param os The output stream
+     */
+    void WriteTable(std::ostream& os) const;
+
+protected:
+    /**
+     * @brief Dispose of the controller and cancel the pending evaluation
+     */
+    virtual void DoDispose() override;
+
+private:
+    static constexpr std::size_t kBusyWindows = 4;  ///< Measurement intervals accumulated per station
+
+    /**
+     * @brief Evaluate the CBR of all stations and update their DCC
+     */
+    void Evaluate();
+
+    /**
+     * @brief Schedule the next evaluation at the next interval boundary
+     */
+    void ScheduleEvaluation();
+
+    // Configuration
+    Mode m_mode;                                   ///< DCC approach
+    ns3::Time m_interval;                          ///< CBR measurement interval
+    ns3::DataRate m_dataRate;                      ///< PHY rate used to estimate the air time
+    ns3::Time m_frameOverhead;                     ///< Preamble and MAC overhead of a frame
+    double m_targetCbr;                            ///< Target CBR of the adaptive approach
+    DccParameters m_params;                        ///< Parameters of both approaches
+
+    // Stations (indexed by station)
+    std::vector<ns3::Ptr<FastLinkNetDevice> > m_fastDevices;  ///< FastLink devices, nullptr for Wi-Fi
+    std::vector<ns3::Ptr<CamApplication> > m_applications;   ///< CAM applications, may be nullptr
+    std::vector<int64_t> m_busy;                   ///< Busy time steps, kBusyWindows per station
+    std::vector<float> m_cbr;                      ///< Last CBR sample
+    std::vector<int64_t> m_intervalNs;             ///< Packet interval handed to the application
+    std::vector<DccStationState> m_states;         ///< DCC state
+    std::vector<DccCounters> m_counters;           ///< DCC counters
+
+    // Scheduling state
+    ns3::EventId m_evaluateEvent;                  ///< Pending evaluation
+    int64_t m_evaluated;                           ///< Last evaluated measurement interval, -1 if none
+};
+
+} // namespace vanetza_ns3
+
+#endif // DCC_CONTROLLER_HPP
@@ -0,0 +1,313 @@
+#include "fast_link_channel.hpp"
+#include "fast_link_net_device.hpp"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/node.h>
+#include <ns3/packet.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/string.h>
+#include <ns3/uinteger.h>
+#include <ns3/random-variable-stream.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("FastLinkChannel");
+
+NS_OBJECT_ENSURE_REGISTERED(FastLinkChannel);
+
+namespace {
+
+const double kSpeedOfLight = 299792458.0;
+
+} // namespace
+
+FastLinkChannel::FastLinkChannel() :
+    m_dataRate("6Mbps"),
+    m_overheadBytes(60),
+    m_cbrFeedback(false),
+    m_cbrLossFactor(1.0),
+    m_cbrWindow(ns3::MilliSeconds(100)),
+    m_refreshInterval(ns3::MilliSeconds(100)),
+    m_positionSlack(10.0),
+    m_binWidth(10.0),
+    m_lastRefresh(ns3::Seconds(0)),
+    m_stale(true),
+    m_random(ns3::CreateObject<ns3::UniformRandomVariable>())
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FastLinkChannel::~FastLinkChannel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ns3::TypeId
+FastLinkChannel::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::FastLinkChannel")
+        .SetParent<ns3::Channel>()
+        .SetGroupName("VANET")
+        .AddConstructor<FastLinkChannel>()
+        .AddAttribute("PdrCurve",
+                      "Packet delivery ratio over distance as 'meters:pdr' points; zero beyond the last point",
+                      ns3::StringValue("0:1.0,100:0.98,200:0.9,300:0.7,400:0.4,500:0.15,600:0.0"),
+                      ns3::MakeStringAccessor(&FastLinkChannel::SetPdrCurve,
+                                              &FastLinkChannel::GetPdrCurve),
+                      ns3::MakeStringChecker())
+        .AddAttribute("DataRate",
+                      "Rate used to compute the airtime of a frame",
+                      ns3::DataRateValue(ns3::DataRate("6Mbps")),
+                      ns3::MakeDataRateAccessor(&FastLinkChannel::m_dataRate),
+                      ns3::MakeDataRateChecker())
+        .AddAttribute("OverheadBytes",
+                      "MAC and PHY overhead added to every frame for the airtime",
+                      ns3::UintegerValue(60),
+                      ns3::MakeUintegerAccessor(&FastLinkChannel::m_overheadBytes),
+                      ns3::MakeUintegerChecker<uint32_t>())
+        .AddAttribute("CbrFeedback",
+                      "Reduce the delivery ratio with the receiver's channel busy ratio",
+                      ns3::BooleanValue(false),
+                      ns3::MakeBooleanAccessor(&FastLinkChannel::m_cbrFeedback),
+                      ns3::MakeBooleanChecker())
+        .AddAttribute("CbrLossFactor",
+                      "With CbrFeedback, the delivery ratio is scaled by 1 - factor * CBR",
+                      ns3::DoubleValue(1.0),
+                      ns3::MakeDoubleAccessor(&FastLinkChannel::m_cbrLossFactor),
+                      ns3::MakeDoubleChecker<double>(0.0))
+        .AddAttribute("CbrWindow",
+                      "Measurement window of the channel busy ratio",
+                      ns3::TimeValue(ns3::MilliSeconds(100)),
+                      ns3::MakeTimeAccessor(&FastLinkChannel::m_cbrWindow),
+                      ns3::MakeTimeChecker(ns3::MilliSeconds(1)))
+        .AddAttribute("PositionRefreshInterval",
+                      "Maximum age of the device positions used to find receivers",
+                      ns3::TimeValue(ns3::MilliSeconds(100)),
+                      ns3::MakeTimeAccessor(&FastLinkChannel::m_refreshInterval),
+                      ns3::MakeTimeChecker())
+        .AddAttribute("PositionSlack",
+                      "Distance (in meters) a node may move between two position refreshes",
+                      ns3::DoubleValue(10.0),
+                      ns3::MakeDoubleAccessor(&FastLinkChannel::m_positionSlack),
+                      ns3::MakeDoubleChecker<double>(0.0))
+        .AddAttribute("ValidationBinWidth",
+                      "Width of the distance bins of the PDR report in meters",
+                      ns3::DoubleValue(10.0),
+                      ns3::MakeDoubleAccessor(&FastLinkChannel::m_binWidth),
+                      ns3::MakeDoubleChecker<double>(1.0));
+    return tid;
+}
+
+void
+FastLinkChannel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_devices.clear();
+    m_mobility.clear();
+    m_random = nullptr;
+    ns3::Channel::DoDispose();
+}
+
+void
+FastLinkChannel::SetPdrCurve(std::string spec)
+{
+    m_curve.clear();
+    std::istringstream in(spec);
+    std::string point;
+    while (std::getline(in, point, ',')) {
+        std::string::size_type colon = point.find(':');
+        if (colon == std::string::npos) {
+            NS_FATAL_ERROR("Malformed PDR curve point '" << point << "', expected meters:pdr");
+        }
+        double distance = std::atof(point.substr(0, colon).c_str());
+        double pdr = std::atof(point.substr(colon + 1).c_str());
+        m_curve.emplace_back(distance, std::min(std::max(pdr, 0.0), 1.0));
+    }
+    if (m_curve.empty()) {
+        NS_FATAL_ERROR("Empty PDR curve");
+    }
+    std::sort(m_curve.begin(), m_curve.end());
+}
+
+std::string
+FastLinkChannel::GetPdrCurve() const
+{
+    std::ostringstream out;
+    for (std::size_t i = 0; i < m_curve.size(); ++i) {
+        out << (i ? "," : "") << m_curve[i].first << ":" << m_curve[i].second;
+    }
+    return out.str();
+}
+
+double
+FastLinkChannel::GetPdr(double distance) const
+{
+    if (distance > m_curve.back().first) {
+        return 0.0;
+    }
+    if (distance <= m_curve.front().first) {
+        return m_curve.front().second;
+    }
+    
+    // Linear interpolation between the enclosing points
+    auto upper = std::lower_bound(m_curve.begin(), m_curve.end(), std::make_pair(distance, -1.0));
+    auto lower = upper - 1;
+    double t = (distance - lower->first) / (upper->first - lower->first);
+    return lower->second + t * (upper->second - lower->second);
+}
+
+void
+FastLinkChannel::Add(ns3::Ptr<FastLinkNetDevice> device)
+{
+    NS_LOG_FUNCTION(this << device);
+    m_devices.push_back(device);
+    m_mobility.push_back(nullptr);
+    m_stale = true;
+}
+
+int64_t
+FastLinkChannel::AssignStreams(int64_t stream)
+{
+    m_random->SetStream(stream);
+    return 1;
+}
+
+std::size_t
+FastLinkChannel::GetNDevices() const
+{
+    return m_devices.size();
+}
+
+ns3::Ptr<ns3::NetDevice>
+FastLinkChannel::GetDevice(std::size_t i) const
+{
+    return m_devices.at(i);
+}
+
+void
+FastLinkChannel::RefreshPositions()
+{
+    ns3::Time now = ns3::Simulator::Now();
+    if (!m_stale && now - m_lastRefresh < m_refreshInterval) {
+        return;
+    }
+    
+    const std::size_t n = m_devices.size();
+    m_x.resize(n);
+    m_y.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!m_mobility[i] && m_devices[i]->GetNode()) {
+            m_mobility[i] = m_devices[i]->GetNode()->GetObject<ns3::MobilityModel>();
+            if (m_mobility[i]) {
+                m_mobility[i]->TraceConnectWithoutContext("CourseChange",
+                    ns3::MakeBoundCallback(&FastLinkChannel::CourseChanged, this, static_cast<uint32_t>(i)));
+            }
+        }
+        ns3::Vector position = m_mobility[i] ? m_mobility[i]->GetPosition() : ns3::Vector();
+        m_x[i] = static_cast<float>(position.x);
+        m_y[i] = static_cast<float>(position.y);
+    }
+    m_grid.setCellSize(std::max(m_curve.back().first, 1.0));
+    m_grid.build(m_x.data(), m_y.data(), n);
+    m_lastRefresh = now;
+    m_stale = false;
+}
+
+void
+FastLinkChannel::CourseChanged(FastLinkChannel* channel, uint32_t index,
+                               ns3::Ptr<const ns3::MobilityModel> mobility)
+{
+    if (channel->m_stale || index >= channel->m_x.size()) {
+        return;
+    }
+    const ns3::Vector position = mobility->GetPosition();
+    const double dx = position.x - channel->m_x[index];
+    const double dy = position.y - channel->m_y[index];
+    if (dx * dx + dy * dy > channel->m_positionSlack * channel->m_positionSlack) {
+        NS_LOG_LOGIC("Node " << index << " moved beyond the slack, grid invalidated");
+        channel->m_stale = true;
+    }
+}
+
+void
+FastLinkChannel::Transmit(ns3::Ptr<const ns3::Packet> packet, uint16_t protocol, ns3::Ptr<FastLinkNetDevice> sender)
+{
+    NS_LOG_FUNCTION(this << packet << protocol << sender);
+    
+    ns3::Ptr<ns3::MobilityModel> txMobility = sender->GetNode()->GetObject<ns3::MobilityModel>();
+    if (!txMobility) {
+        NS_LOG_WARN("Sender without mobility model, frame dropped");
+        return;
+    }
+    RefreshPositions();
+    
+    const ns3::Time airtime = m_dataRate.CalculateBytesTxTime(packet->GetSize() + m_overheadBytes);
+    const ns3::Mac48Address from = ns3::Mac48Address::ConvertFrom(sender->GetAddress());
+    const double range = m_curve.back().first;
+    sender->AddBusyTime(airtime, m_cbrWindow);
+    
+    const ns3::Vector txPosition = txMobility->GetPosition();
+    m_candidates.clear();
+    m_grid.forEachWithin(static_cast<float>(txPosition.x), static_cast<float>(txPosition.y),
+                         static_cast<float>(range + 2.0 * m_positionSlack),
+                         [this](uint32_t i, float) { m_candidates.push_back(i); });
+    
+    for (uint32_t i : m_candidates) {
+        const ns3::Ptr<FastLinkNetDevice>& receiver = m_devices[i];
+        if (receiver == sender || !m_mobility[i]) {
+            continue;
+        }
+        const double distance = m_mobility[i]->GetDistanceFrom(txMobility);
+        if (distance > range) {
+            continue;
+        }
+        
+        double pdr = GetPdr(distance);
+        if (m_cbrFeedback) {
+            pdr *= std::max(0.0, 1.0 - m_cbrLossFactor * receiver->GetChannelBusyRatio());
+        }
+        receiver->AddBusyTime(airtime, m_cbrWindow);
+        
+        const std::size_t bin = static_cast<std::size_t>(distance / m_binWidth);
+        if (bin >= m_offered.size()) {
+            m_offered.resize(bin + 1, 0);
+            m_delivered.resize(bin + 1, 0);
+        }
+        ++m_offered[bin];
+        if (m_random->GetValue() >= pdr) {
+            continue;
+        }
+        ++m_delivered[bin];
+        
+        // Receivers share the transmitted packet, it is never modified
+        const ns3::Time delay = airtime + ns3::Seconds(distance / kSpeedOfLight);
+        ns3::Simulator::ScheduleWithContext(receiver->GetNode()->GetId(), delay,
+                                            &FastLinkNetDevice::Receive, receiver,
+                                            packet, protocol, from);
+    }
+}
+
+void
+FastLinkChannel::WritePdrReport(std::ostream& os) const
+{
+    os << "# distance_m configured_pdr observed_pdr offered delivered" << std::endl;
+    for (std::size_t bin = 0; bin < m_offered.size(); ++bin) {
+        if (m_offered[bin] == 0) {
+            continue;
+        }
+        const double center = (bin + 0.5) * m_binWidth;
+        os << std::fixed << std::setprecision(1) << center << " "
+           << std::setprecision(4) << GetPdr(center) << " "
+           << static_cast<double>(m_delivered[bin]) / m_offered[bin] << " "
+           << m_offered[bin] << " " << m_delivered[bin] << std::endl;
+    }
+}
+
+} // namespace vanetza_ns3
@@ -0,0 +1,167 @@
+#ifndef FAST_LINK_CHANNEL_HPP
+#define FAST_LINK_CHANNEL_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ns3/channel.h>
+#include <ns3/data-rate.h>
+#include <ns3/mobility-model.h>
+#include <ns3/nstime.h>
+#include <ns3/ptr.h>
+
+#include "utils/uniform_grid.hpp"
+
+namespace ns3 {
+    class Packet;
+    class UniformRandomVariable;
+}
+
+namespace vanetza_ns3 {
+
+// Forward declarations
+class FastLinkNetDevice;
+
+/**
+ * @brief Abstract broadcast channel driven by a PDR-vs-distance curve
+ * 
+ * Each transmission is offered to every attached FastLinkNetDevice within
+ * the range of the PDR curve. A receiver gets the frame with the
+ * probability given by the curve at its distance, after the frame's
+ * airtime plus propagation delay. No per-packet PHY or MAC objects are
+ * created and receivers share the transmitted packet. With CbrFeedback
+ * enabled the delivery probability is further reduced by the channel busy
+ * ratio the receiver measured in the last window.
+ * 
+ * Candidates come from a grid over the device positions, refreshed at most
+ * once per PositionRefreshInterval. A CourseChange that leaves a node more
+ * than PositionSlack away from its grid position invalidates the grid at
+ * once, so teleported or reactivated vehicles are never looked up in their
+ * old cell.
+ * 
+ * For validation the channel counts offered and delivered frames per
+ * distance bin, which WritePdrReport prints next to the configured curve.
+ * The end-to-end comparison with the Wi-Fi stack is the pdrReport mode of
+ * the CAM example, which runs both link models side by side.
+ */
+class FastLinkChannel : public ns3::Channel {
+public:
+    /**
+     * @brief Constructor
+     */
+    FastLinkChannel();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~FastLinkChannel();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    /**
+     * @brief Attach a device (called by FastLinkNetDevice::SetChannel)
+     * @param device The device
+     */
+    void Add(ns3::Ptr<FastLinkNetDevice> device);
+
+    /**
+     * @brief Broadcast a frame from one of the attached devices
+     * @param packet The frame
+     * @param protocol The protocol number
+     * @param sender The sending device
+     */
+    void Transmit(ns3::Ptr<const ns3::Packet> packet, uint16_t protocol, ns3::Ptr<FastLinkNetDevice> sender);
+
+    /**
+     * @brief Get the delivery probability of the configured curve
+     * @param distance The distance in meters
+     * @return The packet delivery ratio between 0 and 1
+     */
+    double GetPdr(double distance) const;
+
+    /**
+     * @brief Write configured and observed PDR per distance bin
+     * @param os The output stream
+     */
+    void WritePdrReport(std::ostream& os) const;
+
+    /**
+     * @brief Assign a fixed random stream to the delivery decisions
+     * @param stream The first stream index
+     * @return The number of streams used
+     */
+    int64_t AssignStreams(int64_t stream);
+
+    // Channel interface
+    virtual std::size_t GetNDevices() const override;
+    virtual ns3::Ptr<ns3::NetDevice> GetDevice(std::size_t i) const override;
+
+protected:
+    /**
+     * @brief Dispose of the channel
+     */
+    virtual void DoDispose() override;
+
+private:
+    /**
+     * @brief Parse a curve specification of the form "d0:p0,d1:p1,..."
+     * @param spec The curve specification
+     */
+    void SetPdrCurve(std::string spec);
+
+    /**
+     * @brief Get the curve specification
+     * @return The curve specification
+     */
+    std::string GetPdrCurve() const;
+
+    /**
+     * @brief Refresh the device grid if positions are outdated
+     */
+    void RefreshPositions();
+
+    /**
+     * @brief Invalidate the grid if a node left its grid position
+     * @param channel The channel
+     * @param index The index of the node's device
+     * @param mobility The mobility model that changed course
+     */
+    static void CourseChanged(FastLinkChannel* channel, uint32_t index,
+                              ns3::Ptr<const ns3::MobilityModel> mobility);
+
+    // Configuration
+    std::vector<std::pair<double, double> > m_curve;  ///< (distance, PDR) points, sorted by distance
+    ns3::DataRate m_dataRate;                ///< Rate used for the airtime of a frame
+    uint32_t m_overheadBytes;                ///< MAC/PHY overhead added to each frame
+    bool m_cbrFeedback;                      ///< Scale PDR with the receiver's busy ratio
+    double m_cbrLossFactor;                  ///< PDR *= 1 - factor * CBR
+    ns3::Time m_cbrWindow;                   ///< Busy ratio measurement window
+    ns3::Time m_refreshInterval;             ///< Maximum age of the device grid
+    double m_positionSlack;                  ///< Tolerated movement between refreshes in meters
+    double m_binWidth;                       ///< Width of the validation bins in meters
+
+    // Devices
+    std::vector<ns3::Ptr<FastLinkNetDevice> > m_devices;       ///< Attached devices
+    std::vector<ns3::Ptr<ns3::MobilityModel> > m_mobility;     ///< Mobility of each device
+    std::vector<float> m_x;                  ///< X positions at the last refresh
+    std::vector<float> m_y;                  ///< Y positions at the last refresh
+    utils::UniformGrid m_grid;               ///< Grid over the device positions
+    ns3::Time m_lastRefresh;                 ///< Time of the last refresh
+    bool m_stale;                            ///< Devices were added or moved beyond the slack since the last refresh
+    std::vector<uint32_t> m_candidates;      ///< Per-transmission scratch
+    ns3::Ptr<ns3::UniformRandomVariable> m_random;  ///< Delivery decisions
+
+    // Validation counters per distance bin
+    std::vector<uint64_t> m_offered;         ///< Frames offered to receivers in the bin
+    std::vector<uint64_t> m_delivered;       ///< Frames delivered to receivers in the bin
+};
+
+} // namespace vanetza_ns3
+
+#endif // FAST_LINK_CHANNEL_HPP
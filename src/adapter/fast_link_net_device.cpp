@@ -0,0 +1,288 @@
+#include "fast_link_net_device.hpp"
+#include "fast_link_channel.hpp"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/node.h>
+#include <ns3/packet.h>
+#include <ns3/uinteger.h>
+
+#include <algorithm>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("FastLinkNetDevice");
+
+NS_OBJECT_ENSURE_REGISTERED(FastLinkNetDevice);
+
+FastLinkNetDevice::FastLinkNetDevice() :
+    m_node(nullptr),
+    m_channel(nullptr),
+    m_ifIndex(0),
+    m_mtu(2304),
+    m_windowStart(ns3::Seconds(0)),
+    m_windowLength(ns3::Seconds(0)),
+    m_busyCurrent(ns3::Seconds(0)),
+    m_busyCarry(ns3::Seconds(0)),
+    m_lastCbr(0.0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FastLinkNetDevice::~FastLinkNetDevice()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ns3::TypeId
+FastLinkNetDevice::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::FastLinkNetDevice")
+        .SetParent<ns3::NetDevice>()
+        .SetGroupName("VANET")
+        .AddConstructor<FastLinkNetDevice>()
+        .AddAttribute("Mtu",
+                      "Maximum transmission unit in bytes",
+                      ns3::UintegerValue(2304),
+                      ns3::MakeUintegerAccessor(&FastLinkNetDevice::SetMtu,
+                                                &FastLinkNetDevice::GetMtu),
+                      ns3::MakeUintegerChecker<uint16_t>());
+    return tid;
+}
+
+void
+FastLinkNetDevice::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_node = nullptr;
+    m_channel = nullptr;
+    m_rxCallback.Nullify();
+    m_promiscCallback.Nullify();
+    ns3::NetDevice::DoDispose();
+}
+
+void
+FastLinkNetDevice::SetChannel(ns3::Ptr<FastLinkChannel> channel)
+{
+    NS_LOG_FUNCTION(this << channel);
+    m_channel = channel;
+    m_channel->Add(this);
+}
+
+void
+FastLinkNetDevice::Receive(ns3::Ptr<const ns3::Packet> packet, uint16_t protocol, ns3::Mac48Address from)
+{
+    NS_LOG_FUNCTION(this << packet << protocol << from);
+    
+    if (!m_promiscCallback.IsNull()) {
+        m_promiscCallback(this, packet, protocol, from, GetBroadcast(), ns3::NetDevice::PACKET_BROADCAST);
+    }
+    if (!m_rxCallback.IsNull()) {
+        m_rxCallback(this, packet, protocol, from);
+    }
+}
+
+void
+FastLinkNetDevice::RollWindow(ns3::Time window) const
+{
+    const ns3::Time now = ns3::Simulator::Now();
+    if (m_windowLength != window) {
+        // First use, or the channel changed its window: start over
+        m_windowLength = window;
+        m_windowStart = now;
+        m_busyCurrent = ns3::Seconds(0);
+        m_busyCarry = ns3::Seconds(0);
+        return;
+    }
+    
+    unsigned closed = 0;
+    while (now >= m_windowStart + m_windowLength) {
+        if (++closed > 2) {
+            // Idle for several windows: nothing left to carry over
+            m_lastCbr = 0.0;
+            m_windowStart = now;
+            m_busyCurrent = ns3::Seconds(0);
+            m_busyCarry = ns3::Seconds(0);
+            return;
+        }
+        m_lastCbr = std::min(1.0, m_busyCurrent.GetSeconds() / m_windowLength.GetSeconds());
+        m_busyCurrent = std::min(m_busyCarry, m_windowLength);
+        m_busyCarry = std::max(m_busyCarry - m_windowLength, ns3::Seconds(0));
+        m_windowStart += m_windowLength;
+    }
+}
+
+void
+FastLinkNetDevice::AddBusyTime(ns3::Time airtime, ns3::Time window)
+{
+    RollWindow(window);
+    
+    ns3::Time remaining = m_windowStart + m_windowLength - ns3::Simulator::Now();
+    ns3::Time inWindow = std::min(airtime, remaining);
+    m_busyCurrent += inWindow;
+    m_busyCarry += airtime - inWindow;
+}
+
+double
+FastLinkNetDevice::GetChannelBusyRatio() const
+{
+    if (!m_windowLength.IsZero()) {
+        RollWindow(m_windowLength);
+    }
+    return m_lastCbr;
+}
+
+void
+FastLinkNetDevice::SetIfIndex(const uint32_t index)
+{
+    m_ifIndex = index;
+}
+
+uint32_t
+FastLinkNetDevice::GetIfIndex() const
+{
+    return m_ifIndex;
+}
+
+ns3::Ptr<ns3::Channel>
+FastLinkNetDevice::GetChannel() const
+{
+    return m_channel;
+}
+
+void
+FastLinkNetDevice::SetAddress(ns3::Address address)
+{
+    m_address = ns3::Mac48Address::ConvertFrom(address);
+}
+
+ns3::Address
+FastLinkNetDevice::GetAddress() const
+{
+    return m_address;
+}
+
+bool
+FastLinkNetDevice::SetMtu(const uint16_t mtu)
+{
+    m_mtu = mtu;
+    return true;
+}
+
+uint16_t
+FastLinkNetDevice::GetMtu() const
+{
+    return m_mtu;
+}
+
+bool
+FastLinkNetDevice::IsLinkUp() const
+{
+    return m_channel != nullptr;
+}
+
+void
+FastLinkNetDevice::AddLinkChangeCallback(ns3::Callback<void> /* callback */)
+{
+    // The link never changes state
+}
+
+bool
+FastLinkNetDevice::IsBroadcast() const
+{
+    return true;
+}
+
+ns3::Address
+FastLinkNetDevice::GetBroadcast() const
+{
+    return ns3::Mac48Address::GetBroadcast();
+}
+
+bool
+FastLinkNetDevice::IsMulticast() const
+{
+    return false;
+}
+
+ns3::Address
+FastLinkNetDevice::GetMulticast(ns3::Ipv4Address multicastGroup) const
+{
+    return ns3::Mac48Address::GetMulticast(multicastGroup);
+}
+
+ns3::Address
+FastLinkNetDevice::GetMulticast(ns3::Ipv6Address addr) const
+{
+    return ns3::Mac48Address::GetMulticast(addr);
+}
+
+bool
+FastLinkNetDevice::IsBridge() const
+{
+    return false;
+}
+
+bool
+FastLinkNetDevice::IsPointToPoint() const
+{
+    return false;
+}
+
+bool
+FastLinkNetDevice::Send(ns3::Ptr<ns3::Packet> packet, const ns3::Address& dest, uint16_t protocolNumber)
+{
+    NS_LOG_FUNCTION(this << packet << dest << protocolNumber);
+    
+    // Every frame is broadcast to all receivers in range
+    if (!m_channel || packet->GetSize() > m_mtu) {
+        return false;
+    }
+    m_channel->Transmit(packet, protocolNumber, this);
+    return true;
+}
+
+bool
+FastLinkNetDevice::SendFrom(ns3::Ptr<ns3::Packet> packet, const ns3::Address& /* source */,
+                            const ns3::Address& dest, uint16_t protocolNumber)
+{
+    return Send(packet, dest, protocolNumber);
+}
+
+ns3::Ptr<ns3::Node>
+FastLinkNetDevice::GetNode() const
+{
+    return m_node;
+}
+
+void
+FastLinkNetDevice::SetNode(ns3::Ptr<ns3::Node> node)
+{
+    m_node = node;
+}
+
+bool
+FastLinkNetDevice::NeedsArp() const
+{
+    return false;
+}
+
+void
+FastLinkNetDevice::SetReceiveCallback(ns3::NetDevice::ReceiveCallback cb)
+{
+    m_rxCallback = cb;
+}
+
+void
+FastLinkNetDevice::SetPromiscReceiveCallback(ns3::NetDevice::PromiscReceiveCallback cb)
+{
+    m_promiscCallback = cb;
+}
+
+bool
+FastLinkNetDevice::SupportsSendFrom() const
+{
+    return false;
+}
+
+} // namespace vanetza_ns3
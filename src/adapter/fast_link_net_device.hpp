@@ -0,0 +1,127 @@
+#ifndef FAST_LINK_NET_DEVICE_HPP
+#define FAST_LINK_NET_DEVICE_HPP
+
+#include <cstdint>
+#include <ns3/net-device.h>
+#include <ns3/mac48-address.h>
+#include <ns3/nstime.h>
+#include <ns3/ptr.h>
+
+namespace vanetza_ns3 {
+
+// Forward declarations
+class FastLinkChannel;
+
+/**
+ * @brief Lightweight broadcast NetDevice for abstract link models
+ * 
+ * The device has no MAC or PHY state machine. Frames handed to Send are
+ * passed to the attached FastLinkChannel, which decides per receiver from
+ * a PDR-vs-distance curve whether the frame arrives. The device also keeps
+ * the channel busy ratio it observed over the channel's measurement window.
+ * It plugs into VanetzaNS3Adapter::SetDevice like any other NetDevice.
+ */
+class FastLinkNetDevice : public ns3::NetDevice {
+public:
+    /**
+     * @brief Constructor
+     */
+    FastLinkNetDevice();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~FastLinkNetDevice();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    /**
+     * @brief Attach the device to a channel
+     * @param channel The channel
+     */
+    void SetChannel(ns3::Ptr<FastLinkChannel> channel);
+
+    /**
+     * @brief Deliver a frame received from the channel
+     * @param packet The received frame
+     * @param protocol The protocol number
+     * @param from The address of the sender
+     */
+    void Receive(ns3::Ptr<const ns3::Packet> packet, uint16_t protocol, ns3::Mac48Address from);
+
+    /**
+     * @brief Account channel activity seen by this device
+     * @param airtime Duration of the activity starting now
+     * @param window The measurement window of the channel
+     */
+    void AddBusyTime(ns3::Time airtime, ns3::Time window);
+
+    /**
+     * @brief Get the channel busy ratio of the last complete window
+     * @return The busy ratio between 0 and 1
+     */
+    double GetChannelBusyRatio() const;
+
+    // NetDevice interface
+    virtual void SetIfIndex(const uint32_t index) override;
+    virtual uint32_t GetIfIndex() const override;
+    virtual ns3::Ptr<ns3::Channel> GetChannel() const override;
+    virtual void SetAddress(ns3::Address address) override;
+    virtual ns3::Address GetAddress() const override;
+    virtual bool SetMtu(const uint16_t mtu) override;
+    virtual uint16_t GetMtu() const override;
+    virtual bool IsLinkUp() const override;
+    virtual void AddLinkChangeCallback(ns3::Callback<void> callback) override;
+    virtual bool IsBroadcast() const override;
+    virtual ns3::Address GetBroadcast() const override;
+    virtual bool IsMulticast() const override;
+    virtual ns3::Address GetMulticast(ns3::Ipv4Address multicastGroup) const override;
+    virtual ns3::Address GetMulticast(ns3::Ipv6Address addr) const override;
+    virtual bool IsBridge() const override;
+    virtual bool IsPointToPoint() const override;
+    virtual bool Send(ns3::Ptr<ns3::Packet> packet, const ns3::Address& dest, uint16_t protocolNumber) override;
+    virtual bool SendFrom(ns3::Ptr<ns3::Packet> packet, const ns3::Address& source,
+                          const ns3::Address& dest, uint16_t protocolNumber) override;
+    virtual ns3::Ptr<ns3::Node> GetNode() const override;
+    virtual void SetNode(ns3::Ptr<ns3::Node> node) override;
+    virtual bool NeedsArp() const override;
+    virtual void SetReceiveCallback(ns3::NetDevice::ReceiveCallback cb) override;
+    virtual void SetPromiscReceiveCallback(ns3::NetDevice::PromiscReceiveCallback cb) override;
+    virtual bool SupportsSendFrom() const override;
+
+protected:
+    /**
+     * @brief Dispose of the device
+     */
+    virtual void DoDispose() override;
+
+private:
+    /**
+     * @brief Close measurement windows that ended before now
+     * @param window The measurement window of the channel
+     */
+    void RollWindow(ns3::Time window) const;
+
+    ns3::Ptr<ns3::Node> m_node;                     ///< The node of this device
+    ns3::Ptr<FastLinkChannel> m_channel;            ///< The attached channel
+    ns3::Mac48Address m_address;                    ///< The MAC address
+    uint32_t m_ifIndex;                             ///< Interface index
+    uint16_t m_mtu;                                 ///< Maximum transmission unit
+    ns3::NetDevice::ReceiveCallback m_rxCallback;   ///< Receive callback
+    ns3::NetDevice::PromiscReceiveCallback m_promiscCallback; ///< Promiscuous receive callback
+
+    // Channel busy ratio measurement
+    mutable ns3::Time m_windowStart;                ///< Start of the current window
+    mutable ns3::Time m_windowLength;               ///< Length of the measurement window
+    mutable ns3::Time m_busyCurrent;                ///< Busy time in the current window
+    mutable ns3::Time m_busyCarry;                  ///< Busy time spilling into the next window
+    mutable double m_lastCbr;                       ///< Busy ratio of the last complete window
+};
+
+} // namespace vanetza_ns3
+
+#endif // FAST_LINK_NET_DEVICE_HPP
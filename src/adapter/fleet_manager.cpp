@@ -0,0 +1,170 @@
+#include "fleet_manager.hpp"
+#include "vanetza_ns3_adapter.hpp"
+#include "cam_application.hpp"
+
+#include <ns3/log.h>
+#include <ns3/mobility-model.h>
+
+#include <algorithm>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("FleetManager");
+
+NS_OBJECT_ENSURE_REGISTERED(FleetManager);
+
+FleetManager::FleetManager() :
+    m_parkingPosition(-100000.0, -100000.0, 0.0),
+    m_peakActive(0),
+    m_activations(0),
+    m_rejected(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FleetManager::~FleetManager()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ns3::TypeId
+FleetManager::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::FleetManager")
+        .SetParent<ns3::Object>()
+        .SetGroupName("VANET")
+        .AddConstructor<FleetManager>()
+        .AddAttribute("ParkingPosition",
+                      "Position of the nodes of inactive slots, out of radio range of the scenario",
+                      ns3::VectorValue(ns3::Vector(-100000.0, -100000.0, 0.0)),
+                      ns3::MakeVectorAccessor(&FleetManager::m_parkingPosition),
+                      ns3::MakeVectorChecker());
+    return tid;
+}
+
+void
+FleetManager::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    
+    // The applications are not owned by their nodes, dispose of them here
+    for (Slot& slot : m_slots) {
+        slot.application->Dispose();
+        slot.adapter->Dispose();
+    }
+    m_slots.clear();
+    m_free.clear();
+    m_active.clear();
+    ns3::Object::DoDispose();
+}
+
+uint32_t
+FleetManager::AddSlot(ns3::Ptr<ns3::Node> node, ns3::Ptr<VanetzaNS3Adapter> adapter,
+                      ns3::Ptr<CamApplication> application)
+{
+    NS_LOG_FUNCTION(this << node << adapter << application);
+    
+    // Bound to the node without Node::AddApplication, which would start them
+    adapter->SetNode(node);
+    application->SetNode(node);
+    
+    const uint32_t index = static_cast<uint32_t>(m_slots.size());
+    m_slots.push_back(Slot{node, adapter, application});
+    Park(m_slots.back());
+    m_free.push_back(index);
+    return index;
+}
+
+ns3::Ptr<ns3::Node>
+FleetManager::Activate(uint32_t stationId)
+{
+    NS_LOG_FUNCTION(this << stationId);
+    NS_ASSERT_MSG(m_active.count(stationId) == 0, "Station " << stationId << " is already active");
+    
+    if (m_free.empty()) {
+        NS_LOG_WARN("No free slot for station " << stationId);
+        ++m_rejected;
+        return nullptr;
+    }
+    
+    // Reuse the most recently freed slot, its memory is the most likely to be cached
+    const uint32_t index = m_free.back();
+    m_free.pop_back();
+    m_active.emplace(stationId, index);
+    
+    const Slot& slot = m_slots[index];
+    slot.adapter->Activate(stationId);
+    slot.application->Activate(stationId);
+    
+    ++m_activations;
+    m_peakActive = std::max(m_peakActive, GetNActive());
+    return slot.node;
+}
+
+bool
+FleetManager::Deactivate(uint32_t stationId)
+{
+    NS_LOG_FUNCTION(this << stationId);
+    
+    auto found = m_active.find(stationId);
+    if (found == m_active.end()) {
+        return false;
+    }
+    
+    const Slot& slot = m_slots[found->second];
+    slot.application->Deactivate();
+    slot.adapter->Deactivate();
+    Park(slot);
+    
+    m_free.push_back(found->second);
+    m_active.erase(found);
+    return true;
+}
+
+void
+FleetManager::Park(const Slot& slot) const
+{
+    ns3::Ptr<ns3::MobilityModel> mobility = slot.node->GetObject<ns3::MobilityModel>();
+    if (mobility) {
+        mobility->SetPosition(m_parkingPosition);
+    }
+}
+
+ns3::Ptr<ns3::Node>
+FleetManager::GetNode(uint32_t stationId) const
+{
+    auto found = m_active.find(stationId);
+    return found != m_active.end() ? m_slots[found->second].node : nullptr;
+}
+
+uint32_t
+FleetManager::GetNSlots() const
+{
+    return static_cast<uint32_t>(m_slots.size());
+}
+
+uint32_t
+FleetManager::GetNActive() const
+{
+    return static_cast<uint32_t>(m_active.size());
+}
+
+uint32_t
+FleetManager::GetPeakActive() const
+{
+    return m_peakActive;
+}
+
+uint64_t
+FleetManager::GetActivations() const
+{
+    return m_activations;
+}
+
+uint64_t
+FleetManager::GetRejected() const
+{
+    return m_rejected;
+}
+
+} // namespace vanetza_ns3
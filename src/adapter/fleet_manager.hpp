@@ -0,0 +1,147 @@
+#ifndef FLEET_MANAGER_HPP
+#define FLEET_MANAGER_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <ns3/object.h>
+#include <ns3/node.h>
+#include <ns3/vector.h>
+
+namespace vanetza_ns3 {
+
+// Forward declarations
+class VanetzaNS3Adapter;
+class CamApplication;
+
+/**
+ * @brief Pre-sized pool of stations for a changing vehicle population
+ * 
+ * Every slot is a node with its device, mobility model, adapter and CAM
+ * application, built once at setup. The applications are bound to their
+ * node but not added to it, so ns-3 neither starts nor disposes them;
+ * Activate() hands a free slot to an entering vehicle and starts them
+ * under its station ID, Deactivate() stops them and parks the node at
+ * ParkingPosition, out of radio range. Objects, Vanetza stacks and their
+ * arena memory are reused, so vehicles entering and leaving cost no
+ * object construction, attribute initialisation or heap traffic.
+ * 
+ * The station counters of an adapter are kept across its occupants, so
+ * the fleet totals of FleetMetricsCollector include departed vehicles.
+ */
+class FleetManager : public ns3::Object {
+public:
+    /**
+     * @brief Constructor
+     */
+    FleetManager();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~FleetManager();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    /**
+     * @brief Add a slot to the pool
+     * 
+     * The node is parked until the slot is activated.
+     * @param node The node, with device and mobility model installed
+     * @param adapter The adapter, not added to the node
+     * @param application The CAM application, not added to the node
+     * @return The slot index
+     */
+    uint32_t AddSlot(ns3::Ptr<ns3::Node> node, ns3::Ptr<VanetzaNS3Adapter> adapter,
+                     ns3::Ptr<CamApplication> application);
+
+    /**
+     * @brief Start a station in a free slot
+     * 
+     * The caller moves the returned node to the vehicle's position.
+     * @param stationId The station ID, not active yet
+     * @return The slot's node, nullptr if the pool is exhausted
+     */
+    ns3::Ptr<ns3::Node> Activate(uint32_t stationId);
+
+    /**
+     * @brief Stop a station and return its slot to the pool
+     * @param stationId The station ID
+     * @return False if the station is not active
+     */
+    bool Deactivate(uint32_t stationId);
+
+    /**
+     * @brief Get the node of an active station
+     * @param stationId The station ID
+     * @return The node, nullptr if the station is not active
+     */
+    ns3::Ptr<ns3::Node> GetNode(uint32_t stationId) const;
+
+    /**
+     * @brief Get the number of slots
+     * @return The pool size
+     */
+    uint32_t GetNSlots() const;
+
+    /**
+     * @brief Get the number of active stations
+     * @return The number of active stations
+     */
+    uint32_t GetNActive() const;
+
+    /**
+     * @brief Get the largest number of simultaneously active stations
+     * @return The peak population
+     */
+    uint32_t GetPeakActive() const;
+
+    /**
+     * @brief Get the number of activations
+     * @return The number of successful Activate() calls
+     */
+    uint64_t GetActivations() const;
+
+    /**
+     * @brief Get the number of activations refused for lack of a free slot
+     * @return The number of refused activations
+     */
+    uint64_t GetRejected() const;
+
+protected:
+    /**
+     * @brief Dispose of the pooled applications
+     */
+    virtual void DoDispose() override;
+
+private:
+    /**
+     * @brief One station slot
+     */
+    struct Slot {
+        ns3::Ptr<ns3::Node> node;                  ///< Node with device and mobility
+        ns3::Ptr<VanetzaNS3Adapter> adapter;       ///< Adapter of the slot
+        ns3::Ptr<CamApplication> application;      ///< CAM application of the slot
+    };
+
+    /**
+     * @brief Move the node of a slot to the parking position
+     */
+    void Park(const Slot& slot) const;
+
+    ns3::Vector m_parkingPosition;                     ///< Position of inactive nodes
+    std::vector<Slot> m_slots;                         ///< All slots
+    std::vector<uint32_t> m_free;                      ///< Free slots, most recently freed last
+    std::unordered_map<uint32_t, uint32_t> m_active;   ///< Slot of each active station
+    uint32_t m_peakActive;                             ///< Peak population
+    uint64_t m_activations;                            ///< Successful activations
+    uint64_t m_rejected;                               ///< Activations without a free slot
+};
+
+} // namespace vanetza_ns3
+
+#endif // FLEET_MANAGER_HPP
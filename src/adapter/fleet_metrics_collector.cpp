@@ -0,0 +1,141 @@
+#include "fleet_metrics_collector.hpp"
+#include "vanetza_ns3_adapter.hpp"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/trace-source-accessor.h>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("FleetMetricsCollector");
+
+NS_OBJECT_ENSURE_REGISTERED(FleetMetricsCollector);
+
+namespace {
+
+void
+WriteMetricsColumns(std::ostream& os, const StationMetrics& metrics)
+{
+    os << metrics.camsGenerated << ','
+       << metrics.camsSent << ','
+       << metrics.sendFailures << ','
+       << metrics.camsReceived << ','
+       << metrics.camsRejected << ','
+       << metrics.forwardedToVanetza << '\n';
+}
+
+const char* const kMetricsHeader =
+    "camsGenerated,camsSent,sendFailures,camsReceived,camsRejected,forwardedToVanetza\n";
+
+} // namespace
+
+FleetMetricsCollector::FleetMetricsCollector() :
+    m_interval(ns3::Seconds(1))
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FleetMetricsCollector::~FleetMetricsCollector()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ns3::TypeId
+FleetMetricsCollector::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::FleetMetricsCollector")
+        .SetParent<ns3::Object>()
+        .SetGroupName("VANET")
+        .AddConstructor<FleetMetricsCollector>()
+        .AddAttribute("Interval",
+                      "Time between two snapshots of the station metrics",
+                      ns3::TimeValue(ns3::Seconds(1)),
+                      ns3::MakeTimeAccessor(&FleetMetricsCollector::m_interval),
+                      ns3::MakeTimeChecker(ns3::MilliSeconds(1)))
+        .AddTraceSource("Snapshot",
+                        "The fleet totals after each snapshot",
+                        ns3::MakeTraceSourceAccessor(&FleetMetricsCollector::m_snapshotTrace),
+                        "vanetza_ns3::FleetMetricsCollector::SnapshotCallback");
+    return tid;
+}
+
+void
+FleetMetricsCollector::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    ns3::Simulator::Cancel(m_snapshotEvent);
+    m_adapters.clear();
+    ns3::Object::DoDispose();
+}
+
+void
+FleetMetricsCollector::Add(ns3::Ptr<VanetzaNS3Adapter> adapter)
+{
+    NS_LOG_FUNCTION(this << adapter);
+    m_adapters.push_back(adapter);
+    m_stationIds.push_back(0);
+    m_table.emplace_back();
+    
+    if (!m_snapshotEvent.IsRunning()) {
+        m_snapshotEvent = ns3::Simulator::Schedule(m_interval, &FleetMetricsCollector::PeriodicSnapshot, this);
+    }
+}
+
+void
+FleetMetricsCollector::PeriodicSnapshot()
+{
+    Snapshot();
+    m_snapshotEvent = ns3::Simulator::Schedule(m_interval, &FleetMetricsCollector::PeriodicSnapshot, this);
+}
+
+void
+FleetMetricsCollector::Snapshot()
+{
+    NS_LOG_FUNCTION(this);
+    
+    m_totals = StationMetrics();
+    for (std::size_t row = 0; row < m_adapters.size(); ++row) {
+        // Pooled slots change their station, read the current one
+        m_stationIds[row] = m_adapters[row]->GetStationId();
+        m_table[row] = m_adapters[row]->GetMetrics();
+        m_totals += m_table[row];
+        m_totals += m_adapters[row]->GetRetiredMetrics();
+    }
+    m_tableTime = ns3::Simulator::Now();
+    m_history.push_back(Sample { m_tableTime, m_totals });
+    m_snapshotTrace(m_tableTime, m_totals);
+}
+
+const StationMetrics&
+FleetMetricsCollector::GetTotals() const
+{
+    return m_totals;
+}
+
+const std::vector<FleetMetricsCollector::Sample>&
+FleetMetricsCollector::GetHistory() const
+{
+    return m_history;
+}
+
+void
+FleetMetricsCollector::WriteTable(std::ostream& os) const
+{
+    os << "time,stationId," << kMetricsHeader;
+    for (std::size_t row = 0; row < m_table.size(); ++row) {
+        os << m_tableTime.GetSeconds() << ',' << m_stationIds[row] << ',';
+        WriteMetricsColumns(os, m_table[row]);
+    }
+}
+
+void
+FleetMetricsCollector::WriteHistory(std::ostream& os) const
+{
+    os << "time," << kMetricsHeader;
+    for (const Sample& sample : m_history) {
+        os << sample.time.GetSeconds() << ',';
+        WriteMetricsColumns(os, sample.totals);
+    }
+}
+
+} // namespace vanetza_ns3
@@ -0,0 +1,129 @@
+#ifndef FLEET_METRICS_COLLECTOR_HPP
+#define FLEET_METRICS_COLLECTOR_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/event-id.h>
+#include <ns3/traced-callback.h>
+
+#include "station_metrics.hpp"
+
+namespace vanetza_ns3 {
+
+// Forward declarations
+class VanetzaNS3Adapter;
+
+/**
+ * @brief Periodically snapshots the metrics of all stations into one table
+ * 
+ * Stations only increment their own StationMetrics. Every Interval the
+ * collector copies the counters of all registered stations into a
+ * contiguous table, one row per station, and appends the fleet totals to
+ * a time series. Reading the counters never touches the stations' hot
+ * paths, so collection cost is proportional to the fleet size per
+ * snapshot rather than to the number of events.
+ * 
+ * A row of a pooled slot shows the vehicle using the slot at snapshot
+ * time; the fleet totals also include the vehicles that used it before.
+ */
+class FleetMetricsCollector : public ns3::Object {
+public:
+    /**
+     * @brief Fleet totals at one snapshot
+     */
+    struct Sample {
+        ns3::Time time;         ///< Time of the snapshot
+        StationMetrics totals;  ///< Sum over all stations
+    };
+
+    /**
+     * @brief Signature of the Snapshot trace source
+     * @param time Time of the snapshot
+     * @param totals Sum of the counters over all stations
+     */
+    typedef void (*SnapshotCallback)(ns3::Time time, const StationMetrics& totals);
+
+    /**
+     * @brief Constructor
+     */
+    FleetMetricsCollector();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~FleetMetricsCollector();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    /**
+     * @brief Register a station
+     * 
+     * The first registration schedules the periodic snapshots.
+     * @param adapter The adapter owning the station's counters
+     */
+    void Add(ns3::Ptr<VanetzaNS3Adapter> adapter);
+
+    /**
+     * @brief Take a snapshot now
+     */
+    void Snapshot();
+
+    /**
+     * @brief Get the fleet totals of the latest snapshot
+     * @return The totals
+     */
+    const StationMetrics& GetTotals() const;
+
+    /**
+     * @brief Get the fleet totals of all snapshots
+     * @return The samples in time order
+     */
+    const std::vector<Sample>& GetHistory() const;
+
+    /**
+     * @brief Write the per-station table of the latest snapshot as CSV
+     * @param os The output stream
+     */
+    void WriteTable(std::ostream& os) const;
+
+    /**
+     * @brief Write the fleet totals of all snapshots as CSV
+     * @param os The output stream
+     */
+    void WriteHistory(std::ostream& os) const;
+
+protected:
+    /**
+     * @brief Dispose of the collector
+     */
+    virtual void DoDispose() override;
+
+private:
+    /**
+     * @brief Take a snapshot and schedule the next one
+     */
+    void PeriodicSnapshot();
+
+    ns3::Time m_interval;                                 ///< Snapshot interval
+    ns3::EventId m_snapshotEvent;                         ///< Next periodic snapshot
+
+    std::vector<ns3::Ptr<VanetzaNS3Adapter>> m_adapters;  ///< Registered stations
+    std::vector<uint32_t> m_stationIds;                   ///< Station ID per row at the latest snapshot
+    std::vector<StationMetrics> m_table;                  ///< Counters per row at the latest snapshot
+    ns3::Time m_tableTime;                                ///< Time of the latest snapshot
+    StationMetrics m_totals;                              ///< Fleet totals at the latest snapshot
+    std::vector<Sample> m_history;                        ///< Fleet totals per snapshot
+
+    ns3::TracedCallback<ns3::Time, const StationMetrics&> m_snapshotTrace;  ///< Snapshot trace source
+};
+
+} // namespace vanetza_ns3
+
+#endif // FLEET_METRICS_COLLECTOR_HPP
@@ -0,0 +1,197 @@
+#include "geonet_shb_header.hpp"
+
+#include <ns3/address-utils.h>
+
+#include <algorithm>
+
+namespace vanetza_ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED(GeoNetShbHeader);
+
+constexpr uint32_t GeoNetShbHeader::kSerializedSize;
+constexpr uint8_t GeoNetShbHeader::kVersion;
+constexpr uint8_t GeoNetShbHeader::kNextHeaderBtpB;
+constexpr uint8_t GeoNetShbHeader::kHeaderTypeTsb;
+constexpr uint8_t GeoNetShbHeader::kHeaderSubtypeShb;
+
+namespace {
+
+const uint8_t kBasicNextHeaderCommon = 1;   // Basic header NH: common header follows
+const uint8_t kLifetime60s = (60 << 2) | 1; // Multiplier 60, base 1 s
+
+// Network byte order fields of the contiguous wire format
+uint16_t
+ReadU16(const uint8_t* data)
+{
+    return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+uint32_t
+ReadU32(const uint8_t* data)
+{
+    return static_cast<uint32_t>(ReadU16(data)) << 16 | ReadU16(data + 2);
+}
+
+} // namespace
+
+GeoNetShbHeader::GeoNetShbHeader() :
+    m_version(kVersion),
+    m_lifetime(kLifetime60s),
+    m_remainingHopLimit(1),
+    m_nextHeader(kNextHeaderBtpB),
+    m_headerType((kHeaderTypeTsb << 4) | kHeaderSubtypeShb),
+    m_trafficClass(0),
+    m_mobile(true),
+    m_payloadLength(0),
+    m_stationType(0),
+    m_timestamp(0),
+    m_latitude(0),
+    m_longitude(0),
+    m_accurate(false),
+    m_speed(0),
+    m_heading(0)
+{
+}
+
+ns3::TypeId
+GeoNetShbHeader::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::GeoNetShbHeader")
+        .SetParent<ns3::Header>()
+        .SetGroupName("VANET")
+        .AddConstructor<GeoNetShbHeader>();
+    return tid;
+}
+
+ns3::TypeId
+GeoNetShbHeader::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+GeoNetShbHeader::GetSerializedSize() const
+{
+    return kSerializedSize;
+}
+
+void
+GeoNetShbHeader::Serialize(ns3::Buffer::Iterator start) const
+{
+    // Basic header: version and NH, reserved, lifetime, remaining hop limit
+    start.WriteU8(static_cast<uint8_t>((m_version << 4) | kBasicNextHeaderCommon));
+    start.WriteU8(0);
+    start.WriteU8(m_lifetime);
+    start.WriteU8(m_remainingHopLimit);
+    
+    // Common header: NH, HT and HST, traffic class, flags, payload length, maximum hop limit
+    start.WriteU8(static_cast<uint8_t>(m_nextHeader << 4));
+    start.WriteU8(m_headerType);
+    start.WriteU8(m_trafficClass);
+    start.WriteU8(m_mobile ? 0x80 : 0x00);
+    start.WriteHtonU16(m_payloadLength);
+    start.WriteU8(m_remainingHopLimit);
+    start.WriteU8(0);
+    
+    // SHB extended header: source long position vector, media-dependent data
+    start.WriteHtonU16(static_cast<uint16_t>((m_stationType & 0x1f) << 10));
+    ns3::WriteTo(start, m_sourceAddress);
+    start.WriteHtonU32(m_timestamp);
+    start.WriteHtonU32(static_cast<uint32_t>(m_latitude));
+    start.WriteHtonU32(static_cast<uint32_t>(m_longitude));
+    start.WriteHtonU16(static_cast<uint16_t>((m_accurate ? 0x8000 : 0) | (static_cast<uint16_t>(m_speed) & 0x7fff)));
+    start.WriteHtonU16(m_heading);
+    start.WriteHtonU32(0);
+}
+
+uint32_t
+GeoNetShbHeader::Deserialize(ns3::Buffer::Iterator start)
+{
+    uint8_t bytes[kSerializedSize];
+    start.Read(bytes, kSerializedSize);
+    return DeserializeFrom(bytes);
+}
+
+uint32_t
+GeoNetShbHeader::DeserializeFrom(const uint8_t* data)
+{
+    const uint8_t versionAndNext = data[0];
+    m_version = versionAndNext >> 4;
+    m_lifetime = data[2];
+    m_remainingHopLimit = data[3];
+    
+    m_nextHeader = data[4] >> 4;
+    m_headerType = data[5];
+    m_trafficClass = data[6];
+    m_mobile = (data[7] & 0x80) != 0;
+    m_payloadLength = ReadU16(data + 8);
+    
+    m_stationType = static_cast<uint8_t>((ReadU16(data + 12) >> 10) & 0x1f);
+    m_sourceAddress.CopyFrom(data + 14);
+    m_timestamp = ReadU32(data + 20);
+    m_latitude = static_cast<int32_t>(ReadU32(data + 24));
+    m_longitude = static_cast<int32_t>(ReadU32(data + 28));
+    const uint16_t speed = ReadU16(data + 32);
+    m_accurate = (speed & 0x8000) != 0;
+    // Sign-extend the 15 bit speed
+    m_speed = static_cast<int16_t>(static_cast<uint16_t>(speed << 1)) / 2;
+    m_heading = ReadU16(data + 34);
+    
+    // Anything but SHB is rejected by IsShbBtpB(), the size is fixed either way
+    if ((versionAndNext & 0x0f) != kBasicNextHeaderCommon) {
+        m_headerType = 0xff;
+    }
+    return kSerializedSize;
+}
+
+void
+GeoNetShbHeader::Print(std::ostream& os) const
+{
+    os << "GN SHB v" << static_cast<uint32_t>(m_version)
+       << " source=" << m_sourceAddress
+       << " tst=" << m_timestamp
+       << " lat=" << m_latitude
+       << " lon=" << m_longitude
+       << " speed=" << m_speed
+       << " heading=" << m_heading
+       << " pl=" << m_payloadLength;
+}
+
+bool
+GeoNetShbHeader::IsShbBtpB() const
+{
+    return m_version == kVersion &&
+           m_headerType == ((kHeaderTypeTsb << 4) | kHeaderSubtypeShb) &&
+           m_nextHeader == kNextHeaderBtpB;
+}
+
+void
+GeoNetShbHeader::SetSource(const ns3::Mac48Address& address, uint8_t stationType, uint32_t timestampMs)
+{
+    m_sourceAddress = address;
+    m_stationType = stationType;
+    m_timestamp = timestampMs;
+}
+
+void
+GeoNetShbHeader::SetPosition(int32_t latitude, int32_t longitude, bool accurate)
+{
+    m_latitude = latitude;
+    m_longitude = longitude;
+    m_accurate = accurate;
+}
+
+void
+GeoNetShbHeader::SetMotion(int32_t speed, uint16_t heading)
+{
+    m_speed = static_cast<int16_t>(std::min(std::max(speed, -16384), 16383));
+    m_heading = heading;
+}
+
+void
+GeoNetShbHeader::SetPayloadLength(uint16_t length)
+{
+    m_payloadLength = length;
+}
+
+} // namespace vanetza_ns3
@@ -0,0 +1,138 @@
+#ifndef GEONET_SHB_HEADER_HPP
+#define GEONET_SHB_HEADER_HPP
+
+#include <cstdint>
+#include <ns3/header.h>
+#include <ns3/mac48-address.h>
+
+namespace vanetza_ns3 {
+
+/**
+ * @brief GeoNetworking headers of a Single-Hop Broadcast packet
+ *
+ * Basic header, common header and SHB extended header of ETSI EN 302 636-4-1
+ * as they appear on the wire (4 + 8 + 28 bytes). The extended header carries
+ * the long position vector of the source and the media-dependent DCC field.
+ * Added to a packet in front of the BTP header, so the payload is never
+ * copied while the packet is encapsulated or decapsulated.
+ */
+class GeoNetShbHeader : public ns3::Header {
+public:
+    static constexpr uint32_t kSerializedSize = 40;  ///< Basic + common + SHB extended header
+    static constexpr uint8_t kVersion = 1;           ///< GeoNetworking protocol version
+    static constexpr uint8_t kNextHeaderBtpB = 2;    ///< Common header NH of BTP-B
+    static constexpr uint8_t kHeaderTypeTsb = 5;     ///< Common header HT of topologically scoped broadcast
+    static constexpr uint8_t kHeaderSubtypeShb = 0;  ///< Common header HST of single-hop broadcast
+
+    /**
+     * @brief Constructor, a mobile SHB with the default lifetime of 60 s
+     */
+    GeoNetShbHeader();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    // ns3::Header interface
+    virtual ns3::TypeId GetInstanceTypeId() const override;
+    virtual uint32_t GetSerializedSize() const override;
+    virtual void Serialize(ns3::Buffer::Iterator start) const override;
+    virtual uint32_t Deserialize(ns3::Buffer::Iterator start) override;
+    virtual void Print(std::ostream& os) const override;
+
+    /**
+     * @brief Deserialize the header from contiguous wire bytes
+     *
+     * Same result as Deserialize() without going through an ns3::Buffer,
+     * for frames that were already copied out of their packet.
+     * @param data At least kSerializedSize bytes
+     * @return The number of bytes read
+     */
+    uint32_t DeserializeFrom(const uint8_t* data);
+
+    /**
+     * @brief Check whether a deserialized header is a supported SHB carrying BTP-B
+     * @return True for version 1, TSB/SHB and BTP-B as next header
+     */
+    bool IsShbBtpB() const;
+
+    /**
+     * @brief Set the source of the packet
+     * @param address Link-layer address of the source, the MID of its GN address
+     * @param stationType ITS station type (5 = passenger car)
+     * @param timestampMs Time of the position fix in milliseconds, modulo 2^32
+     */
+    void SetSource(const ns3::Mac48Address& address, uint8_t stationType, uint32_t timestampMs);
+
+    /**
+     * @brief Set the position of the source
+     * @param latitude Latitude in 1/10 micro degree
+     * @param longitude Longitude in 1/10 micro degree
+     * @param accurate Position accuracy indicator
+     */
+    void SetPosition(int32_t latitude, int32_t longitude, bool accurate);
+
+    /**
+     * @brief Set the motion of the source
+     * @param speed Speed in 0.01 m/s, clamped to the 15 bit field
+     * @param heading Heading in 0.1 degree clockwise from north
+     */
+    void SetMotion(int32_t speed, uint16_t heading);
+
+    /**
+     * @brief Set the length of everything following the GeoNetworking headers
+     * @param length The payload length in bytes, BTP header included
+     */
+    void SetPayloadLength(uint16_t length);
+
+    /**
+     * @brief Get the link-layer address of the source
+     * @return The MID of the source GN address
+     */
+    ns3::Mac48Address GetSourceAddress() const { return m_sourceAddress; }
+
+    /**
+     * @brief Get the latitude of the source
+     * @return The latitude in 1/10 micro degree
+     */
+    int32_t GetLatitude() const { return m_latitude; }
+
+    /**
+     * @brief Get the longitude of the source
+     * @return The longitude in 1/10 micro degree
+     */
+    int32_t GetLongitude() const { return m_longitude; }
+
+    /**
+     * @brief Get the length of everything following the GeoNetworking headers
+     * @return The payload length in bytes
+     */
+    uint16_t GetPayloadLength() const { return m_payloadLength; }
+
+private:
+    // Basic and common header
+    uint8_t m_version;            ///< Protocol version
+    uint8_t m_lifetime;           ///< Encoded lifetime (multiplier and base)
+    uint8_t m_remainingHopLimit;  ///< Remaining hop limit, 1 for SHB
+    uint8_t m_nextHeader;         ///< Common header next header
+    uint8_t m_headerType;         ///< Header type and subtype
+    uint8_t m_trafficClass;       ///< Traffic class
+    bool m_mobile;                ///< Mobile station flag
+    uint16_t m_payloadLength;     ///< Length after the GeoNetworking headers
+
+    // Source long position vector
+    ns3::Mac48Address m_sourceAddress;  ///< MID of the source GN address
+    uint8_t m_stationType;        ///< ITS station type
+    uint32_t m_timestamp;         ///< Time of the position fix in milliseconds
+    int32_t m_latitude;           ///< Latitude in 1/10 micro degree
+    int32_t m_longitude;          ///< Longitude in 1/10 micro degree
+    bool m_accurate;              ///< Position accuracy indicator
+    int16_t m_speed;              ///< Speed in 0.01 m/s
+    uint16_t m_heading;           ///< Heading in 0.1 degree
+};
+
+} // namespace vanetza_ns3
+
+#endif // GEONET_SHB_HEADER_HPP
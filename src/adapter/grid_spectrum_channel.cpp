@@ -0,0 +1,277 @@
+#include "grid_spectrum_channel.hpp"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/node.h>
+#include <ns3/net-device.h>
+#include <ns3/angles.h>
+#include <ns3/antenna-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("GridSpectrumChannel");
+
+NS_OBJECT_ENSURE_REGISTERED(GridSpectrumChannel);
+
+GridSpectrumChannel::GridSpectrumChannel() :
+    m_maxRange(1000.0),
+    m_positionSlack(10.0),
+    m_refreshInterval(ns3::MilliSeconds(100)),
+    m_exponent(3.0),
+    m_referenceDistance(1.0),
+    m_referenceLoss(46.6777),
+    m_lastRefresh(ns3::Seconds(0)),
+    m_stale(true),
+    m_delivered(0),
+    m_culled(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+GridSpectrumChannel::~GridSpectrumChannel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ns3::TypeId
+GridSpectrumChannel::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::GridSpectrumChannel")
+        .SetParent<ns3::SpectrumChannel>()
+        .SetGroupName("VANET")
+        .AddConstructor<GridSpectrumChannel>()
+        .AddAttribute("MaxRange",
+                      "Receivers farther away than this (in meters) never see a transmission",
+                      ns3::DoubleValue(1000.0),
+                      ns3::MakeDoubleAccessor(&GridSpectrumChannel::m_maxRange),
+                      ns3::MakeDoubleChecker<double>(1.0))
+        .AddAttribute("PositionSlack",
+                      "Distance (in meters) a node may move between two grid refreshes",
+                      ns3::DoubleValue(10.0),
+                      ns3::MakeDoubleAccessor(&GridSpectrumChannel::m_positionSlack),
+                      ns3::MakeDoubleChecker<double>(0.0))
+        .AddAttribute("PositionRefreshInterval",
+                      "Maximum age of the receiver positions used for culling",
+                      ns3::TimeValue(ns3::MilliSeconds(100)),
+                      ns3::MakeTimeAccessor(&GridSpectrumChannel::m_refreshInterval),
+                      ns3::MakeTimeChecker())
+        .AddAttribute("Exponent",
+                      "Path loss exponent of the built-in log-distance model",
+                      ns3::DoubleValue(3.0),
+                      ns3::MakeDoubleAccessor(&GridSpectrumChannel::m_exponent),
+                      ns3::MakeDoubleChecker<double>())
+        .AddAttribute("ReferenceDistance",
+                      "Reference distance of the built-in log-distance model in meters",
+                      ns3::DoubleValue(1.0),
+                      ns3::MakeDoubleAccessor(&GridSpectrumChannel::m_referenceDistance),
+                      ns3::MakeDoubleChecker<double>(0.001))
+        .AddAttribute("ReferenceLoss",
+                      "Loss of the built-in log-distance model at the reference distance in dB",
+                      ns3::DoubleValue(46.6777),
+                      ns3::MakeDoubleAccessor(&GridSpectrumChannel::m_referenceLoss),
+                      ns3::MakeDoubleChecker<double>());
+    return tid;
+}
+
+void
+GridSpectrumChannel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_phys.clear();
+    m_mobility.clear();
+    ns3::SpectrumChannel::DoDispose();
+}
+
+void
+GridSpectrumChannel::AddRx(ns3::Ptr<ns3::SpectrumPhy> phy)
+{
+    NS_LOG_FUNCTION(this << phy);
+    m_phys.push_back(phy);
+    m_mobility.push_back(nullptr);
+    m_stale = true;
+}
+
+std::size_t
+GridSpectrumChannel::GetNDevices() const
+{
+    return m_phys.size();
+}
+
+ns3::Ptr<ns3::NetDevice>
+GridSpectrumChannel::GetDevice(std::size_t i) const
+{
+    return m_phys.at(i)->GetDevice();
+}
+
+uint64_t
+GridSpectrumChannel::GetDeliveredCount() const
+{
+    return m_delivered;
+}
+
+uint64_t
+GridSpectrumChannel::GetCulledCount() const
+{
+    return m_culled;
+}
+
+void
+GridSpectrumChannel::RefreshPositions()
+{
+    ns3::Time now = ns3::Simulator::Now();
+    if (!m_stale && now - m_lastRefresh < m_refreshInterval) {
+        return;
+    }
+    
+    const std::size_t n = m_phys.size();
+    m_x.resize(n);
+    m_y.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        // PHYs may get their mobility model after being attached
+        if (!m_mobility[i]) {
+            m_mobility[i] = m_phys[i]->GetMobility();
+            if (m_mobility[i]) {
+                m_mobility[i]->TraceConnectWithoutContext("CourseChange",
+                    ns3::MakeBoundCallback(&GridSpectrumChannel::CourseChanged, this, static_cast<uint32_t>(i)));
+            }
+        }
+        ns3::Vector position = m_mobility[i] ? m_mobility[i]->GetPosition() : ns3::Vector();
+        m_x[i] = static_cast<float>(position.x);
+        m_y[i] = static_cast<float>(position.y);
+    }
+    m_grid.setCellSize(m_maxRange);
+    m_grid.build(m_x.data(), m_y.data(), n);
+    m_lastRefresh = now;
+    m_stale = false;
+}
+
+void
+GridSpectrumChannel::CourseChanged(GridSpectrumChannel* channel, uint32_t index,
+                                   ns3::Ptr<const ns3::MobilityModel> mobility)
+{
+    if (channel->m_stale || index >= channel->m_x.size()) {
+        return;
+    }
+    const ns3::Vector position = mobility->GetPosition();
+    const double dx = position.x - channel->m_x[index];
+    const double dy = position.y - channel->m_y[index];
+    if (dx * dx + dy * dy > channel->m_positionSlack * channel->m_positionSlack) {
+        NS_LOG_LOGIC("Node " << index << " moved beyond the slack, grid invalidated");
+        channel->m_stale = true;
+    }
+}
+
+void
+GridSpectrumChannel::StartTx(ns3::Ptr<ns3::SpectrumSignalParameters> txParams)
+{
+    NS_LOG_FUNCTION(this << txParams);
+    m_txSigParamsTrace(txParams);
+    
+    ns3::Ptr<ns3::MobilityModel> txMobility = txParams->txPhy->GetMobility();
+    if (!txMobility) {
+        NS_LOG_WARN("Transmitter without mobility model, signal dropped");
+        return;
+    }
+    RefreshPositions();
+    
+    // Candidates from the grid, then exact distances from the mobility models
+    const ns3::Vector txPosition = txMobility->GetPosition();
+    m_candidates.clear();
+    m_distance.clear();
+    m_grid.forEachWithin(static_cast<float>(txPosition.x), static_cast<float>(txPosition.y),
+                         static_cast<float>(m_maxRange + 2.0 * m_positionSlack),
+                         [this](uint32_t i, float) { m_candidates.push_back(i); });
+    
+    // The transmitter is not a receiver and never counts as culled
+    std::size_t n = 0;
+    bool txAttached = false;
+    for (uint32_t i : m_candidates) {
+        if (m_phys[i] == txParams->txPhy) {
+            txAttached = true;
+            continue;
+        }
+        if (!m_mobility[i]) {
+            continue;
+        }
+        double distance = m_mobility[i]->GetDistanceFrom(txMobility);
+        if (distance > m_maxRange) {
+            continue;
+        }
+        m_candidates[n++] = i;
+        m_distance.push_back(distance);
+    }
+    m_candidates.resize(n);
+    // The grid returns an attached transmitter unless it lost its mobility
+    // model or position, only then the PHY list is searched
+    if (!txAttached) {
+        txAttached = std::find(m_phys.begin(), m_phys.end(), txParams->txPhy) != m_phys.end();
+    }
+    m_culled += m_phys.size() - (txAttached ? 1 : 0) - n;
+    
+    // Path loss for the whole candidate set
+    m_lossDb.resize(n);
+    if (m_propagationLoss) {
+        for (std::size_t k = 0; k < n; ++k) {
+            m_lossDb[k] = -m_propagationLoss->CalcRxPower(0, txMobility, m_mobility[m_candidates[k]]);
+        }
+    } else {
+        const double d0 = m_referenceDistance;
+        const double slope = 10.0 * m_exponent;
+        const double reference = m_referenceLoss;
+        const double* distance = m_distance.data();
+        double* loss = m_lossDb.data();
+        for (std::size_t k = 0; k < n; ++k) {
+            loss[k] = reference + slope * std::log10(std::max(distance[k], d0) / d0);
+        }
+    }
+    
+    for (std::size_t k = 0; k < n; ++k) {
+        ns3::Ptr<ns3::SpectrumPhy> rxPhy = m_phys[m_candidates[k]];
+        ns3::Ptr<ns3::MobilityModel> rxMobility = m_mobility[m_candidates[k]];
+        double pathLossDb = m_lossDb[k];
+        
+        ns3::Ptr<ns3::SpectrumSignalParameters> rxParams = txParams->Copy();
+        if (rxParams->txAntenna) {
+            ns3::Angles txAngles(rxMobility->GetPosition(), txPosition);
+            pathLossDb -= rxParams->txAntenna->GetGainDb(txAngles);
+        }
+        ns3::Ptr<ns3::AntennaModel> rxAntenna = rxPhy->GetRxAntenna();
+        if (rxAntenna) {
+            ns3::Angles rxAngles(txPosition, rxMobility->GetPosition());
+            pathLossDb -= rxAntenna->GetGainDb(rxAngles);
+        }
+        m_pathLossTrace(txParams->txPhy, rxPhy, pathLossDb);
+        if (pathLossDb > m_maxLossDb) {
+            ++m_culled;
+            continue;
+        }
+        
+        *(rxParams->psd) *= std::pow(10.0, -pathLossDb / 10.0);
+        if (m_spectrumPropagationLoss) {
+            rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity(rxParams->psd, txMobility, rxMobility);
+        }
+        
+        ns3::Time delay = m_propagationDelay ? m_propagationDelay->GetDelay(txMobility, rxMobility) : ns3::Seconds(0);
+        ns3::Ptr<ns3::NetDevice> rxDevice = rxPhy->GetDevice();
+        uint32_t context = rxDevice ? rxDevice->GetNode()->GetId() : ns3::Simulator::NO_CONTEXT;
+        ns3::Simulator::ScheduleWithContext(context, delay, &GridSpectrumChannel::StartRx, rxParams, rxPhy);
+        ++m_delivered;
+    }
+}
+
+void
+GridSpectrumChannel::StartRx(ns3::Ptr<ns3::SpectrumSignalParameters> params, ns3::Ptr<ns3::SpectrumPhy> receiver)
+{
+    NS_LOG_FUNCTION(params << receiver);
+    receiver->StartRx(params);
+}
+
+} // namespace vanetza_ns3
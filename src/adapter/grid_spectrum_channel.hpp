@@ -0,0 +1,133 @@
+#ifndef GRID_SPECTRUM_CHANNEL_HPP
+#define GRID_SPECTRUM_CHANNEL_HPP
+
+#include <cstdint>
+#include <vector>
+#include <ns3/spectrum-channel.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/mobility-model.h>
+#include <ns3/nstime.h>
+#include <ns3/ptr.h>
+
+#include "utils/uniform_grid.hpp"
+
+namespace vanetza_ns3 {
+
+/**
+ * @brief Spectrum channel that only delivers to receivers in range
+ * 
+ * The stock channels run propagation loss and PHY reception for every
+ * attached PHY on every transmission, which is O(N^2) per CAM period in a
+ * single broadcast domain. This channel keeps receiver positions in a
+ * uniform grid, refreshed lazily from the mobility models at most once per
+ * PositionRefreshInterval, and only considers receivers within MaxRange of
+ * the transmitter. A CourseChange that leaves a node more than
+ * PositionSlack away from its grid position (a teleport, a restored
+ * snapshot, a reactivated vehicle) invalidates the grid at once; between
+ * course changes nodes must not move farther than PositionSlack within
+ * one PositionRefreshInterval. Received power is computed for the whole candidate set
+ * in one batch: either through the log-distance model configured by the
+ * channel's attributes, or, if a PropagationLossModel was added, through
+ * that model per candidate.
+ * 
+ * The TxSigParams and PathLoss trace sources of SpectrumChannel fire as
+ * with the stock channels, PathLoss only for the receivers in range.
+ * 
+ * Use it with SpectrumWifiPhyHelper::SetChannel.
+ */
+class GridSpectrumChannel : public ns3::SpectrumChannel {
+public:
+    /**
+     * @brief Constructor
+     */
+    GridSpectrumChannel();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~GridSpectrumChannel();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    // SpectrumChannel interface
+    virtual void AddRx(ns3::Ptr<ns3::SpectrumPhy> phy) override;
+    virtual void StartTx(ns3::Ptr<ns3::SpectrumSignalParameters> params) override;
+
+    // Channel interface
+    virtual std::size_t GetNDevices() const override;
+    virtual ns3::Ptr<ns3::NetDevice> GetDevice(std::size_t i) const override;
+
+    /**
+     * @brief Get the number of receptions scheduled so far
+     * @return The number of receptions
+     */
+    uint64_t GetDeliveredCount() const;
+
+    /**
+     * @brief Get the number of receivers skipped by the range culling
+     * @return The number of culled receivers
+     */
+    uint64_t GetCulledCount() const;
+
+protected:
+    /**
+     * @brief Dispose of the channel
+     */
+    virtual void DoDispose() override;
+
+private:
+    /**
+     * @brief Refresh the receiver grid if positions are outdated
+     */
+    void RefreshPositions();
+
+    /**
+     * @brief Invalidate the grid if a node left its grid position
+     * @param channel The channel
+     * @param index The index of the node's PHY
+     * @param mobility The mobility model that changed course
+     */
+    static void CourseChanged(GridSpectrumChannel* channel, uint32_t index,
+                              ns3::Ptr<const ns3::MobilityModel> mobility);
+
+    /**
+     * @brief Hand a signal to a receiving PHY
+     * @param params The received signal
+     * @param receiver The receiving PHY
+     */
+    static void StartRx(ns3::Ptr<ns3::SpectrumSignalParameters> params, ns3::Ptr<ns3::SpectrumPhy> receiver);
+
+    // Configuration
+    double m_maxRange;                       ///< Maximum interference range in meters
+    double m_positionSlack;                  ///< Tolerated movement between refreshes in meters
+    ns3::Time m_refreshInterval;             ///< Maximum age of the receiver grid
+    double m_exponent;                       ///< Log-distance path loss exponent
+    double m_referenceDistance;              ///< Log-distance reference distance in meters
+    double m_referenceLoss;                  ///< Log-distance loss at the reference distance in dB
+
+    // Receivers
+    std::vector<ns3::Ptr<ns3::SpectrumPhy> > m_phys;         ///< Attached PHYs
+    std::vector<ns3::Ptr<ns3::MobilityModel> > m_mobility;   ///< Mobility of each PHY
+    std::vector<float> m_x;                  ///< X positions at the last refresh
+    std::vector<float> m_y;                  ///< Y positions at the last refresh
+    utils::UniformGrid m_grid;               ///< Grid over the receiver positions
+    ns3::Time m_lastRefresh;                 ///< Time of the last refresh
+    bool m_stale;                            ///< Receivers were added or moved beyond the slack since the last refresh
+
+    // Per-transmission scratch (reused to avoid allocations)
+    std::vector<uint32_t> m_candidates;      ///< Candidate receivers
+    std::vector<double> m_distance;          ///< Distance to each candidate
+    std::vector<double> m_lossDb;            ///< Path loss to each candidate
+
+    // Statistics
+    uint64_t m_delivered;                    ///< Scheduled receptions
+    uint64_t m_culled;                       ///< Receivers skipped by culling
+};
+
+} // namespace vanetza_ns3
+
+#endif // GRID_SPECTRUM_CHANNEL_HPP
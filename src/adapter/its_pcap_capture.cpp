@@ -0,0 +1,314 @@
+#include "its_pcap_capture.hpp"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/boolean.h>
+#include <ns3/string.h>
+#include <ns3/uinteger.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("ItsPcapCapture");
+
+NS_OBJECT_ENSURE_REGISTERED(ItsPcapCapture);
+
+constexpr uint16_t ItsPcapCapture::kEtherType;
+
+namespace {
+
+const uint32_t kPcapMagicNanoseconds = 0xa1b23c4d;
+const uint32_t kLinkTypeEthernet = 1;
+const std::size_t kGlobalHeaderSize = 24;
+const std::size_t kRecordHeaderSize = 16;
+const std::size_t kEthernetHeaderSize = 14;
+
+// Fields are written in host byte order, readers detect it from the magic
+template<typename T>
+void
+Append(std::vector<uint8_t>& buffer, T value)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+} // namespace
+
+ItsPcapCapture::ItsPcapCapture() :
+    m_filePrefix("cam-simulation-its"),
+    m_startTime(ns3::Seconds(0)),
+    m_stopTime(ns3::Seconds(0)),
+    m_bufferSize(4 * 1024 * 1024),
+    m_maxFileSize(0),
+    m_snapLength(65535),
+    m_captureReceptions(false),
+    m_file(nullptr),
+    m_fileSize(0),
+    m_fileIndex(0),
+    m_frames(0),
+    m_bytesWritten(0),
+    m_failed(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ItsPcapCapture::~ItsPcapCapture()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+ns3::TypeId
+ItsPcapCapture::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::ItsPcapCapture")
+        .SetParent<ns3::Object>()
+        .SetGroupName("VANET")
+        .AddConstructor<ItsPcapCapture>()
+        .AddAttribute("FilePrefix",
+                      "Capture file name without extension, rotated files get a -NNNN suffix",
+                      ns3::StringValue("cam-simulation-its"),
+                      ns3::MakeStringAccessor(&ItsPcapCapture::m_filePrefix),
+                      ns3::MakeStringChecker())
+        .AddAttribute("Stations",
+                      "Comma-separated station IDs and ranges (e.g. \"1-10,42\") to capture, all if empty",
+                      ns3::StringValue(""),
+                      ns3::MakeStringAccessor(&ItsPcapCapture::SetStations, &ItsPcapCapture::GetStations),
+                      ns3::MakeStringChecker())
+        .AddAttribute("StartTime",
+                      "Begin of the capture window",
+                      ns3::TimeValue(ns3::Seconds(0)),
+                      ns3::MakeTimeAccessor(&ItsPcapCapture::m_startTime),
+                      ns3::MakeTimeChecker())
+        .AddAttribute("StopTime",
+                      "End of the capture window, no end if zero",
+                      ns3::TimeValue(ns3::Seconds(0)),
+                      ns3::MakeTimeAccessor(&ItsPcapCapture::m_stopTime),
+                      ns3::MakeTimeChecker())
+        .AddAttribute("BufferSize",
+                      "Bytes of frames collected before they are written",
+                      ns3::UintegerValue(4 * 1024 * 1024),
+                      ns3::MakeUintegerAccessor(&ItsPcapCapture::m_bufferSize),
+                      ns3::MakeUintegerChecker<uint32_t>(4096))
+        .AddAttribute("MaxFileSize",
+                      "Start a new capture file before one exceeds this many bytes, no rotation if zero",
+                      ns3::UintegerValue(0),
+                      ns3::MakeUintegerAccessor(&ItsPcapCapture::m_maxFileSize),
+                      ns3::MakeUintegerChecker<uint64_t>())
+        .AddAttribute("SnapLength",
+                      "Maximum number of bytes captured per frame, including the Ethernet header",
+                      ns3::UintegerValue(65535),
+                      ns3::MakeUintegerAccessor(&ItsPcapCapture::m_snapLength),
+                      ns3::MakeUintegerChecker<uint32_t>(64))
+        .AddAttribute("CaptureReceptions",
+                      "Also capture every reception, written with the receiver's address as destination",
+                      ns3::BooleanValue(false),
+                      ns3::MakeBooleanAccessor(&ItsPcapCapture::m_captureReceptions),
+                      ns3::MakeBooleanChecker());
+    return tid;
+}
+
+void
+ItsPcapCapture::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+    ns3::Object::DoDispose();
+}
+
+void
+ItsPcapCapture::SetStations(std::string stations)
+{
+    m_stationsText = stations;
+    m_stations.clear();
+    
+    std::istringstream in(stations);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (item.empty()) {
+            continue;
+        }
+        const std::size_t dash = item.find('-');
+        const uint32_t first = static_cast<uint32_t>(std::strtoul(item.c_str(), nullptr, 10));
+        const uint32_t last = dash == std::string::npos ?
+            first : static_cast<uint32_t>(std::strtoul(item.c_str() + dash + 1, nullptr, 10));
+        m_stations.emplace_back(std::min(first, last), std::max(first, last));
+    }
+    std::sort(m_stations.begin(), m_stations.end());
+}
+
+std::string
+ItsPcapCapture::GetStations() const
+{
+    return m_stationsText;
+}
+
+bool
+ItsPcapCapture::IsSelected(uint32_t stationId) const
+{
+    if (m_stations.empty()) {
+        return true;
+    }
+    for (const auto& range : m_stations) {
+        if (stationId < range.first) {
+            return false;
+        }
+        if (stationId <= range.second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+ItsPcapCapture::IsCaptured(uint32_t stationId) const
+{
+    const ns3::Time now = ns3::Simulator::Now();
+    if (now < m_startTime || (!m_stopTime.IsZero() && now >= m_stopTime)) {
+        return false;
+    }
+    return IsSelected(stationId);
+}
+
+bool
+ItsPcapCapture::CapturesReceptions() const
+{
+    return m_captureReceptions;
+}
+
+void
+ItsPcapCapture::Capture(uint32_t stationId, const ns3::Mac48Address& source, const ns3::Mac48Address& destination,
+                        const uint8_t* data, std::size_t size)
+{
+    if (!IsCaptured(stationId)) {
+        return;
+    }
+    const ns3::Time now = ns3::Simulator::Now();
+    
+    const std::size_t frameSize = kEthernetHeaderSize + size;
+    const std::size_t captured = std::min<std::size_t>(frameSize, m_snapLength);
+    const std::size_t recordSize = kRecordHeaderSize + captured;
+    
+    if (!m_file && !OpenNextFile()) {
+        return;
+    }
+    if (m_maxFileSize > 0 && m_fileSize > kGlobalHeaderSize && m_fileSize + recordSize > m_maxFileSize) {
+        Close();
+        if (!OpenNextFile()) {
+            return;
+        }
+    }
+    if (m_buffer.size() + recordSize > m_bufferSize) {
+        Flush();
+    }
+    
+    // Record header: timestamp (s, ns), captured and original length
+    const int64_t ns = now.GetNanoSeconds();
+    Append<uint32_t>(m_buffer, static_cast<uint32_t>(ns / 1000000000));
+    Append<uint32_t>(m_buffer, static_cast<uint32_t>(ns % 1000000000));
+    Append<uint32_t>(m_buffer, static_cast<uint32_t>(captured));
+    Append<uint32_t>(m_buffer, static_cast<uint32_t>(frameSize));
+    
+    // Ethernet header: destination, sender, EtherType (network order)
+    uint8_t ethernet[kEthernetHeaderSize];
+    destination.CopyTo(ethernet);
+    source.CopyTo(ethernet + 6);
+    ethernet[12] = static_cast<uint8_t>(kEtherType >> 8);
+    ethernet[13] = static_cast<uint8_t>(kEtherType & 0xff);
+    const std::size_t header = std::min(captured, kEthernetHeaderSize);
+    m_buffer.insert(m_buffer.end(), ethernet, ethernet + header);
+    m_buffer.insert(m_buffer.end(), data, data + (captured - header));
+    
+    m_fileSize += recordSize;
+    ++m_frames;
+}
+
+bool
+ItsPcapCapture::OpenNextFile()
+{
+    if (m_failed) {
+        return false;
+    }
+    
+    std::ostringstream name;
+    name << m_filePrefix;
+    if (m_maxFileSize > 0) {
+        name << "-" << std::setw(4) << std::setfill('0') << m_fileIndex;
+    }
+    name << ".pcap";
+    
+    m_file = std::fopen(name.str().c_str(), "wb");
+    if (!m_file) {
+        NS_LOG_ERROR("Cannot open capture file " << name.str());
+        m_failed = true;
+        return false;
+    }
+    NS_LOG_INFO("Capturing ITS frames to " << name.str());
+    
+    // The buffer is written in large chunks, stdio buffering is not needed
+    std::setvbuf(m_file, nullptr, _IONBF, 0);
+    if (m_buffer.capacity() < m_bufferSize) {
+        m_buffer.reserve(m_bufferSize);
+    }
+    
+    // Global header: magic, version 2.4, zone, sigfigs, snap length, link type
+    Append<uint32_t>(m_buffer, kPcapMagicNanoseconds);
+    Append<uint16_t>(m_buffer, 2);
+    Append<uint16_t>(m_buffer, 4);
+    Append<int32_t>(m_buffer, 0);
+    Append<uint32_t>(m_buffer, 0);
+    Append<uint32_t>(m_buffer, m_snapLength);
+    Append<uint32_t>(m_buffer, kLinkTypeEthernet);
+    m_fileSize = kGlobalHeaderSize;
+    ++m_fileIndex;
+    return true;
+}
+
+void
+ItsPcapCapture::Flush()
+{
+    if (!m_file || m_buffer.empty()) {
+        return;
+    }
+    const std::size_t written = std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+    if (written != m_buffer.size()) {
+        NS_LOG_ERROR("Short write to capture file, " << m_buffer.size() - written << " bytes lost");
+    }
+    m_bytesWritten += written;
+    m_buffer.clear();
+}
+
+void
+ItsPcapCapture::Close()
+{
+    if (!m_file) {
+        return;
+    }
+    Flush();
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+uint64_t
+ItsPcapCapture::GetFrames() const
+{
+    return m_frames;
+}
+
+uint64_t
+ItsPcapCapture::GetBytesWritten() const
+{
+    return m_bytesWritten + m_buffer.size();
+}
+
+uint32_t
+ItsPcapCapture::GetFiles() const
+{
+    return m_fileIndex;
+}
+
+} // namespace vanetza_ns3
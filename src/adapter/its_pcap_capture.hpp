@@ -0,0 +1,163 @@
+#ifndef ITS_PCAP_CAPTURE_HPP
+#define ITS_PCAP_CAPTURE_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/mac48-address.h>
+
+namespace vanetza_ns3 {
+
+/**
+ * @brief Merged PCAP capture of the ITS frames of all stations
+ * 
+ * Adapters hand their ITS frames (EtherType 0x8947) to one shared capture,
+ * so a run produces a single file instead of one per device, and frames of
+ * other protocols never reach it. Each frame is written with a synthetic
+ * Ethernet header (DLT_EN10MB, nanosecond timestamps), so Wireshark decodes
+ * the GeoNetworking payload directly. Transmissions carry the broadcast
+ * destination; receptions (CaptureReceptions) carry the receiver's address
+ * as destination, so eth.dst tells the direction and the receiver of every
+ * record.
+ * 
+ * Frames can be restricted to a subset of stations and to a time window.
+ * Records are collected in a memory buffer of BufferSize bytes and written
+ * with one fwrite when it is full. With MaxFileSize set, the capture moves
+ * on to a new file (<FilePrefix>-0000.pcap, -0001.pcap, ...) before a file would
+ * exceed that size.
+ */
+class ItsPcapCapture : public ns3::Object {
+public:
+    static constexpr uint16_t kEtherType = 0x8947;  ///< EtherType of ITS frames
+
+    /**
+     * @brief Constructor
+     */
+    ItsPcapCapture();
+
+    /**
+     * @brief Destructor, writes the buffered frames
+     */
+    virtual ~ItsPcapCapture();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    /**
+     * @brief Capture a frame if it passes the station and time filters
+     * @param stationId The station the frame was sent or received by
+     * @param source Link-layer source of the frame
+     * @param destination Broadcast for a transmission, the receiver's address for a reception
+     * @param data The frame payload
+     * @param size The payload size
+     */
+    void Capture(uint32_t stationId, const ns3::Mac48Address& source, const ns3::Mac48Address& destination,
+                 const uint8_t* data, std::size_t size);
+
+    /**
+     * @brief Check whether a frame of a station sent now would be captured
+     * 
+     * Applies the station filter and the time window, so callers can skip
+     * serializing frames that Capture() would drop.
+     * @param stationId The station the frame was sent or received by
+     * @return True if Capture() would write the frame
+     */
+    bool IsCaptured(uint32_t stationId) const;
+
+    /**
+     * @brief Check whether received frames are captured as well
+     * @return True if adapters should report received frames
+     */
+    bool CapturesReceptions() const;
+
+    /**
+     * @brief Write the buffered frames to the current file
+     */
+    void Flush();
+
+    /**
+     * @brief Get the number of captured frames
+     * @return The number of frames
+     */
+    uint64_t GetFrames() const;
+
+    /**
+     * @brief Get the number of bytes written to all files
+     * @return The number of bytes
+     */
+    uint64_t GetBytesWritten() const;
+
+    /**
+     * @brief Get the number of files written
+     * @return The number of files
+     */
+    uint32_t GetFiles() const;
+
+protected:
+    /**
+     * @brief Dispose of the capture, writes the buffered frames
+     */
+    virtual void DoDispose() override;
+
+private:
+    /**
+     * @brief Parse the Stations attribute
+     * @param stations Comma-separated station IDs and ranges "a-b"
+     */
+    void SetStations(std::string stations);
+
+    /**
+     * @brief Get the Stations attribute
+     * @return The station filter
+     */
+    std::string GetStations() const;
+
+    /**
+     * @brief Check a station against the station filter
+     * @param stationId The station ID
+     * @return True if the station's frames are captured
+     */
+    bool IsSelected(uint32_t stationId) const;
+
+    /**
+     * @brief Open the next capture file and write its PCAP header
+     * @return True if the file could be opened
+     */
+    bool OpenNextFile();
+
+    /**
+     * @brief Write the buffered frames and close the current file
+     */
+    void Close();
+
+    // Configuration
+    std::string m_filePrefix;                                ///< Capture file name without extension
+    std::string m_stationsText;                              ///< Station filter as configured
+    std::vector<std::pair<uint32_t, uint32_t>> m_stations;   ///< Captured station ranges, all if empty
+    ns3::Time m_startTime;                                   ///< Begin of the capture window
+    ns3::Time m_stopTime;                                    ///< End of the capture window, none if zero
+    uint32_t m_bufferSize;                                   ///< Write buffer size in bytes
+    uint64_t m_maxFileSize;                                  ///< Rotation size in bytes, none if zero
+    uint32_t m_snapLength;                                   ///< Maximum captured bytes per frame
+    bool m_captureReceptions;                                ///< Also capture received frames
+
+    // State
+    std::FILE* m_file;                                       ///< Current capture file
+    std::vector<uint8_t> m_buffer;                           ///< Records not yet written
+    uint64_t m_fileSize;                                     ///< Bytes in the current file incl. buffer
+    uint32_t m_fileIndex;                                    ///< Number of files opened
+    uint64_t m_frames;                                       ///< Frames captured
+    uint64_t m_bytesWritten;                                 ///< Bytes written to all files
+    bool m_failed;                                           ///< A file could not be opened
+};
+
+} // namespace vanetza_ns3
+
+#endif // ITS_PCAP_CAPTURE_HPP
@@ -0,0 +1,321 @@
+#include "local_dynamic_map.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vanetza_ns3 {
+
+constexpr std::size_t LocalDynamicMap::npos;
+constexpr uint32_t LocalDynamicMap::kEmpty;
+constexpr std::size_t LocalDynamicMap::kWheelSize;
+
+namespace {
+
+const uint32_t kInitialSlots = 64;
+
+inline uint32_t hashStation(uint32_t stationId, uint32_t shift)
+{
+    // Fibonacci hashing spreads sequential station IDs over the table
+    return (stationId * 2654435769u) >> shift;
+}
+
+} // namespace
+
+LocalDynamicMap::LocalDynamicMap(int64_t lifetimeMs, double cellSize) :
+    m_lifetimeMs(1),
+    m_tickMs(1),
+    m_slotKeys(kInitialSlots, 0),
+    m_slotIndex(kInitialSlots, kEmpty),
+    m_shift(26),
+    m_lastTick(-1),
+    m_grid(cellSize),
+    m_drift(0.0f),
+    m_gridStale(true)
+{
+    setLifetime(lifetimeMs);
+}
+
+void
+LocalDynamicMap::setLifetime(int64_t lifetimeMs)
+{
+    m_lifetimeMs = std::max<int64_t>(lifetimeMs, 1);
+    // Half the wheel covers one lifetime, so a reference never laps the wheel
+    m_tickMs = std::max<int64_t>(m_lifetimeMs / static_cast<int64_t>(kWheelSize / 2), 1);
+    
+    for (std::vector<ExpiryRef>& bucket : m_wheel) {
+        bucket.clear();
+    }
+    m_lastTick = -1;
+    for (std::size_t i = 0; i < m_ids.size(); ++i) {
+        scheduleExpiry(i);
+    }
+}
+
+void
+LocalDynamicMap::update(uint32_t stationId, float x, float y, float speed, float heading, int64_t nowMs)
+{
+    uint32_t slot = slotFor(stationId);
+    uint32_t index = m_slotIndex[slot];
+    
+    if (index != kEmpty) {
+        m_x[index] = x;
+        m_y[index] = y;
+        m_speed[index] = speed;
+        m_heading[index] = heading;
+        m_lastUpdate[index] = nowMs;
+        if (!m_gridStale) {
+            const float dx = x - m_gridX[index];
+            const float dy = y - m_gridY[index];
+            m_drift = std::max(m_drift, std::sqrt(dx * dx + dy * dy));
+        }
+        return;
+    }
+    
+    if ((m_ids.size() + 1) * 10 > m_slotIndex.size() * 7) {
+        grow();
+        slot = slotFor(stationId);
+    }
+    
+    index = static_cast<uint32_t>(m_ids.size());
+    m_slotKeys[slot] = stationId;
+    m_slotIndex[slot] = index;
+    m_ids.push_back(stationId);
+    m_x.push_back(x);
+    m_y.push_back(y);
+    m_speed.push_back(speed);
+    m_heading.push_back(heading);
+    m_lastUpdate.push_back(nowMs);
+    m_wheelTick.push_back(0);
+    scheduleExpiry(index);
+    m_gridStale = true;
+}
+
+bool
+LocalDynamicMap::remove(uint32_t stationId)
+{
+    std::size_t index = find(stationId);
+    if (index == npos) {
+        return false;
+    }
+    removeAt(index);
+    return true;
+}
+
+std::size_t
+LocalDynamicMap::purgeExpired(int64_t nowMs)
+{
+    const int64_t nowTick = nowMs / m_tickMs;
+    int64_t tick = std::max(m_lastTick + 1, nowTick - static_cast<int64_t>(kWheelSize) + 1);
+    std::size_t removed = 0;
+    
+    for (; tick <= nowTick; ++tick) {
+        std::vector<ExpiryRef>& bucket = m_wheel[tick % kWheelSize];
+        m_expiring.swap(bucket);
+        
+        for (const ExpiryRef& ref : m_expiring) {
+            if (ref.tick > nowTick) {
+                // Scheduled for a later lap of the wheel
+                bucket.push_back(ref);
+                continue;
+            }
+            std::size_t index = find(ref.stationId);
+            if (index == npos || m_wheelTick[index] != ref.tick) {
+                // Entry was removed, or this reference was superseded
+                continue;
+            }
+            if (m_lastUpdate[index] + m_lifetimeMs <= nowMs) {
+                removeAt(index);
+                ++removed;
+            } else {
+                scheduleExpiry(index);
+            }
+        }
+        m_expiring.clear();
+    }
+    
+    m_lastTick = std::max(m_lastTick, nowTick);
+    return removed;
+}
+
+void
+LocalDynamicMap::clear()
+{
+    m_ids.clear();
+    m_x.clear();
+    m_y.clear();
+    m_speed.clear();
+    m_heading.clear();
+    m_lastUpdate.clear();
+    m_wheelTick.clear();
+    std::fill(m_slotIndex.begin(), m_slotIndex.end(), kEmpty);
+    for (std::vector<ExpiryRef>& bucket : m_wheel) {
+        bucket.clear();
+    }
+    m_lastTick = -1;
+    m_gridStale = true;
+}
+
+std::size_t
+LocalDynamicMap::find(uint32_t stationId) const
+{
+    uint32_t index = m_slotIndex[slotFor(stationId)];
+    return index == kEmpty ? npos : index;
+}
+
+std::size_t
+LocalDynamicMap::neighboursWithin(float x, float y, float radius, std::vector<uint32_t>& out) const
+{
+    out.clear();
+    forEachWithin(x, y, radius, [&](uint32_t index, float) {
+        out.push_back(m_ids[index]);
+    });
+    return out.size();
+}
+
+std::size_t
+LocalDynamicMap::nearest(float x, float y, std::size_t k, std::vector<uint32_t>& out) const
+{
+    out.clear();
+    if (k == 0 || m_ids.empty()) {
+        return 0;
+    }
+    
+    // Widen the search until it holds k entries (or all of them)
+    float radius = static_cast<float>(m_grid.cellSize());
+    for (;;) {
+        m_scratch.clear();
+        forEachWithin(x, y, radius, [&](uint32_t index, float d2) {
+            m_scratch.emplace_back(d2, m_ids[index]);
+        });
+        if (m_scratch.size() >= k || m_scratch.size() == m_ids.size()) {
+            break;
+        }
+        radius *= 2.0f;
+    }
+    
+    const std::size_t n = std::min(k, m_scratch.size());
+    std::partial_sort(m_scratch.begin(), m_scratch.begin() + n, m_scratch.end());
+    for (std::size_t i = 0; i < n; ++i) {
+        out.push_back(m_scratch[i].second);
+    }
+    return n;
+}
+
+uint32_t
+LocalDynamicMap::slotFor(uint32_t stationId) const
+{
+    const uint32_t mask = static_cast<uint32_t>(m_slotIndex.size() - 1);
+    uint32_t slot = hashStation(stationId, m_shift);
+    while (m_slotIndex[slot] != kEmpty && m_slotKeys[slot] != stationId) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void
+LocalDynamicMap::grow()
+{
+    const std::size_t slots = m_slotIndex.size() * 2;
+    m_slotKeys.assign(slots, 0);
+    m_slotIndex.assign(slots, kEmpty);
+    --m_shift;
+    for (std::size_t i = 0; i < m_ids.size(); ++i) {
+        uint32_t slot = slotFor(m_ids[i]);
+        m_slotKeys[slot] = m_ids[i];
+        m_slotIndex[slot] = static_cast<uint32_t>(i);
+    }
+}
+
+void
+LocalDynamicMap::eraseSlot(uint32_t slot)
+{
+    // Backward-shift deletion keeps probe chains intact without tombstones
+    const uint32_t mask = static_cast<uint32_t>(m_slotIndex.size() - 1);
+    uint32_t hole = slot;
+    uint32_t next = slot;
+    for (;;) {
+        next = (next + 1) & mask;
+        if (m_slotIndex[next] == kEmpty) {
+            break;
+        }
+        const uint32_t home = hashStation(m_slotKeys[next], m_shift);
+        // Move the entry unless its home lies cyclically within (hole, next]
+        const bool stays = hole <= next ? (hole < home && home <= next)
+                                        : (hole < home || home <= next);
+        if (!stays) {
+            m_slotKeys[hole] = m_slotKeys[next];
+            m_slotIndex[hole] = m_slotIndex[next];
+            hole = next;
+        }
+    }
+    m_slotIndex[hole] = kEmpty;
+}
+
+void
+LocalDynamicMap::removeAt(std::size_t index)
+{
+    eraseSlot(slotFor(m_ids[index]));
+    
+    // Keep the arrays dense by moving the last entry into the gap
+    const std::size_t last = m_ids.size() - 1;
+    if (index != last) {
+        m_ids[index] = m_ids[last];
+        m_x[index] = m_x[last];
+        m_y[index] = m_y[last];
+        m_speed[index] = m_speed[last];
+        m_heading[index] = m_heading[last];
+        m_lastUpdate[index] = m_lastUpdate[last];
+        m_wheelTick[index] = m_wheelTick[last];
+        m_slotIndex[slotFor(m_ids[index])] = static_cast<uint32_t>(index);
+    }
+    m_ids.pop_back();
+    m_x.pop_back();
+    m_y.pop_back();
+    m_speed.pop_back();
+    m_heading.pop_back();
+    m_lastUpdate.pop_back();
+    m_wheelTick.pop_back();
+    m_gridStale = true;
+}
+
+void
+LocalDynamicMap::scheduleExpiry(std::size_t index)
+{
+    const uint32_t tick = static_cast<uint32_t>((m_lastUpdate[index] + m_lifetimeMs) / m_tickMs + 1);
+    m_wheel[tick % kWheelSize].push_back(ExpiryRef{m_ids[index], tick});
+    m_wheelTick[index] = tick;
+}
+
+void
+LocalDynamicMap::refreshGrid() const
+{
+    if (!m_gridStale && m_drift <= 0.5f * static_cast<float>(m_grid.cellSize())) {
+        return;
+    }
+    m_gridX = m_x;
+    m_gridY = m_y;
+    m_grid.build(m_gridX.data(), m_gridY.data(), m_gridX.size());
+    m_drift = 0.0f;
+    m_gridStale = false;
+}
+
+template<typename Visitor>
+void
+LocalDynamicMap::forEachWithin(float x, float y, float radius, Visitor&& visit) const
+{
+    refreshGrid();
+    
+    // The grid knows positions as of the last rebuild; widen by the drift
+    // since then and filter on the current positions.
+    const float r2 = radius * radius;
+    m_grid.forEachWithin(x, y, radius + m_drift, [&](uint32_t index, float) {
+        const float dx = m_x[index] - x;
+        const float dy = m_y[index] - y;
+        const float d2 = dx * dx + dy * dy;
+        if (d2 <= r2) {
+            visit(index, d2);
+        }
+    });
+}
+
+} // namespace vanetza_ns3
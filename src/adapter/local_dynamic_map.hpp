@@ -0,0 +1,174 @@
+#ifndef LOCAL_DYNAMIC_MAP_HPP
+#define LOCAL_DYNAMIC_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "utils/uniform_grid.hpp"
+
+namespace vanetza_ns3 {
+
+/**
+ * @brief Local Dynamic Map holding the latest state of neighbouring stations
+ * 
+ * Neighbour state is stored densely as a structure of arrays (position,
+ * speed, heading, last update) addressed through an open-addressed hash
+ * table keyed by station ID. Stale entries are purged through an expiry
+ * wheel, so purging costs time proportional to the expired entries only.
+ * Spatial queries use a uniform grid that is rebuilt lazily: positions may
+ * drift from their indexed location by up to half a cell before a rebuild,
+ * and queries widen their search radius by the observed drift.
+ */
+class LocalDynamicMap {
+public:
+    /**
+     * @brief Index value returned when a station is unknown
+     */
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /**
+     * @brief Constructor
+     * @param lifetimeMs Time after which an entry without update expires
+     * @param cellSize Edge length of the spatial grid cells in meters
+     */
+    explicit LocalDynamicMap(int64_t lifetimeMs = 1100, double cellSize = 100.0);
+
+    /**
+     * @brief Set the time after which an entry without update expires
+     * @param lifetimeMs Lifetime in milliseconds
+     */
+    void setLifetime(int64_t lifetimeMs);
+
+    /**
+     * @brief Insert or refresh the state of a neighbour
+     * @param stationId Station ID of the neighbour
+     * @param x X position in meters
+     * @param y Y position in meters
+     * @param speed Speed in m/s
+     * @param heading Heading in degrees
+     * @param nowMs Current time in milliseconds
+     */
+    void update(uint32_t stationId, float x, float y, float speed, float heading, int64_t nowMs);
+
+    /**
+     * @brief Remove a neighbour
+     * @param stationId Station ID of the neighbour
+     * @return True if the neighbour was known
+     */
+    bool remove(uint32_t stationId);
+
+    /**
+     * @brief Remove all entries not updated within the lifetime
+     * 
+     * Expiry is checked per wheel tick (one eighth of the lifetime), so an
+     * entry may outlive its lifetime by up to one tick.
+     * @param nowMs Current time in milliseconds
+     * @return Number of removed entries
+     */
+    std::size_t purgeExpired(int64_t nowMs);
+
+    /**
+     * @brief Remove all entries
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of known neighbours
+     * @return The number of entries
+     */
+    std::size_t size() const { return m_ids.size(); }
+
+    /**
+     * @brief Look up the dense index of a neighbour
+     * @param stationId Station ID of the neighbour
+     * @return The index, or npos if unknown
+     */
+    std::size_t find(uint32_t stationId) const;
+
+    // Dense per-entry accessors, valid for index < size()
+    uint32_t stationId(std::size_t i) const { return m_ids[i]; }
+    float x(std::size_t i) const { return m_x[i]; }
+    float y(std::size_t i) const { return m_y[i]; }
+    float speed(std::size_t i) const { return m_speed[i]; }
+    float heading(std::size_t i) const { return m_heading[i]; }
+    int64_t lastUpdate(std::size_t i) const { return m_lastUpdate[i]; }
+
+    /**
+     * @brief Collect all neighbours within a radius
+     * @param x X coordinate of the query center
+     * @param y Y coordinate of the query center
+     * @param radius Query radius in meters
+     * @param out Receives the station IDs (cleared first)
+     * @return Number of neighbours found
+     */
+    std::size_t neighboursWithin(float x, float y, float radius, std::vector<uint32_t>& out) const;
+
+    /**
+     * @brief Collect the k nearest neighbours, closest first
+     * @param x X coordinate of the query center
+     * @param y Y coordinate of the query center
+     * @param k Maximum number of neighbours
+     * @param out Receives the station IDs (cleared first)
+     * @return Number of neighbours found
+     */
+    std::size_t nearest(float x, float y, std::size_t k, std::vector<uint32_t>& out) const;
+
+private:
+    static constexpr uint32_t kEmpty = UINT32_MAX;
+    static constexpr std::size_t kWheelSize = 16;
+
+    /**
+     * @brief Reference to an entry in an expiry wheel bucket
+     */
+    struct ExpiryRef {
+        uint32_t stationId;                  ///< Station ID of the entry
+        uint32_t tick;                       ///< Tick the reference was scheduled for
+    };
+
+    uint32_t slotFor(uint32_t stationId) const;
+    void grow();
+    void eraseSlot(uint32_t slot);
+    void removeAt(std::size_t index);
+    void scheduleExpiry(std::size_t index);
+    void refreshGrid() const;
+
+    template<typename Visitor>
+    void forEachWithin(float x, float y, float radius, Visitor&& visit) const;
+
+    // Configuration
+    int64_t m_lifetimeMs;                    ///< Entry lifetime
+    int64_t m_tickMs;                        ///< Expiry wheel granularity
+
+    // Dense neighbour state (structure of arrays)
+    std::vector<uint32_t> m_ids;             ///< Station IDs
+    std::vector<float> m_x;                  ///< X positions
+    std::vector<float> m_y;                  ///< Y positions
+    std::vector<float> m_speed;              ///< Speeds
+    std::vector<float> m_heading;            ///< Headings
+    std::vector<int64_t> m_lastUpdate;       ///< Times of last update
+    std::vector<uint32_t> m_wheelTick;       ///< Tick of the entry's live expiry reference
+
+    // Open-addressed station table (linear probing)
+    std::vector<uint32_t> m_slotKeys;        ///< Station ID per slot
+    std::vector<uint32_t> m_slotIndex;       ///< Dense index per slot, kEmpty if free
+    uint32_t m_shift;                        ///< 32 - log2(slot count)
+
+    // Expiry wheel
+    std::vector<ExpiryRef> m_wheel[kWheelSize]; ///< Expiry references per tick bucket
+    std::vector<ExpiryRef> m_expiring;       ///< Scratch for the bucket being processed
+    int64_t m_lastTick;                      ///< Last processed tick
+
+    // Spatial index
+    mutable utils::UniformGrid m_grid;       ///< Grid over the indexed positions
+    mutable std::vector<float> m_gridX;      ///< Positions at the last rebuild (x)
+    mutable std::vector<float> m_gridY;      ///< Positions at the last rebuild (y)
+    mutable float m_drift;                   ///< Largest displacement since the last rebuild
+    mutable bool m_gridStale;                ///< Entries were added or removed
+    mutable std::vector<std::pair<float, uint32_t> > m_scratch; ///< k-nearest scratch
+};
+
+} // namespace vanetza_ns3
+
+#endif // LOCAL_DYNAMIC_MAP_HPP
@@ -1,9 +1,16 @@
 #include "ns3_interface.hpp"
+#include "geonet_shb_header.hpp"
+#include "btp_b_header.hpp"
+#include "messages/etsi_position.hpp"
 
 #include <ns3/log.h>
 #include <ns3/packet.h>
 #include <ns3/simulator.h>
 #include <ns3/mac48-address.h>
+#include <ns3/mobility-model.h>
+#include <ns3/node.h>
+
+#include <cmath>
 
 namespace vanetza_ns3 {
 
@@ -42,13 +49,66 @@ NS3Interface::sendPacket(const uint8_t* buffer, std::size_t length)
     }
     
     // Create NS3 packet from buffer
-    ns3::Ptr<ns3::Packet> packet = ns3::Create<ns3::Packet>(buffer, length);
+    return sendPacket(ns3::Create<ns3::Packet>(buffer, length));
+}
+
+bool
+NS3Interface::sendPacket(ns3::Ptr<ns3::Packet> packet)
+{
+    NS_LOG_FUNCTION(this << packet);
+    
+    if (!m_device) {
+        NS_LOG_ERROR("No device set for NS3Interface");
+        return false;
+    }
     
-    // Send packet using the device
-    // Protocol number 0x8947 is used for ETSI ITS-G5 (example value)
+    // EtherType 0x8947 is GeoNetworking
     return m_device->Send(packet, ns3::Mac48Address::GetBroadcast(), 0x8947);
 }
 
+bool
+NS3Interface::sendShb(ns3::Ptr<ns3::Packet> packet, uint16_t destinationPort)
+{
+    NS_LOG_FUNCTION(this << packet << destinationPort);
+    
+    addShbHeaders(packet, destinationPort);
+    return sendPacket(packet);
+}
+
+void
+NS3Interface::addShbHeaders(ns3::Ptr<ns3::Packet> packet, uint16_t destinationPort) const
+{
+    NS_LOG_FUNCTION(this << packet << destinationPort);
+    
+    packet->AddHeader(BtpBHeader(destinationPort));
+    
+    GeoNetShbHeader gn;
+    gn.SetSource(getMacAddress(), static_cast<uint8_t>(m_profile.stationType),
+                 static_cast<uint32_t>(ns3::Simulator::Now().GetMilliSeconds()));
+    gn.SetPayloadLength(static_cast<uint16_t>(packet->GetSize()));
+    ns3::Ptr<ns3::Node> node = m_device ? m_device->GetNode() : nullptr;
+    ns3::Ptr<ns3::MobilityModel> mobility = node ? node->GetObject<ns3::MobilityModel>() : nullptr;
+    if (mobility) {
+        // Same mapping as the CAM reference position
+        const ns3::Vector position = mobility->GetPosition();
+        const ns3::Vector velocity = mobility->GetVelocity();
+        const messages::EtsiPosition etsi = messages::toEtsiPosition(position.x, position.y,
+                                                                     m_profile.originLatitude,
+                                                                     m_profile.originLongitude);
+        gn.SetPosition(etsi.latitude, etsi.longitude, true);
+        gn.SetMotion(static_cast<int32_t>(std::lround(std::hypot(velocity.x, velocity.y) * 100.0)),
+                     messages::toEtsiHeading(std::atan2(velocity.y, velocity.x) * 180.0 / M_PI));
+    }
+    packet->AddHeader(gn);
+}
+
+void
+NS3Interface::setVehicleProfile(const messages::CamVehicleProfile& profile)
+{
+    NS_LOG_FUNCTION(this);
+    m_profile = profile;
+}
+
 ns3::Mac48Address
 NS3Interface::getMacAddress() const
 {
@@ -7,8 +7,11 @@
 #include <ns3/net-device.h>
 #include <ns3/ptr.h>
 #include <ns3/mac48-address.h>
+#include <ns3/packet.h>
 #include <vanetza/geonet/link_layer.hpp>
 
+#include "messages/uper_cam_encoder.hpp"
+
 // Forward declarations for other Vanetza components
 namespace vanetza {
     namespace geonet {
@@ -24,6 +27,10 @@ namespace vanetza_ns3 {
  * This class implements the necessary functionality to bridge NS3's
  * network devices with Vanetza's link layer interface. It handles
  * packet transmission and reception between the two frameworks.
+ * 
+ * Payloads are sent as GeoNetworking Single-Hop Broadcasts: the BTP-B and
+ * GeoNetworking headers are added to the ns3::Packet holding the payload,
+ * so the payload is copied into a packet once and never flattened again.
  */
 class NS3Interface : public vanetza::geonet::LinkLayer {
 public:
@@ -53,6 +60,36 @@ public:
      */
     bool sendPacket(const uint8_t* buffer, std::size_t length);
 
+    /**
+     * @brief Send a complete frame from Vanetza to NS3 without copying it
+     * @param packet The frame, GeoNetworking headers included
+     * @return True if the packet was sent successfully
+     */
+    bool sendPacket(ns3::Ptr<ns3::Packet> packet);
+
+    /**
+     * @brief Send a payload as GeoNetworking Single-Hop Broadcast with a BTP-B header
+     * 
+     * The source position vector is taken from the node's mobility model.
+     * @param packet The payload, the headers are added in place
+     * @param destinationPort The BTP destination port
+     * @return True if the packet was sent successfully
+     */
+    bool sendShb(ns3::Ptr<ns3::Packet> packet, uint16_t destinationPort);
+
+    /**
+     * @brief Add the BTP-B and GeoNetworking SHB headers to a payload
+     * @param packet The payload, the headers are added in place
+     * @param destinationPort The BTP destination port
+     */
+    void addShbHeaders(ns3::Ptr<ns3::Packet> packet, uint16_t destinationPort) const;
+
+    /**
+     * @brief Set the station type and the geographic origin used in the position vector
+     * @param profile The vehicle profile of the station
+     */
+    void setVehicleProfile(const messages::CamVehicleProfile& profile);
+
     /**
      * @brief Get the MAC address of the interface
      * @return The MAC address
@@ -67,6 +104,7 @@ public:
 
 private:
     ns3::Ptr<ns3::NetDevice> m_device;  ///< The NS3 network device
+    messages::CamVehicleProfile m_profile;  ///< Station type and geographic origin
     std::function<void(const uint8_t*, std::size_t)> m_packetHandler;  ///< Callback for received packets
 };
 
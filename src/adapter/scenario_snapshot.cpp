@@ -0,0 +1,299 @@
+#include "scenario_snapshot.hpp"
+#include "vanetza_ns3_adapter.hpp"
+#include "cam_application.hpp"
+#include "mobility/fleet_mobility_store.hpp"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/node.h>
+#include <ns3/mobility-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-velocity-mobility-model.h>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("ScenarioSnapshot");
+
+namespace {
+
+/**
+ * @brief Start of a snapshot file
+ */
+struct SnapshotHeader {
+    char magic[8];                ///< "VNSNAP01"
+    uint32_t version;             ///< Format version
+    uint32_t stationCount;        ///< Number of station records
+    int64_t timeNs;               ///< Simulation time of the snapshot
+};
+
+/**
+ * @brief State of one station, followed by its neighbour records
+ */
+struct StationRecord {
+    double position[3];           ///< Node position
+    double velocity[3];           ///< Node velocity
+    int64_t adapterNextNs;        ///< Time until the adapter's next CAM, -1 if none
+    int64_t applicationNextNs;    ///< Time until the application's next check, -1 if none
+    int64_t serviceLowFrequencyMs; ///< Last low-frequency container of the CAM service
+    int64_t lastCamMs;            ///< CamTriggerState::lastCamMs
+    int64_t lastLowFrequencyMs;   ///< CamTriggerState::lastLowFrequencyMs
+    uint32_t adapterStationId;    ///< Station ID of the adapter
+    uint32_t applicationStationId; ///< Station ID of the CAM application
+    float lastX;                  ///< CamTriggerState::lastX
+    float lastY;                  ///< CamTriggerState::lastY
+    float lastSpeed;              ///< CamTriggerState::lastSpeed
+    float lastHeading;            ///< CamTriggerState::lastHeading
+    uint32_t neighbours;          ///< Number of neighbour records that follow
+    uint16_t genCamMs;            ///< CamTriggerState::genCamMs
+    uint16_t genCamDccMs;         ///< CamTriggerState::genCamDccMs
+    uint8_t nGenCamCount;         ///< CamTriggerState::nGenCamCount
+    uint8_t hasMobility;          ///< Non-zero if position and velocity are valid
+    uint8_t reserved[6];          ///< Zero
+};
+
+/**
+ * @brief One entry of a station's Local Dynamic Map
+ */
+struct NeighbourRecord {
+    int64_t lastUpdateMs;         ///< Time of the neighbour's last CAM
+    uint32_t stationId;           ///< Station ID of the neighbour
+    float x;                      ///< X position
+    float y;                      ///< Y position
+    float speed;                  ///< Speed
+    float heading;                ///< Heading in degrees
+    uint32_t reserved;            ///< Zero
+};
+
+const char kSnapshotMagic[8] = { 'V', 'N', 'S', 'N', 'A', 'P', '0', '1' };
+const uint32_t kSnapshotVersion = 1;
+
+static_assert(sizeof(SnapshotHeader) == 24, "SnapshotHeader must be 24 bytes");
+static_assert(sizeof(StationRecord) == 128, "StationRecord must be 128 bytes");
+static_assert(sizeof(NeighbourRecord) == 32, "NeighbourRecord must be 32 bytes");
+
+template<typename T>
+bool
+readRecord(std::istream& in, T& record)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&record), sizeof(record)));
+}
+
+template<typename T>
+void
+writeRecord(std::ostream& out, const T& record)
+{
+    out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+}
+
+/**
+ * @brief Put the captured position and velocity back into a node's mobility model
+ */
+void
+restoreMobility(ns3::Ptr<ns3::Node> node, const StationRecord& record)
+{
+    ns3::Ptr<ns3::MobilityModel> model = node->GetObject<ns3::MobilityModel>();
+    if (!model || !record.hasMobility) {
+        return;
+    }
+    
+    const ns3::Vector position(record.position[0], record.position[1], record.position[2]);
+    const ns3::Vector velocity(record.velocity[0], record.velocity[1], record.velocity[2]);
+    if (ns3::Ptr<ns3::ConstantVelocityMobilityModel> cv = ns3::DynamicCast<ns3::ConstantVelocityMobilityModel>(model)) {
+        cv->SetPosition(position);
+        cv->SetVelocity(velocity);
+    } else if (ns3::Ptr<FleetMobilityModel> fleet = ns3::DynamicCast<FleetMobilityModel>(model)) {
+        fleet->SetPosition(position);
+        fleet->SetVelocity(velocity);
+    } else if (ns3::DynamicCast<ns3::ConstantPositionMobilityModel>(model)) {
+        model->SetPosition(position);
+    }
+}
+
+/**
+ * @brief Read the station records and hand them to the stations about to start
+ */
+void
+applyStations(std::shared_ptr<std::ifstream> in,
+              std::vector<ns3::Ptr<VanetzaNS3Adapter> > adapters,
+              std::vector<ns3::Ptr<CamApplication> > applications)
+{
+    auto wallStart = std::chrono::steady_clock::now();
+    uint64_t neighbours = 0;
+    
+    for (std::size_t i = 0; i < adapters.size(); ++i) {
+        StationRecord record;
+        if (!readRecord(*in, record)) {
+            NS_FATAL_ERROR("Snapshot truncated at station " << i);
+        }
+    
+        AdapterSnapshot adapterState;
+        adapterState.stationId = record.adapterStationId;
+        adapterState.nextCamNs = record.adapterNextNs;
+        adapterState.lastLowFrequencyMs = record.serviceLowFrequencyMs;
+        adapters[i]->RestoreState(adapterState);
+    
+        CamApplicationSnapshot applicationState;
+        applicationState.stationId = record.applicationStationId;
+        applicationState.nextGenerationNs = record.applicationNextNs;
+        applicationState.trigger.lastCamMs = record.lastCamMs;
+        applicationState.trigger.lastLowFrequencyMs = record.lastLowFrequencyMs;
+        applicationState.trigger.lastX = record.lastX;
+        applicationState.trigger.lastY = record.lastY;
+        applicationState.trigger.lastSpeed = record.lastSpeed;
+        applicationState.trigger.lastHeading = record.lastHeading;
+        applicationState.trigger.genCamMs = record.genCamMs;
+        applicationState.trigger.genCamDccMs = record.genCamDccMs;
+        applicationState.trigger.nGenCamCount = record.nGenCamCount;
+        applications[i]->RestoreState(applicationState);
+    
+        for (uint32_t n = 0; n < record.neighbours; ++n) {
+            NeighbourRecord neighbour;
+            if (!readRecord(*in, neighbour)) {
+                NS_FATAL_ERROR("Snapshot truncated in the neighbours of station " << i);
+            }
+            applications[i]->RestoreNeighbour(neighbour.stationId, neighbour.x, neighbour.y,
+                                              neighbour.speed, neighbour.heading, neighbour.lastUpdateMs);
+        }
+        neighbours += record.neighbours;
+    
+        restoreMobility(adapters[i]->GetNode(), record);
+    }
+    
+    NS_LOG_INFO("Restored " << adapters.size() << " stations and " << neighbours << " neighbours in "
+                << std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count() << " s");
+}
+
+} // namespace
+
+bool
+ScenarioSnapshot::Save(const std::string& path,
+                       const std::vector<ns3::Ptr<VanetzaNS3Adapter> >& adapters,
+                       const std::vector<ns3::Ptr<CamApplication> >& applications)
+{
+    NS_LOG_FUNCTION(path << adapters.size());
+    
+    if (adapters.size() != applications.size()) {
+        NS_LOG_ERROR("Snapshot needs one CAM application per adapter");
+        return false;
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        NS_LOG_ERROR("Cannot write snapshot " << path);
+        return false;
+    }
+    
+    SnapshotHeader header;
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+    header.version = kSnapshotVersion;
+    header.stationCount = static_cast<uint32_t>(adapters.size());
+    header.timeNs = ns3::Simulator::Now().GetNanoSeconds();
+    writeRecord(out, header);
+    
+    for (std::size_t i = 0; i < adapters.size(); ++i) {
+        const AdapterSnapshot adapterState = adapters[i]->SaveState();
+        const CamApplicationSnapshot applicationState = applications[i]->SaveState();
+        const LocalDynamicMap& ldm = applications[i]->GetLocalDynamicMap();
+    
+        StationRecord record;
+        std::memset(&record, 0, sizeof(record));
+        ns3::Ptr<ns3::MobilityModel> model = adapters[i]->GetNode()->GetObject<ns3::MobilityModel>();
+        if (model) {
+            const ns3::Vector position = model->GetPosition();
+            const ns3::Vector velocity = model->GetVelocity();
+            record.position[0] = position.x;
+            record.position[1] = position.y;
+            record.position[2] = position.z;
+            record.velocity[0] = velocity.x;
+            record.velocity[1] = velocity.y;
+            record.velocity[2] = velocity.z;
+            record.hasMobility = 1;
+        }
+        record.adapterNextNs = adapterState.nextCamNs;
+        record.applicationNextNs = applicationState.nextGenerationNs;
+        record.serviceLowFrequencyMs = adapterState.lastLowFrequencyMs;
+        record.lastCamMs = applicationState.trigger.lastCamMs;
+        record.lastLowFrequencyMs = applicationState.trigger.lastLowFrequencyMs;
+        record.adapterStationId = adapterState.stationId;
+        record.applicationStationId = applicationState.stationId;
+        record.lastX = applicationState.trigger.lastX;
+        record.lastY = applicationState.trigger.lastY;
+        record.lastSpeed = applicationState.trigger.lastSpeed;
+        record.lastHeading = applicationState.trigger.lastHeading;
+        record.neighbours = static_cast<uint32_t>(ldm.size());
+        record.genCamMs = applicationState.trigger.genCamMs;
+        record.genCamDccMs = applicationState.trigger.genCamDccMs;
+        record.nGenCamCount = applicationState.trigger.nGenCamCount;
+        writeRecord(out, record);
+    
+        for (std::size_t n = 0; n < ldm.size(); ++n) {
+            NeighbourRecord neighbour;
+            neighbour.lastUpdateMs = ldm.lastUpdate(n);
+            neighbour.stationId = ldm.stationId(n);
+            neighbour.x = ldm.x(n);
+            neighbour.y = ldm.y(n);
+            neighbour.speed = ldm.speed(n);
+            neighbour.heading = ldm.heading(n);
+            neighbour.reserved = 0;
+            writeRecord(out, neighbour);
+        }
+    }
+    
+    out.flush();
+    if (!out) {
+        NS_LOG_ERROR("Cannot write snapshot " << path);
+        return false;
+    }
+    return true;
+}
+
+bool
+ScenarioSnapshot::Restore(const std::string& path,
+                          const std::vector<ns3::Ptr<VanetzaNS3Adapter> >& adapters,
+                          const std::vector<ns3::Ptr<CamApplication> >& applications,
+                          ns3::Time* resumeTime)
+{
+    NS_LOG_FUNCTION(path << adapters.size());
+    
+    std::shared_ptr<std::ifstream> in = std::make_shared<std::ifstream>(path, std::ios::binary);
+    SnapshotHeader header;
+    if (!*in || !readRecord(*in, header)) {
+        NS_LOG_ERROR("Cannot read snapshot " << path);
+        return false;
+    }
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0 ||
+        header.version != kSnapshotVersion) {
+        NS_LOG_ERROR(path << " is not a snapshot of version " << kSnapshotVersion);
+        return false;
+    }
+    if (header.stationCount != adapters.size() || adapters.size() != applications.size()) {
+        NS_LOG_ERROR("Snapshot holds " << header.stationCount << " stations, the scenario has "
+                     << adapters.size());
+        return false;
+    }
+    
+    const ns3::Time at = ns3::NanoSeconds(header.timeNs);
+    if (at < ns3::Simulator::Now()) {
+        NS_LOG_ERROR("Snapshot time " << at.GetSeconds() << " s has already passed");
+        return false;
+    }
+    
+    // The stations are read and applied by an event scheduled ahead of
+    // their start events, which are only scheduled once the simulation runs
+    for (std::size_t i = 0; i < adapters.size(); ++i) {
+        adapters[i]->SetStartTime(at);
+        applications[i]->SetStartTime(at);
+    }
+    ns3::Simulator::Schedule(at - ns3::Simulator::Now(), &applyStations, in, adapters, applications);
+    
+    if (resumeTime) {
+        *resumeTime = at;
+    }
+    return true;
+}
+
+} // namespace vanetza_ns3
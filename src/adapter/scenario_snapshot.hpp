@@ -0,0 +1,70 @@
+#ifndef SCENARIO_SNAPSHOT_HPP
+#define SCENARIO_SNAPSHOT_HPP
+
+#include <string>
+#include <vector>
+#include <ns3/ptr.h>
+#include <ns3/nstime.h>
+
+namespace vanetza_ns3 {
+
+// Forward declarations
+class VanetzaNS3Adapter;
+class CamApplication;
+
+/**
+ * @brief Saves the steady state of a scenario's stations and resumes from it
+ *
+ * A snapshot taken at time T holds, per station, the station ID, the CAM
+ * generation state of the adapter and the CAM application (trigger state
+ * and the phase of their pending generation), the Local Dynamic Map, and
+ * the position and velocity of the node.
+ *
+ * Restoring it into a freshly built scenario with the same stations moves
+ * their start to T. ns-3 cannot begin a run at T, but with no station
+ * running before T the simulator reaches it without executing events, so
+ * the run resumes where the snapshot was taken instead of repeating the
+ * warm-up. Mobility models that derive the position from the simulation
+ * time (trace replay, waypoints) are left alone; constant-velocity and
+ * fleet models get the captured position and velocity.
+ *
+ * The file is a stream of fixed-size records in host byte order: a header
+ * (magic "VNSNAP01", version, station count, T), then per station one
+ * station record followed by its LDM entries. Both directions stream one
+ * station at a time, so the snapshot is never held in memory as a whole.
+ * Pooled stations (FleetManager) are not supported.
+ */
+class ScenarioSnapshot {
+public:
+    /**
+     * @brief Write the state of running stations at the current time
+     * @param path The snapshot file
+     * @param adapters The adapters of the stations
+     * @param applications The CAM applications, one per adapter
+     * @return True if the snapshot was written completely
+     */
+    static bool Save(const std::string& path,
+                     const std::vector<ns3::Ptr<VanetzaNS3Adapter> >& adapters,
+                     const std::vector<ns3::Ptr<CamApplication> >& applications);
+
+    /**
+     * @brief Resume freshly built stations from a snapshot
+     *
+     * Must be called before Simulator::Run(). Checks the header, sets the
+     * start time of all stations to the snapshot time and schedules the
+     * stations to be read and applied just before they start.
+     * @param path The snapshot file
+     * @param adapters The adapters of the stations, in the order they were saved
+     * @param applications The CAM applications, one per adapter
+     * @param resumeTime Receives the snapshot time, may be nullptr
+     * @return True if the snapshot matches the stations
+     */
+    static bool Restore(const std::string& path,
+                        const std::vector<ns3::Ptr<VanetzaNS3Adapter> >& adapters,
+                        const std::vector<ns3::Ptr<CamApplication> >& applications,
+                        ns3::Time* resumeTime = nullptr);
+};
+
+} // namespace vanetza_ns3
+
+#endif // SCENARIO_SNAPSHOT_HPP
@@ -0,0 +1,42 @@
+#ifndef STATION_METRICS_HPP
+#define STATION_METRICS_HPP
+
+#include <cstdint>
+
+namespace vanetza_ns3 {
+
+/**
+ * @brief Event counters of one ITS station
+ * 
+ * Plain counters owned by the station's VanetzaNS3Adapter and incremented
+ * inline on the hot path: no virtual calls, no trace sources, no string
+ * formatting. The simulator runs a station's events on a single thread,
+ * so no synchronisation is needed. Read them through the adapter's
+ * attributes or collect them with FleetMetricsCollector.
+ * 
+ * Every ITS frame the device delivers to a running station counts exactly
+ * once, either as received or as rejected.
+ */
+struct StationMetrics {
+    uint64_t camsGenerated = 0;       ///< CAMs built by the CAM application or the adapter's stack
+    uint64_t camsSent = 0;            ///< CAMs accepted by the network device
+    uint64_t sendFailures = 0;        ///< CAMs the device refused (or no device)
+    uint64_t camsReceived = 0;        ///< CAMs accepted: decoded by the registered application, or SHB/BTP-B CAM frames without one
+    uint64_t camsRejected = 0;        ///< Received frames too small, not SHB/BTP-B on the CAM port, or not decodable by the application
+    uint64_t forwardedToVanetza = 0;  ///< Received frames handed to the Vanetza stack
+
+    StationMetrics& operator+=(const StationMetrics& other)
+    {
+        camsGenerated += other.camsGenerated;
+        camsSent += other.camsSent;
+        sendFailures += other.sendFailures;
+        camsReceived += other.camsReceived;
+        camsRejected += other.camsRejected;
+        forwardedToVanetza += other.forwardedToVanetza;
+        return *this;
+    }
+};
+
+} // namespace vanetza_ns3
+
+#endif // STATION_METRICS_HPP
@@ -0,0 +1,340 @@
+#include "vanet_scenario_builder.hpp"
+#include "vanetza_ns3_adapter.hpp"
+#include "cam_application.hpp"
+#include "cam_generation_engine.hpp"
+#include "vanetza_stack_factory.hpp"
+#include "cam_analytics.hpp"
+#include "its_pcap_capture.hpp"
+#include "fleet_metrics_collector.hpp"
+#include "fleet_manager.hpp"
+#include "dcc_controller.hpp"
+#include "grid_spectrum_channel.hpp"
+#include "fast_link_channel.hpp"
+#include "fast_link_net_device.hpp"
+
+#include <ns3/log.h>
+#include <ns3/double.h>
+#include <ns3/wifi-helper.h>
+#include <ns3/wifi-mac-helper.h>
+#include <ns3/propagation-delay-model.h>
+
+#include <chrono>
+#include <iomanip>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("VanetScenarioBuilder");
+
+VanetScenarioBuilder::VanetScenarioBuilder() :
+    m_linkModel(WIFI),
+    m_maxRange(1000.0),
+    m_firstStationId(1)
+{
+    NS_LOG_FUNCTION(this);
+    m_adapterFactory.SetTypeId(VanetzaNS3Adapter::GetTypeId());
+    m_applicationFactory.SetTypeId(CamApplication::GetTypeId());
+}
+
+VanetScenarioBuilder::~VanetScenarioBuilder()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+VanetScenarioBuilder::SetLinkModel(LinkModel model)
+{
+    m_linkModel = model;
+}
+
+void
+VanetScenarioBuilder::SetMaxRange(double range)
+{
+    m_maxRange = range;
+}
+
+void
+VanetScenarioBuilder::SetFirstStationId(uint32_t id)
+{
+    m_firstStationId = id;
+}
+
+void
+VanetScenarioBuilder::SetAdapterAttribute(const std::string& name, const ns3::AttributeValue& value)
+{
+    m_adapterFactory.Set(name, value);
+}
+
+void
+VanetScenarioBuilder::SetApplicationAttribute(const std::string& name, const ns3::AttributeValue& value)
+{
+    m_applicationFactory.Set(name, value);
+}
+
+void
+VanetScenarioBuilder::SetGenerationEngine(ns3::Ptr<CamGenerationEngine> engine)
+{
+    m_engine = engine;
+}
+
+void
+VanetScenarioBuilder::SetStackFactory(ns3::Ptr<VanetzaStackFactory> factory)
+{
+    m_stackFactory = factory;
+}
+
+void
+VanetScenarioBuilder::SetAnalytics(ns3::Ptr<CamAnalytics> analytics)
+{
+    m_analytics = analytics;
+}
+
+void
+VanetScenarioBuilder::SetPcapCapture(ns3::Ptr<ItsPcapCapture> capture)
+{
+    m_pcapCapture = capture;
+}
+
+void
+VanetScenarioBuilder::SetMetricsCollector(ns3::Ptr<FleetMetricsCollector> metrics)
+{
+    m_metrics = metrics;
+}
+
+void
+VanetScenarioBuilder::SetFleetManager(ns3::Ptr<FleetManager> fleet)
+{
+    m_fleet = fleet;
+}
+
+void
+VanetScenarioBuilder::SetDccController(ns3::Ptr<DccController> dcc)
+{
+    m_dcc = dcc;
+}
+
+void
+VanetScenarioBuilder::SetMobilityInstaller(MobilityInstaller installer)
+{
+    m_mobilityInstaller = std::move(installer);
+}
+
+void
+VanetScenarioBuilder::SetStationHook(StationHook hook)
+{
+    m_stationHook = std::move(hook);
+}
+
+void
+VanetScenarioBuilder::RunPhase(const char* name, const std::function<void()>& phase)
+{
+    auto start = std::chrono::steady_clock::now();
+    phase();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    m_phases.push_back(Phase{name, seconds});
+    NS_LOG_INFO("Setup phase " << name << ": " << seconds << " s");
+}
+
+void
+VanetScenarioBuilder::Build(uint32_t nStations)
+{
+    NS_LOG_FUNCTION(this << nStations);
+    
+    RunPhase("nodes", [&]() {
+        m_nodes.Create(nStations);
+        m_adapters.reserve(nStations);
+        m_applications.reserve(nStations);
+    });
+    if (m_mobilityInstaller) {
+        RunPhase("mobility", [&]() { m_mobilityInstaller(m_nodes); });
+    }
+    RunPhase("devices", [&]() { InstallDevices(); });
+    RunPhase("stations", [&]() { CreateStations(); });
+    if (m_stationHook) {
+        RunPhase("hooks", [&]() {
+            for (uint32_t i = 0; i < nStations; ++i) {
+                m_stationHook(i, m_nodes.Get(i), m_adapters[i], m_applications[i]);
+            }
+        });
+    }
+    RunPhase("install", [&]() { InstallStations(); });
+}
+
+ns3::Mac48Address
+VanetScenarioBuilder::MakeMacAddress(uint32_t index)
+{
+    const uint32_t number = index + 1;
+    const uint8_t buffer[6] = {
+        0, 0,
+        static_cast<uint8_t>(number >> 24), static_cast<uint8_t>(number >> 16),
+        static_cast<uint8_t>(number >> 8), static_cast<uint8_t>(number)
+    };
+    ns3::Mac48Address address;
+    address.CopyFrom(buffer);
+    return address;
+}
+
+void
+VanetScenarioBuilder::InstallDevices()
+{
+    const uint32_t n = m_nodes.GetN();
+    
+    if (m_linkModel == FAST_LINK) {
+        // Abstract link layer: no PHY/MAC objects, delivery follows the PDR curve
+        m_fastChannel = ns3::CreateObject<FastLinkChannel>();
+        for (uint32_t i = 0; i < n; ++i) {
+            ns3::Ptr<FastLinkNetDevice> device = ns3::CreateObject<FastLinkNetDevice>();
+            device->SetAddress(MakeMacAddress(i));
+            m_nodes.Get(i)->AddDevice(device);
+            device->SetChannel(m_fastChannel);
+            m_devices.Add(device);
+        }
+        return;
+    }
+    
+    if (m_linkModel == WIFI_GRID) {
+        // Same propagation as YansWifiChannelHelper::Default, but culled by range
+        ns3::Ptr<GridSpectrumChannel> channel = ns3::CreateObject<GridSpectrumChannel>();
+        channel->SetAttribute("MaxRange", ns3::DoubleValue(m_maxRange));
+        channel->SetPropagationDelayModel(ns3::CreateObject<ns3::ConstantSpeedPropagationDelayModel>());
+        m_spectrumPhy.SetChannel(channel);
+    } else {
+        m_yansPhy.SetChannel(ns3::YansWifiChannelHelper::Default().Create());
+    }
+    ns3::WifiPhyHelper& phy = (m_linkModel == WIFI_GRID) ? static_cast<ns3::WifiPhyHelper&>(m_spectrumPhy)
+                                                         : static_cast<ns3::WifiPhyHelper&>(m_yansPhy);
+    phy.SetPcapDataLinkType(ns3::WifiPhyHelper::DLT_IEEE802_11);
+    
+    // Regular ad-hoc Wi-Fi MAC instead of WAVE
+    ns3::WifiMacHelper mac;
+    mac.SetType("ns3::AdhocWifiMac");
+    ns3::WifiHelper wifi;
+    wifi.SetStandard(ns3::WIFI_STANDARD_80211a); // Similar to 802.11p used in WAVE
+    m_devices = wifi.Install(phy, mac, m_nodes);
+    
+    for (uint32_t i = 0; i < n; ++i) {
+        m_devices.Get(i)->SetAddress(MakeMacAddress(i));
+    }
+}
+
+void
+VanetScenarioBuilder::CreateStations()
+{
+    const uint32_t n = m_nodes.GetN();
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint32_t stationId = m_firstStationId + i;
+        
+        ns3::Ptr<VanetzaNS3Adapter> adapter = m_adapterFactory.Create<VanetzaNS3Adapter>();
+        adapter->SetDevice(m_devices.Get(i));
+        adapter->SetStationId(stationId);
+        adapter->SetGenerationEngine(m_engine);
+        adapter->SetStackFactory(m_stackFactory);
+        adapter->SetAnalytics(m_analytics);
+        adapter->SetPcapCapture(m_pcapCapture);
+        if (m_metrics) {
+            m_metrics->Add(adapter);
+        }
+        
+        ns3::Ptr<CamApplication> application = m_applicationFactory.Create<CamApplication>();
+        application->SetAdapter(adapter);
+        application->SetGenerationEngine(m_engine);
+        application->SetStationId(stationId);
+        if (m_dcc) {
+            adapter->SetDccController(m_dcc, m_dcc->AddStation(m_devices.Get(i), application));
+        }
+        
+        m_adapters.push_back(adapter);
+        m_applications.push_back(application);
+    }
+}
+
+void
+VanetScenarioBuilder::InstallStations()
+{
+    const uint32_t n = m_nodes.GetN();
+    for (uint32_t i = 0; i < n; ++i) {
+        if (m_fleet) {
+            // Pool slots are started by the fleet manager
+            m_fleet->AddSlot(m_nodes.Get(i), m_adapters[i], m_applications[i]);
+        } else {
+            m_nodes.Get(i)->AddApplication(m_adapters[i]);
+            m_nodes.Get(i)->AddApplication(m_applications[i]);
+        }
+    }
+}
+
+void
+VanetScenarioBuilder::EnableWifiPcap(const std::string& prefix)
+{
+    if (m_linkModel == WIFI_GRID) {
+        m_spectrumPhy.EnablePcap(prefix, m_devices);
+    } else if (m_linkModel == WIFI) {
+        m_yansPhy.EnablePcap(prefix, m_devices);
+    }
+}
+
+const ns3::NodeContainer&
+VanetScenarioBuilder::GetNodes() const
+{
+    return m_nodes;
+}
+
+const ns3::NetDeviceContainer&
+VanetScenarioBuilder::GetDevices() const
+{
+    return m_devices;
+}
+
+const std::vector<ns3::Ptr<VanetzaNS3Adapter>>&
+VanetScenarioBuilder::GetAdapters() const
+{
+    return m_adapters;
+}
+
+const std::vector<ns3::Ptr<CamApplication>>&
+VanetScenarioBuilder::GetApplications() const
+{
+    return m_applications;
+}
+
+ns3::Ptr<FastLinkChannel>
+VanetScenarioBuilder::GetFastLinkChannel() const
+{
+    return m_fastChannel;
+}
+
+const std::vector<VanetScenarioBuilder::Phase>&
+VanetScenarioBuilder::GetPhases() const
+{
+    return m_phases;
+}
+
+double
+VanetScenarioBuilder::GetSetupSeconds() const
+{
+    double seconds = 0.0;
+    for (const Phase& phase : m_phases) {
+        seconds += phase.seconds;
+    }
+    return seconds;
+}
+
+void
+VanetScenarioBuilder::WriteSetupReport(std::ostream& os) const
+{
+    const double total = GetSetupSeconds();
+    const std::ios::fmtflags flags = os.flags();
+    const std::streamsize precision = os.precision();
+    
+    os << std::fixed << std::setprecision(3)
+       << "Setup of " << m_nodes.GetN() << " stations: " << total << " s" << std::endl;
+    for (const Phase& phase : m_phases) {
+        os << "  " << std::left << std::setw(10) << phase.name << std::right
+           << std::setw(10) << phase.seconds << " s"
+           << std::setw(8) << (total > 0.0 ? 100.0 * phase.seconds / total : 0.0) << " %" << std::endl;
+    }
+    
+    os.flags(flags);
+    os.precision(precision);
+}
+
+} // namespace vanetza_ns3
@@ -0,0 +1,291 @@
+#ifndef VANET_SCENARIO_BUILDER_HPP
+#define VANET_SCENARIO_BUILDER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <ns3/attribute.h>
+#include <ns3/object-factory.h>
+#include <ns3/node-container.h>
+#include <ns3/net-device-container.h>
+#include <ns3/mac48-address.h>
+#include <ns3/yans-wifi-helper.h>
+#include <ns3/spectrum-wifi-helper.h>
+
+namespace vanetza_ns3 {
+
+// Forward declarations
+class VanetzaNS3Adapter;
+class CamApplication;
+class CamGenerationEngine;
+class VanetzaStackFactory;
+class CamAnalytics;
+class ItsPcapCapture;
+class FleetMetricsCollector;
+class FleetManager;
+class DccController;
+class FastLinkChannel;
+
+/**
+ * @brief Creates the nodes, devices and stations of a scenario in bulk
+ * 
+ * Adapters and CAM applications come from object factories whose
+ * attributes are resolved once, station IDs and MAC addresses are set
+ * numerically, and containers are sized up front, so the cost per station
+ * is the construction of its ns-3 objects and nothing else. Build() times
+ * every phase; WriteSetupReport() prints the breakdown.
+ * 
+ * The shared components (generation engine, stack factory, analytics,
+ * capture, metrics, fleet manager, congestion control) are optional and
+ * handed to every station. With a fleet manager the stations become pool slots instead of
+ * being added to their nodes.
+ */
+class VanetScenarioBuilder {
+public:
+    /**
+     * @brief Link layer of the stations
+     */
+    enum LinkModel {
+        WIFI,       ///< 802.11 PHY/MAC on a Yans channel
+        WIFI_GRID,  ///< 802.11 PHY/MAC on a range-culling GridSpectrumChannel
+        FAST_LINK   ///< FastLinkNetDevice on a PDR-curve FastLinkChannel
+    };
+
+    /**
+     * @brief Wall-clock time of one setup phase
+     */
+    struct Phase {
+        std::string name;  ///< Phase name
+        double seconds;    ///< Wall-clock duration
+    };
+
+    /**
+     * @brief Installs the mobility models of the nodes
+     */
+    typedef std::function<void(ns3::NodeContainer& nodes)> MobilityInstaller;
+
+    /**
+     * @brief Called once per station after it is created, e.g. to connect traces
+     */
+    typedef std::function<void(uint32_t index, ns3::Ptr<ns3::Node> node,
+                               ns3::Ptr<VanetzaNS3Adapter> adapter,
+                               ns3::Ptr<CamApplication> application)> StationHook;
+
+    /**
+     * @brief Constructor
+     */
+    VanetScenarioBuilder();
+
+    /**
+     * @brief Destructor
+     */
+    ~VanetScenarioBuilder();
+
+    /**
+     * @brief Select the link layer
+     * @param model The link model (default WIFI)
+     */
+    void SetLinkModel(LinkModel model);
+
+    /**
+     * @brief Set the interference range of the WIFI_GRID channel
+     * @param range The range in meters (default 1000)
+     */
+    void SetMaxRange(double range);
+
+    /**
+     * @brief Set the station ID of the first station, the others follow
+     * @param id The station ID (default 1)
+     */
+    void SetFirstStationId(uint32_t id);
+
+    /**
+     * @brief Set an attribute of all adapters
+     * @param name The attribute name
+     * @param value The value
+     */
+    void SetAdapterAttribute(const std::string& name, const ns3::AttributeValue& value);
+
+    /**
+     * @brief Set an attribute of all CAM applications
+     * @param name The attribute name
+     * @param value The value
+     */
+    void SetApplicationAttribute(const std::string& name, const ns3::AttributeValue& value);
+
+    /**
+     * @brief Drive CAM generation of all stations from a shared engine
+     * @param engine The engine, or nullptr for private timers
+     */
+    void SetGenerationEngine(ns3::Ptr<CamGenerationEngine> engine);
+
+    /**
+     * @brief Create the Vanetza stacks through a shared factory
+     * @param factory The factory, or nullptr for standalone stacks
+     */
+    void SetStackFactory(ns3::Ptr<VanetzaStackFactory> factory);
+
+    /**
+     * @brief Report all stations to shared analytics
+     * @param analytics The analytics, or nullptr to disable
+     */
+    void SetAnalytics(ns3::Ptr<CamAnalytics> analytics);
+
+    /**
+     * @brief Write the ITS frames of all stations to a shared capture
+     * @param capture The capture, or nullptr to disable
+     */
+    void SetPcapCapture(ns3::Ptr<ItsPcapCapture> capture);
+
+    /**
+     * @brief Register all stations with a metrics collector
+     * @param metrics The collector, or nullptr to disable
+     */
+    void SetMetricsCollector(ns3::Ptr<FleetMetricsCollector> metrics);
+
+    /**
+     * @brief Make the stations slots of a pool instead of starting them
+     * @param fleet The pool, or nullptr to add the stations to their nodes
+     */
+    void SetFleetManager(ns3::Ptr<FleetManager> fleet);
+
+    /**
+     * @brief Put all stations under shared congestion control
+     * @param dcc The controller, or nullptr to disable
+     */
+    void SetDccController(ns3::Ptr<DccController> dcc);
+
+    /**
+     * @brief Set how mobility is installed, before the devices
+     * @param installer The installer, none installs no mobility
+     */
+    void SetMobilityInstaller(MobilityInstaller installer);
+
+    /**
+     * @brief Set a hook called for every station
+     * @param hook The hook, e.g. connecting trace sinks
+     */
+    void SetStationHook(StationHook hook);
+
+    /**
+     * @brief Create the scenario
+     * @param nStations Number of stations
+     */
+    void Build(uint32_t nStations);
+
+    /**
+     * @brief Capture every Wi-Fi frame into one PCAP file per device
+     * @param prefix The file name prefix
+     */
+    void EnableWifiPcap(const std::string& prefix);
+
+    /**
+     * @brief Get the MAC address of a station
+     * @param index The station index
+     * @return 00:00 followed by index + 1 as big-endian 32-bit number
+     */
+    static ns3::Mac48Address MakeMacAddress(uint32_t index);
+
+    /**
+     * @brief Get the nodes created by Build()
+     * @return The nodes
+     */
+    const ns3::NodeContainer& GetNodes() const;
+
+    /**
+     * @brief Get the devices created by Build()
+     * @return One device per node
+     */
+    const ns3::NetDeviceContainer& GetDevices() const;
+
+    /**
+     * @brief Get the adapters created by Build()
+     * @return One adapter per node
+     */
+    const std::vector<ns3::Ptr<VanetzaNS3Adapter>>& GetAdapters() const;
+
+    /**
+     * @brief Get the CAM applications created by Build()
+     * @return One application per node
+     */
+    const std::vector<ns3::Ptr<CamApplication>>& GetApplications() const;
+
+    /**
+     * @brief Get the channel of the FAST_LINK model
+     * @return The channel, nullptr for the Wi-Fi models
+     */
+    ns3::Ptr<FastLinkChannel> GetFastLinkChannel() const;
+
+    /**
+     * @brief Get the duration of the setup phases
+     * @return The phases in execution order
+     */
+    const std::vector<Phase>& GetPhases() const;
+
+    /**
+     * @brief Get the total setup time
+     * @return The sum of all phases in seconds
+     */
+    double GetSetupSeconds() const;
+
+    /**
+     * @brief Print the setup time per phase
+     * @param os The output stream
+     */
+    void WriteSetupReport(std::ostream& os) const;
+
+private:
+    /**
+     * @brief Create the devices and the channel
+     */
+    void InstallDevices();
+
+    /**
+     * @brief Create the adapters and CAM applications
+     */
+    void CreateStations();
+
+    /**
+     * @brief Add the applications to their nodes or to the fleet manager
+     */
+    void InstallStations();
+
+    /**
+     * @brief Run a phase and record its duration
+     */
+    void RunPhase(const char* name, const std::function<void()>& phase);
+
+    // Configuration
+    LinkModel m_linkModel;                         ///< Link layer
+    double m_maxRange;                             ///< Range of the grid channel
+    uint32_t m_firstStationId;                     ///< Station ID of station 0
+    ns3::ObjectFactory m_adapterFactory;           ///< Creates configured adapters
+    ns3::ObjectFactory m_applicationFactory;       ///< Creates configured CAM applications
+    MobilityInstaller m_mobilityInstaller;         ///< Installs mobility
+    StationHook m_stationHook;                     ///< Per-station hook
+
+    // Shared components
+    ns3::Ptr<CamGenerationEngine> m_engine;        ///< Optional generation engine
+    ns3::Ptr<VanetzaStackFactory> m_stackFactory;  ///< Optional stack factory
+    ns3::Ptr<CamAnalytics> m_analytics;            ///< Optional analytics
+    ns3::Ptr<ItsPcapCapture> m_pcapCapture;        ///< Optional ITS capture
+    ns3::Ptr<FleetMetricsCollector> m_metrics;     ///< Optional metrics collector
+    ns3::Ptr<FleetManager> m_fleet;                ///< Optional station pool
+    ns3::Ptr<DccController> m_dcc;                 ///< Optional congestion control
+
+    // Scenario
+    ns3::NodeContainer m_nodes;                    ///< Vehicle nodes
+    ns3::NetDeviceContainer m_devices;             ///< One device per node
+    ns3::YansWifiPhyHelper m_yansPhy;              ///< PHY helper of WIFI
+    ns3::SpectrumWifiPhyHelper m_spectrumPhy;      ///< PHY helper of WIFI_GRID
+    ns3::Ptr<FastLinkChannel> m_fastChannel;       ///< Channel of FAST_LINK
+    std::vector<ns3::Ptr<VanetzaNS3Adapter>> m_adapters;    ///< Adapter per station
+    std::vector<ns3::Ptr<CamApplication>> m_applications;   ///< CAM application per station
+    std::vector<Phase> m_phases;                   ///< Setup phases
+};
+
+} // namespace vanetza_ns3
+
+#endif // VANET_SCENARIO_BUILDER_HPP
@@ -1,24 +1,60 @@
 #include "vanetza_ns3_adapter.hpp"
 #include "ns3_interface.hpp"
 #include "vanetza_wrapper.hpp"
+#include "cam_generation_engine.hpp"
+#include "vanetza_stack_factory.hpp"
+#include "cam_analytics.hpp"
+#include "its_pcap_capture.hpp"
+#include "dcc_controller.hpp"
+#include "geonet_shb_header.hpp"
+#include "btp_b_header.hpp"
+#include "messages/cam_codec.hpp"
 
 #include <ns3/log.h>
 #include <ns3/simulator.h>
 #include <ns3/uinteger.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
+#include <ns3/mobility-model.h>
 #include <ns3/packet.h>
 #include <ns3/wave-net-device.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <utility>
+
 namespace vanetza_ns3 {
 
 NS_LOG_COMPONENT_DEFINE("VanetzaNS3Adapter");
 
 NS_OBJECT_ENSURE_REGISTERED(VanetzaNS3Adapter);
 
+constexpr std::size_t VanetzaNS3Adapter::kMaxFrameSize;
+
+namespace {
+
+// GeoNetworking SHB and BTP-B headers in front of every CAM
+constexpr uint32_t kShbOverhead = GeoNetShbHeader::kSerializedSize + BtpBHeader::kSerializedSize;
+
+} // namespace
+
 VanetzaNS3Adapter::VanetzaNS3Adapter() :
     m_device(nullptr),
+    m_engine(nullptr),
+    m_engineHandle(CamGenerationEngine::kInvalidHandle),
     m_stationId(0),
-    m_camInterval(1.0) // Default CAM interval: 1 second
+    m_active(false),
+    m_restorePending(false),
+    m_analytics(nullptr),
+    m_analyticsIndex(CamAnalytics::kInvalidIndex),
+    m_pcapCapture(nullptr),
+    m_dcc(nullptr),
+    m_dccIndex(0),
+    m_stackFactory(nullptr),
+    m_useEventArena(true),
+    m_camInterval(1.0), // Default CAM interval: 1 second
+    m_cacheStaticCamContainers(true)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -41,10 +77,56 @@ VanetzaNS3Adapter::GetTypeId()
                       ns3::MakeUintegerAccessor(&VanetzaNS3Adapter::m_stationId),
                       ns3::MakeUintegerChecker<uint32_t>())
         .AddAttribute("CamInterval",
-                      "Interval between CAM transmissions in seconds",
+                      "Interval between the adapter's own UPER CAMs in seconds, sent only without a registered CAM receiver",
                       ns3::DoubleValue(1.0),
                       ns3::MakeDoubleAccessor(&VanetzaNS3Adapter::m_camInterval),
-                      ns3::MakeDoubleChecker<double>(0.1, 10.0));
+                      ns3::MakeDoubleChecker<double>(0.1, 10.0))
+        .AddAttribute("CacheStaticCamContainers",
+                      "Encode the static CAM containers once and only re-encode the high-frequency part",
+                      ns3::BooleanValue(true),
+                      ns3::MakeBooleanAccessor(&VanetzaNS3Adapter::m_cacheStaticCamContainers),
+                      ns3::MakeBooleanChecker())
+        .AddAttribute("UseEventArena",
+                      "Copy received frames into the event arena instead of the adapter's own receive buffer",
+                      ns3::BooleanValue(true),
+                      ns3::MakeBooleanAccessor(&VanetzaNS3Adapter::m_useEventArena),
+                      ns3::MakeBooleanChecker())
+        .AddAttribute("CamsGenerated",
+                      "Number of CAMs built by the CAM application",
+                      ns3::TypeId::ATTR_GET,
+                      ns3::UintegerValue(0),
+                      ns3::MakeUintegerAccessor(&VanetzaNS3Adapter::GetCamsGenerated),
+                      ns3::MakeUintegerChecker<uint64_t>())
+        .AddAttribute("CamsSent",
+                      "Number of CAMs accepted by the network device",
+                      ns3::TypeId::ATTR_GET,
+                      ns3::UintegerValue(0),
+                      ns3::MakeUintegerAccessor(&VanetzaNS3Adapter::GetCamsSent),
+                      ns3::MakeUintegerChecker<uint64_t>())
+        .AddAttribute("SendFailures",
+                      "Number of CAMs the network device refused",
+                      ns3::TypeId::ATTR_GET,
+                      ns3::UintegerValue(0),
+                      ns3::MakeUintegerAccessor(&VanetzaNS3Adapter::GetSendFailures),
+                      ns3::MakeUintegerChecker<uint64_t>())
+        .AddAttribute("CamsReceived",
+                      "Number of received CAMs accepted by the CAM application, or well-formed CAM frames without one",
+                      ns3::TypeId::ATTR_GET,
+                      ns3::UintegerValue(0),
+                      ns3::MakeUintegerAccessor(&VanetzaNS3Adapter::GetCamsReceived),
+                      ns3::MakeUintegerChecker<uint64_t>())
+        .AddAttribute("CamsRejected",
+                      "Number of received frames that are not well-formed CAM frames or that the CAM application could not decode",
+                      ns3::TypeId::ATTR_GET,
+                      ns3::UintegerValue(0),
+                      ns3::MakeUintegerAccessor(&VanetzaNS3Adapter::GetCamsRejected),
+                      ns3::MakeUintegerChecker<uint64_t>())
+        .AddAttribute("ForwardedToVanetza",
+                      "Number of received frames handed to the Vanetza stack",
+                      ns3::TypeId::ATTR_GET,
+                      ns3::UintegerValue(0),
+                      ns3::MakeUintegerAccessor(&VanetzaNS3Adapter::GetForwardedToVanetza),
+                      ns3::MakeUintegerChecker<uint64_t>());
     return tid;
 }
 
@@ -62,6 +144,48 @@ VanetzaNS3Adapter::SetStationId(uint32_t id)
     m_stationId = id;
 }
 
+uint32_t
+VanetzaNS3Adapter::GetStationId() const
+{
+    return m_stationId;
+}
+
+void
+VanetzaNS3Adapter::SetGenerationEngine(ns3::Ptr<CamGenerationEngine> engine)
+{
+    NS_LOG_FUNCTION(this << engine);
+    m_engine = engine;
+}
+
+void
+VanetzaNS3Adapter::SetStackFactory(ns3::Ptr<VanetzaStackFactory> factory)
+{
+    NS_LOG_FUNCTION(this << factory);
+    m_stackFactory = factory;
+}
+
+void
+VanetzaNS3Adapter::SetAnalytics(ns3::Ptr<CamAnalytics> analytics)
+{
+    NS_LOG_FUNCTION(this << analytics);
+    m_analytics = analytics;
+}
+
+void
+VanetzaNS3Adapter::SetPcapCapture(ns3::Ptr<ItsPcapCapture> capture)
+{
+    NS_LOG_FUNCTION(this << capture);
+    m_pcapCapture = capture;
+}
+
+void
+VanetzaNS3Adapter::SetDccController(ns3::Ptr<DccController> dcc, uint32_t index)
+{
+    NS_LOG_FUNCTION(this << dcc << index);
+    m_dcc = dcc;
+    m_dccIndex = index;
+}
+
 void
 VanetzaNS3Adapter::StartApplication()
 {
@@ -72,15 +196,35 @@ VanetzaNS3Adapter::StartApplication()
         return;
     }
     
-    // Initialize Vanetza components
-    InitializeVanetza();
+    // Initialize Vanetza components, unless a pooled slot kept them
+    if (!m_vanetzaWrapper) {
+        InitializeVanetza();
+    }
+    
+    // Size the receive buffer for the largest frame the device can deliver,
+    // frames are copied into the event arena instead if that is enabled
+    if (!m_useEventArena) {
+        m_rxBuffer.resize(std::max<std::size_t>(m_device->GetMtu(), kMaxFrameSize));
+    }
+    
+    if (m_analytics && m_analyticsIndex == CamAnalytics::kInvalidIndex) {
+        m_analyticsIndex = m_analytics->AddStation(m_stationId, GetNode()->GetObject<ns3::MobilityModel>());
+    } else if (m_analytics) {
+        m_analytics->SetStationActive(m_analyticsIndex, true);
+    }
     
     // Set up packet reception callback using the correct signature
     m_device->SetReceiveCallback(
         ns3::MakeCallback(&VanetzaNS3Adapter::ReceiveFromNS3Raw, this));
     
-    // Schedule first CAM transmission
-    ScheduleNextCamTransmission();
+    // A registered application is the only CAM source of the station, the
+    // adapter's own UPER CAM timer serves stations without one
+    if (m_camReceiverCallback) {
+        m_restorePending = false;
+    } else {
+        ScheduleFirstCamTransmission();
+    }
+    m_active = true;
 }
 
 void
@@ -88,14 +232,96 @@ VanetzaNS3Adapter::StopApplication()
 {
     NS_LOG_FUNCTION(this);
     
+    Halt();
+    
+    // Clean up Vanetza components, keeping their encoding statistics; a
+    // factory stack goes back to its factory, whose slot the next station reuses
+    m_camEncodingStats = GetCamEncodingStats();
+    if (m_stackFactory) {
+        m_stackFactory->Release(std::move(m_vanetzaWrapper));
+    }
+    m_vanetzaWrapper.reset();
+    m_ns3Interface.reset();
+}
+
+void
+VanetzaNS3Adapter::Halt()
+{
     // Cancel any pending events
     if (m_camEvent.IsRunning()) {
         m_camEvent.Cancel();
     }
+    if (m_engine) {
+        m_engine->Unregister(m_engineHandle);
+        m_engineHandle = CamGenerationEngine::kInvalidHandle;
+    }
+    if (m_analytics && m_analyticsIndex != CamAnalytics::kInvalidIndex) {
+        m_analytics->SetStationActive(m_analyticsIndex, false);
+    }
+    m_active = false;
+}
+
+void
+VanetzaNS3Adapter::Activate(uint32_t stationId)
+{
+    NS_LOG_FUNCTION(this << stationId);
+    NS_ASSERT_MSG(!m_active, "Station " << m_stationId << " is already active");
     
-    // Clean up Vanetza components
-    m_vanetzaWrapper.reset();
-    m_ns3Interface.reset();
+    m_stationId = stationId;
+    if (m_vanetzaWrapper) {
+        m_vanetzaWrapper->reset(stationId);
+    }
+    if (m_analytics && m_analyticsIndex != CamAnalytics::kInvalidIndex) {
+        m_analytics->SetStationId(m_analyticsIndex, stationId);
+    }
+    if (m_dcc) {
+        m_dcc->ResetStation(m_dccIndex);
+    }
+    
+    // The counters start over for the new vehicle
+    m_retiredMetrics += m_metrics;
+    m_metrics = StationMetrics();
+    StartApplication();
+}
+
+void
+VanetzaNS3Adapter::Deactivate()
+{
+    NS_LOG_FUNCTION(this);
+    Halt();
+}
+
+bool
+VanetzaNS3Adapter::IsActive() const
+{
+    return m_active;
+}
+
+AdapterSnapshot
+VanetzaNS3Adapter::SaveState() const
+{
+    AdapterSnapshot state;
+    state.stationId = m_stationId;
+    if (m_engine && m_engineHandle != CamGenerationEngine::kInvalidHandle) {
+        state.nextCamNs = (m_engine->GetNextTime(m_engineHandle) - ns3::Simulator::Now()).GetNanoSeconds();
+    } else if (m_camEvent.IsRunning()) {
+        state.nextCamNs = ns3::Simulator::GetDelayLeft(m_camEvent).GetNanoSeconds();
+    }
+    if (m_vanetzaWrapper) {
+        state.lastLowFrequencyMs = m_vanetzaWrapper->getLastLowFrequencyMs();
+    }
+    return state;
+}
+
+void
+VanetzaNS3Adapter::RestoreState(const AdapterSnapshot& state)
+{
+    NS_LOG_FUNCTION(this << state.stationId);
+    NS_ASSERT_MSG(!m_active, "Station " << m_stationId << " is already running");
+    
+    m_stationId = state.stationId;
+    m_restoredState = state;
+    m_restorePending = true;
 }
 
 void
@@ -107,7 +333,13 @@ VanetzaNS3Adapter::InitializeVanetza()
     m_ns3Interface = std::make_unique<NS3Interface>(m_device);
     
     // Create Vanetza wrapper with the interface
-    m_vanetzaWrapper = std::make_unique<VanetzaWrapper>(m_ns3Interface.get(), m_stationId);
+    if (m_stackFactory) {
+        m_vanetzaWrapper = m_stackFactory->Create(m_ns3Interface.get(), m_stationId,
+                                                  m_cacheStaticCamContainers);
+    } else {
+        m_vanetzaWrapper = utils::makeArenaPtr<VanetzaWrapper>(nullptr, m_ns3Interface.get(), m_stationId,
+                                                               m_cacheStaticCamContainers);
+    }
 }
 
 // New method with the correct signature for SetReceiveCallback
@@ -115,35 +347,7 @@ bool
 VanetzaNS3Adapter::ReceiveFromNS3Raw(ns3::Ptr<ns3::NetDevice> device, ns3::Ptr<const ns3::Packet> packet, uint16_t protocol, const ns3::Address& from)
 {
     NS_LOG_FUNCTION(this << device << packet << protocol << from);
-    
-    // Only process packets for this device
-    if (device != m_device) {
-        return false;
-    }
-    
-    // Check if this is a CAM message (based on protocol)
-    // In a real implementation, you would check for ETSI ITS protocol identifiers
-    if (protocol == 0x8947) { // Example protocol number for ETSI ITS-G5
-        // Copy packet data
-        uint32_t size = packet->GetSize();
-        uint8_t* buffer = new uint8_t[size];
-        packet->CopyData(buffer, size);
-        
-        // Forward to Vanetza for processing
-        if (m_vanetzaWrapper) {
-            m_vanetzaWrapper->receivePacket(buffer, size);
-        }
-        
-        // If there's a registered callback for CAM messages, call it
-        if (m_camReceiverCallback) {
-            m_camReceiverCallback(buffer, size);
-        }
-        
-        delete[] buffer;
-        return true;
-    }
-    
-    return false;
+    return HandleReceivedFrame(device, packet, protocol, from);
 }
 
 // Keep the original method for backward compatibility
@@ -156,35 +360,99 @@ VanetzaNS3Adapter::ReceiveFromNS3(ns3::Ptr<ns3::NetDevice> device,
                                   ns3::NetDevice::PacketType packetType)
 {
     NS_LOG_FUNCTION(this << device << packet << protocol << from << to << packetType);
-    
-    // Only process packets for this device
-    if (device != m_device) {
+    return HandleReceivedFrame(device, packet, protocol, from);
+}
+
+bool
+VanetzaNS3Adapter::HandleReceivedFrame(ns3::Ptr<ns3::NetDevice> device,
+                                       ns3::Ptr<const ns3::Packet> packet,
+                                       uint16_t protocol,
+                                       const ns3::Address& from)
+{
+    // Only process packets for this device while the station is running
+    if (device != m_device || !m_active) {
         return false;
     }
     
     // Check if this is a CAM message (based on protocol)
     // In a real implementation, you would check for ETSI ITS protocol identifiers
-    if (protocol == 0x8947) { // Example protocol number for ETSI ITS-G5
-        // Copy packet data
-        uint32_t size = packet->GetSize();
-        uint8_t* buffer = new uint8_t[size];
-        packet->CopyData(buffer, size);
-        
-        // Forward to Vanetza for processing
-        if (m_vanetzaWrapper) {
-            m_vanetzaWrapper->receivePacket(buffer, size);
-        }
-        
-        // If there's a registered callback for CAM messages, call it
-        if (m_camReceiverCallback) {
-            m_camReceiverCallback(buffer, size);
+    if (protocol != 0x8947) { // GeoNetworking
+        return false;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    if (packet->GetSize() < kShbOverhead) {
+        ++m_metrics.camsRejected;
+        return false;
+    }
+    
+    // Everything taken from the event arena is released when this
+    // handler returns
+    utils::Arena& arena = utils::eventArena();
+    utils::ArenaScope scope(arena);
+    
+    // ns3::Packet does not expose its byte buffer, so the frame is copied
+    // exactly once, either into the event arena or into the receive buffer
+    // owned by this adapter. Headers, payload and capture all read from
+    // these bytes; the receive buffer only grows, so after the first frame
+    // no heap allocation takes place either way.
+    const uint32_t frameSize = packet->GetSize();
+    uint8_t* frame = nullptr;
+    if (m_useEventArena) {
+        frame = static_cast<uint8_t*>(arena.allocate(frameSize, 1));
+    } else {
+        if (m_rxBuffer.size() < frameSize) {
+            m_rxBuffer.resize(frameSize);
         }
-        
-        delete[] buffer;
-        return true;
+        frame = m_rxBuffer.data();
+    }
+    packet->CopyData(frame, frameSize);
+    
+    GeoNetShbHeader gn;
+    BtpBHeader btp;
+    gn.DeserializeFrom(frame);
+    btp.DeserializeFrom(frame + GeoNetShbHeader::kSerializedSize);
+    if (!gn.IsShbBtpB() || btp.GetDestinationPort() != BtpBHeader::kCamPort) {
+        NS_LOG_LOGIC("Ignoring GeoNetworking packet that is not a CAM: " << gn << " " << btp);
+        ++m_metrics.camsRejected;
+        return false;
+    }
+    if (m_analytics) {
+        m_analytics->OnReceive(m_analyticsIndex, packet);
+    }
+    
+    if (m_pcapCapture && m_pcapCapture->CapturesReceptions() && m_pcapCapture->IsCaptured(m_stationId)) {
+        m_pcapCapture->Capture(m_stationId, ns3::Mac48Address::ConvertFrom(from), m_ns3Interface->getMacAddress(),
+                               frame, frameSize);
     }
     
-    return false;
+    const uint8_t* buffer = frame + kShbOverhead;
+    const uint32_t size = frameSize - kShbOverhead;
+    
+    // Forward to Vanetza for processing, the headers were already
+    // decapsulated above so the stack sees the BTP payload
+    if (m_vanetzaWrapper) {
+        ++m_metrics.forwardedToVanetza;
+        m_vanetzaWrapper->receivePacket(buffer, size);
+    }
+    
+    // The application callback sees the very same view of the payload and
+    // decides whether it is a CAM; without an application a well-formed
+    // SHB/BTP-B frame on the CAM port counts as received
+    if (!m_camReceiverCallback || m_camReceiverCallback(buffer, size)) {
+        ++m_metrics.camsReceived;
+    } else {
+        ++m_metrics.camsRejected;
+    }
+    
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    ++m_rxStats.packets;
+    m_rxStats.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    m_rxStats.arenaAllocations += scope.allocations();
+    m_rxStats.arenaBytes += scope.bytesUsed();
+    
+    return true;
 }
 
 void
@@ -195,22 +463,88 @@ VanetzaNS3Adapter::ScheduleNextCamTransmission()
     // Schedule next CAM transmission
     m_camEvent = ns3::Simulator::Schedule(
         ns3::Seconds(m_camInterval),
-        &VanetzaNS3Adapter::GenerateAndSendCam,
+        &VanetzaNS3Adapter::HandleCamTimer,
         this);
 }
 
+void
+VanetzaNS3Adapter::ScheduleFirstCamTransmission()
+{
+    ns3::Callback<void> generate = ns3::MakeCallback(&VanetzaNS3Adapter::GenerateAndSendCam, this);
+    
+    // A restored station keeps the phase it had when the snapshot was taken
+    if (m_restorePending) {
+        m_restorePending = false;
+        if (m_vanetzaWrapper) {
+            m_vanetzaWrapper->setLastLowFrequencyMs(m_restoredState.lastLowFrequencyMs);
+        }
+        if (m_restoredState.nextCamNs >= 0) {
+            const ns3::Time delay = ns3::NanoSeconds(m_restoredState.nextCamNs);
+            if (m_engine) {
+                m_engineHandle = m_engine->Register(generate, ns3::Seconds(m_camInterval), delay);
+            } else {
+                m_camEvent = ns3::Simulator::Schedule(delay, &VanetzaNS3Adapter::HandleCamTimer, this);
+            }
+            return;
+        }
+    }
+    
+    if (m_engine) {
+        m_engineHandle = m_engine->Register(generate, ns3::Seconds(m_camInterval));
+    } else {
+        ScheduleNextCamTransmission();
+    }
+}
+
+void
+VanetzaNS3Adapter::HandleCamTimer()
+{
+    NS_LOG_FUNCTION(this);
+    
+    GenerateAndSendCam();
+    ScheduleNextCamTransmission();
+}
+
 void
 VanetzaNS3Adapter::GenerateAndSendCam()
 {
     NS_LOG_FUNCTION(this);
     
-    // Generate CAM message using Vanetza
-    if (m_vanetzaWrapper) {
-        m_vanetzaWrapper->triggerCamTransmission();
+    if (!m_vanetzaWrapper) {
+        return;
     }
     
-    // Schedule next transmission
-    ScheduleNextCamTransmission();
+    // Ask congestion control before encoding, sized like the CAMs encoded so far
+    if (m_dcc) {
+        const messages::CamEncodingStats& stats = m_vanetzaWrapper->getCamEncodingStats();
+        const uint32_t bytes = stats.cams ? static_cast<uint32_t>(stats.bytes / stats.cams)
+                                          : static_cast<uint32_t>(messages::CamLayout::size);
+        if (!m_dcc->RequestTransmission(m_dccIndex, bytes + kShbOverhead)) {
+            return;
+        }
+    }
+    
+    // Collect the ego state from the node's mobility model
+    messages::CamMessage ego;
+    ego.stationId = m_stationId;
+    ego.timestamp = static_cast<uint32_t>(ns3::Simulator::Now().GetSeconds());
+    ns3::Ptr<ns3::MobilityModel> mobility = GetNode()->GetObject<ns3::MobilityModel>();
+    if (mobility) {
+        ns3::Vector position = mobility->GetPosition();
+        ns3::Vector velocity = mobility->GetVelocity();
+        ego.posX = static_cast<float>(position.x);
+        ego.posY = static_cast<float>(position.y);
+        ego.speed = static_cast<float>(std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y));
+        ego.heading = static_cast<float>(std::atan2(velocity.y, velocity.x) * 180.0 / M_PI);
+    }
+    
+    // Generate CAM message using Vanetza
+    ++m_metrics.camsGenerated;
+    if (m_vanetzaWrapper->triggerCamTransmission(ego)) {
+        ++m_metrics.camsSent;
+    } else {
+        ++m_metrics.sendFailures;
+    }
 }
 
 bool
@@ -218,21 +552,102 @@ VanetzaNS3Adapter::SendCam(const uint8_t* data, std::size_t size)
 {
     NS_LOG_FUNCTION(this << data << size);
     
-    if (!m_device) {
+    if (!m_device || !m_ns3Interface) {
         NS_LOG_ERROR("No device set for VanetzaNS3Adapter");
+        ++m_metrics.sendFailures;
         return false;
     }
     
-    // Create NS3 packet from data
+    if (m_dcc && !m_dcc->RequestTransmission(m_dccIndex, static_cast<uint32_t>(size) + kShbOverhead)) {
+        NS_LOG_LOGIC("CAM held back by DCC");
+        return false;
+    }
+    
+    // The payload is copied into the packet once, the BTP-B and
+    // GeoNetworking SHB headers are added in front of it without copying it
     ns3::Ptr<ns3::Packet> packet = ns3::Create<ns3::Packet>(data, size);
+    if (m_analytics) {
+        m_analytics->OnTransmit(m_analyticsIndex, packet);
+    }
+    m_ns3Interface->addShbHeaders(packet, BtpBHeader::kCamPort);
+    
+    // Only the capture needs the frame as contiguous bytes, and only if it
+    // keeps it. It is taken before sending, as the device adds its own
+    // headers to the packet.
+    utils::Arena& arena = utils::eventArena();
+    utils::ArenaScope scope(arena);
+    const uint32_t frameSize = packet->GetSize();
+    uint8_t* frame = nullptr;
+    if (m_pcapCapture && m_pcapCapture->IsCaptured(m_stationId)) {
+        frame = static_cast<uint8_t*>(arena.allocate(frameSize, 1));
+        packet->CopyData(frame, frameSize);
+    }
     
-    // Send packet using the device
-    // In a real implementation, you would set the appropriate protocol number and address
-    return m_device->Send(packet, ns3::Mac48Address::GetBroadcast(), 0x8947);
+    if (!m_ns3Interface->sendPacket(packet)) {
+        ++m_metrics.sendFailures;
+        return false;
+    }
+    ++m_metrics.camsSent;
+    if (m_analytics) {
+        m_analytics->OnSent(m_analyticsIndex);
+    }
+    if (frame) {
+        m_pcapCapture->Capture(m_stationId, m_ns3Interface->getMacAddress(), ns3::Mac48Address::GetBroadcast(),
+                               frame, frameSize);
+    }
+    return true;
+}
+
+messages::CamEncodingStats
+VanetzaNS3Adapter::GetCamEncodingStats() const
+{
+    return m_vanetzaWrapper ? m_vanetzaWrapper->getCamEncodingStats() : m_camEncodingStats;
+}
+
+uint64_t
+VanetzaNS3Adapter::GetCamsGenerated() const
+{
+    return m_metrics.camsGenerated;
+}
+
+uint64_t
+VanetzaNS3Adapter::GetCamsSent() const
+{
+    return m_metrics.camsSent;
+}
+
+uint64_t
+VanetzaNS3Adapter::GetSendFailures() const
+{
+    return m_metrics.sendFailures;
+}
+
+uint64_t
+VanetzaNS3Adapter::GetCamsReceived() const
+{
+    return m_metrics.camsReceived;
+}
+
+uint64_t
+VanetzaNS3Adapter::GetCamsRejected() const
+{
+    return m_metrics.camsRejected;
+}
+
+uint64_t
+VanetzaNS3Adapter::GetForwardedToVanetza() const
+{
+    return m_metrics.forwardedToVanetza;
+}
+
+const ReceivePathStats&
+VanetzaNS3Adapter::GetReceivePathStats() const
+{
+    return m_rxStats;
 }
 
 void
-VanetzaNS3Adapter::RegisterCamReceiver(std::function<void(const uint8_t*, std::size_t)> cb)
+VanetzaNS3Adapter::RegisterCamReceiver(std::function<bool(const uint8_t*, std::size_t)> cb)
 {
     NS_LOG_FUNCTION(this);
     m_camReceiverCallback = cb;
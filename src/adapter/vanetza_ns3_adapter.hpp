@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include <functional>
 #include <ns3/node.h>
 #include <ns3/net-device.h>
@@ -12,6 +13,10 @@
 #include <ns3/ipv4-address.h>
 #include <ns3/traced-callback.h>
 
+#include "messages/uper_cam_encoder.hpp"
+#include "utils/arena.hpp"
+#include "station_metrics.hpp"
+
 // Forward declarations for Vanetza components
 namespace vanetza {
     namespace btp {
@@ -31,6 +36,30 @@ namespace vanetza_ns3 {
 // Forward declarations
 class VanetzaWrapper;
 class NS3Interface;
+class CamGenerationEngine;
+class VanetzaStackFactory;
+class CamAnalytics;
+class ItsPcapCapture;
+class DccController;
+
+/**
+ * @brief Cost of the receive path accumulated by an adapter
+ */
+struct ReceivePathStats {
+    uint64_t packets = 0;           ///< Frames handed to Vanetza
+    uint64_t nanoseconds = 0;       ///< Total wall-clock time spent in the receive path
+    uint64_t arenaAllocations = 0;  ///< Allocations served by the event arena
+    uint64_t arenaBytes = 0;        ///< Bytes served by the event arena
+};
+
+/**
+ * @brief Transmission state of a running adapter, see ScenarioSnapshot
+ */
+struct AdapterSnapshot {
+    uint32_t stationId = 0;          ///< Station ID
+    int64_t nextCamNs = -1;          ///< Time until the next CAM transmission, -1 if none is pending
+    int64_t lastLowFrequencyMs = -1; ///< Time of the last low-frequency container, -1 if none
+};
 
 /**
  * @brief Main adapter class that integrates Vanetza with NS3
@@ -70,6 +99,97 @@ public:
      */
     void SetStationId(uint32_t id);
 
+    /**
+     * @brief Get the station ID of this node
+     * @return The station ID
+     */
+    uint32_t GetStationId() const;
+
+    /**
+     * @brief Drive CAM transmission from a shared generation engine
+     * 
+     * When set before the application starts, no per-adapter timer is
+     * used; the engine triggers transmissions in its slot loop instead.
+     * @param engine The engine, or nullptr to use a private timer
+     */
+    void SetGenerationEngine(ns3::Ptr<CamGenerationEngine> engine);
+
+    /**
+     * @brief Create the Vanetza stack through a shared factory
+     * 
+     * When set before the application starts, the stack shares its
+     * configuration with the other stations of the factory and its
+     * components are allocated from the factory's arena.
+     * @param factory The factory, or nullptr for a standalone stack
+     */
+    void SetStackFactory(ns3::Ptr<VanetzaStackFactory> factory);
+
+    /**
+     * @brief Report sent and received CAMs to shared analytics
+     * 
+     * When set before the application starts, every sent CAM is tagged
+     * with its generation time and sender position, and every received
+     * CAM is accounted for latency, PDR and inter-reception time.
+     * @param analytics The analytics, or nullptr to disable
+     */
+    void SetAnalytics(ns3::Ptr<CamAnalytics> analytics);
+
+    /**
+     * @brief Write the ITS frames of this station to a shared capture
+     * 
+     * Sent frames are always handed to the capture, received frames only
+     * if it captures receptions.
+     * @param capture The capture, or nullptr to disable
+     */
+    void SetPcapCapture(ns3::Ptr<ItsPcapCapture> capture);
+
+    /**
+     * @brief Gate the CAM transmissions of this station by congestion control
+     * 
+     * CAMs the controller holds back are dropped before they reach the
+     * device and counted in the controller's counters.
+     * @param dcc The controller, or nullptr to disable
+     * @param index The index of this station in the controller
+     */
+    void SetDccController(ns3::Ptr<DccController> dcc, uint32_t index);
+
+    /**
+     * @brief Start the station in a pooled slot under a new station ID
+     * 
+     * Used instead of the application start time when the adapter is not
+     * added to its node (see FleetManager). The Vanetza stack of the
+     * previous station is reset in place rather than rebuilt.
+     * @param stationId The station ID
+     */
+    void Activate(uint32_t stationId);
+
+    /**
+     * @brief Stop the station, keeping its Vanetza stack for the next Activate()
+     */
+    void Deactivate();
+
+    /**
+     * @brief Check whether the station is running
+     * @return True between start and stop
+     */
+    bool IsActive() const;
+
+    /**
+     * @brief Capture the transmission state of the running station
+     * @return The state, relative to the current simulation time
+     */
+    AdapterSnapshot SaveState() const;
+
+    /**
+     * @brief Resume the station from a captured state when it starts
+     * 
+     * Must be called before the application starts. The station ID is
+     * taken over at once; the first transmission keeps its captured phase
+     * and the CAM service its low-frequency schedule.
+     * @param state The captured state
+     */
+    void RestoreState(const AdapterSnapshot& state);
+
     /**
      * @brief Send a CAM message
      * @param data The message data
@@ -80,9 +200,49 @@ public:
 
     /**
      * @brief Register a callback for received CAM messages
-     * @param cb The callback function
+     * 
+     * The registering application becomes the CAM source of the station:
+     * the adapter no longer sends UPER CAMs on its own CamInterval timer.
+     * The callback decides whether a frame counts as received or rejected.
+     * @param cb The callback function, returns true if it accepted the CAM
+     */
+    void RegisterCamReceiver(std::function<bool(const uint8_t*, std::size_t)> cb);
+
+    /**
+     * @brief Get the cost of encoding the CAMs sent through Vanetza
+     * @return The encoding statistics (all zero before the adapter starts)
+     */
+    messages::CamEncodingStats GetCamEncodingStats() const;
+
+    /**
+     * @brief Get the event counters of this station
+     * 
+     * The CAM application increments the generation and rejection
+     * counters through this reference.
+     * @return The counters
+     */
+    StationMetrics& GetMetrics() { return m_metrics; }
+
+    /**
+     * @brief Get the event counters of this station
+     * @return The counters
      */
-    void RegisterCamReceiver(std::function<void(const uint8_t*, std::size_t)> cb);
+    const StationMetrics& GetMetrics() const { return m_metrics; }
+
+    /**
+     * @brief Get the counters of the vehicles that used this slot before
+     * 
+     * Activate() moves the counters of the previous vehicle here, so fleet
+     * totals keep them while GetMetrics() only covers the current vehicle.
+     * @return The counters
+     */
+    const StationMetrics& GetRetiredMetrics() const { return m_retiredMetrics; }
+
+    /**
+     * @brief Get the cost of the receive path
+     * @return The receive path statistics
+     */
+    const ReceivePathStats& GetReceivePathStats() const;
 
 protected:
     /**
@@ -137,11 +297,53 @@ private:
                         const ns3::Address& to,
                         ns3::NetDevice::PacketType packetType);
 
+    /**
+     * @brief Common receive path shared by both NS3 receive callbacks
+     * 
+     * Copies the frame once and hands the same view of its payload to
+     * Vanetza and to the registered CAM receiver. With UseEventArena the
+     * copy comes from the event arena and is released when the handler
+     * returns; otherwise it goes to the adapter's receive buffer, which is
+     * sized for the device MTU at start. Neither allocates per frame.
+     * @param device The device that received the packet
+     * @param packet The received packet
+     * @param protocol The protocol number
+     * @param from The link-layer source
+     * @return True if the packet was handled successfully
+     */
+    bool HandleReceivedFrame(ns3::Ptr<ns3::NetDevice> device,
+                             ns3::Ptr<const ns3::Packet> packet,
+                             uint16_t protocol,
+                             const ns3::Address& from);
+
+    // Attribute getters of the station metrics
+    uint64_t GetCamsGenerated() const;
+    uint64_t GetCamsSent() const;
+    uint64_t GetSendFailures() const;
+    uint64_t GetCamsReceived() const;
+    uint64_t GetCamsRejected() const;
+    uint64_t GetForwardedToVanetza() const;
+
+    /**
+     * @brief Stop CAM transmission and reception
+     */
+    void Halt();
+
     /**
      * @brief Schedule the next CAM transmission
      */
     void ScheduleNextCamTransmission();
 
+    /**
+     * @brief Schedule the first CAM transmission after the start
+     */
+    void ScheduleFirstCamTransmission();
+
+    /**
+     * @brief Handle expiry of the private CAM transmission timer
+     */
+    void HandleCamTimer();
+
     /**
      * @brief Generate and send a CAM message
      */
@@ -150,17 +352,40 @@ private:
     // NS3 components
     ns3::Ptr<ns3::NetDevice> m_device;  ///< The network device
     ns3::EventId m_camEvent;            ///< Event for CAM transmission
+    ns3::Ptr<CamGenerationEngine> m_engine;  ///< Optional shared generation engine
+    uint32_t m_engineHandle;            ///< Registration with the engine
     uint32_t m_stationId;               ///< Station ID
+    bool m_active;                      ///< Between start and stop
+    AdapterSnapshot m_restoredState;    ///< State to resume from on start
+    bool m_restorePending;              ///< RestoreState() was called and not yet applied
+    ns3::Ptr<CamAnalytics> m_analytics;  ///< Optional shared analytics
+    uint32_t m_analyticsIndex;          ///< Registration with the analytics
+    ns3::Ptr<ItsPcapCapture> m_pcapCapture;  ///< Optional shared PCAP capture
+    ns3::Ptr<DccController> m_dcc;      ///< Optional shared congestion control
+    uint32_t m_dccIndex;                ///< Index of this station in the controller
 
     // Vanetza components
-    std::unique_ptr<VanetzaWrapper> m_vanetzaWrapper;  ///< Wrapper for Vanetza components
+    ns3::Ptr<VanetzaStackFactory> m_stackFactory;      ///< Optional shared stack factory
+    utils::ArenaPtr<VanetzaWrapper> m_vanetzaWrapper;  ///< Wrapper for Vanetza components
     std::unique_ptr<NS3Interface> m_ns3Interface;      ///< Interface to NS3
 
     // Callbacks
-    std::function<void(const uint8_t*, std::size_t)> m_camReceiverCallback;  ///< Callback for received CAM messages
+    std::function<bool(const uint8_t*, std::size_t)> m_camReceiverCallback;  ///< Callback for received CAM messages
+
+    // Receive path
+    static constexpr std::size_t kMaxFrameSize = 2304;  ///< Largest 802.11 MSDU
+    std::vector<uint8_t> m_rxBuffer;                     ///< Reusable receive buffer (without event arena)
+    bool m_useEventArena;                                ///< Take per-packet memory from the event arena
+    ReceivePathStats m_rxStats;                          ///< Receive path statistics
+
+    // Metrics
+    StationMetrics m_metrics;                            ///< Event counters of this station
+    StationMetrics m_retiredMetrics;                     ///< Counters of earlier vehicles of this slot
 
     // Configuration
     double m_camInterval;  ///< Interval between CAM transmissions in seconds
+    bool m_cacheStaticCamContainers;  ///< Reuse static CAM containers when encoding
+    messages::CamEncodingStats m_camEncodingStats;  ///< Encoding cost of stopped stacks
 };
 
 } // namespace vanetza_ns3
@@ -0,0 +1,38 @@
+#ifndef VANETZA_STACK_CONFIG_HPP
+#define VANETZA_STACK_CONFIG_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vanetza/geonet/mib.hpp>
+
+#include "messages/uper_cam_encoder.hpp"
+
+namespace vanetza_ns3 {
+
+/**
+ * @brief Immutable configuration shared by the Vanetza stacks of a fleet
+ *
+ * Everything in here is identical for all stations of a simulation and is
+ * only read after the stacks are created, so one instance is shared by
+ * reference between all VanetzaWrapper objects. Per-station values (the
+ * GeoNetworking address, the station ID of the CAMs) are kept by the
+ * stacks themselves.
+ */
+struct VanetzaStackConfig {
+    /**
+     * @brief Constructor, sets up the default MIB of the adapter
+     */
+    VanetzaStackConfig()
+    {
+        mib.itsGnLocalAddrConfMethod = vanetza::geonet::AddrConfMethod::MANAGED;
+        mib.itsGnProtocolVersion = 1;
+    }
+
+    vanetza::geonet::MIB mib;              ///< GeoNetworking MIB defaults (local address is per station)
+    messages::CamVehicleProfile vehicle;   ///< Static vehicle properties of the CAMs
+    int64_t lowFrequencyIntervalMs = 500;  ///< Minimum spacing of CAM low-frequency containers
+};
+
+} // namespace vanetza_ns3
+
+#endif // VANETZA_STACK_CONFIG_HPP
@@ -0,0 +1,155 @@
+#include "vanetza_stack_factory.hpp"
+#include "vanetza_wrapper.hpp"
+
+#include <ns3/log.h>
+#include <ns3/uinteger.h>
+
+#include <cstddef>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("VanetzaStackFactory");
+
+NS_OBJECT_ENSURE_REGISTERED(VanetzaStackFactory);
+
+VanetzaStackFactory::VanetzaStackFactory() :
+    m_config(std::make_shared<const VanetzaStackConfig>()),
+    m_arenaBlockSize(64 * 1024),
+    m_slotBlockSize(0),
+    m_stacks(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+VanetzaStackFactory::~VanetzaStackFactory()
+{
+    NS_LOG_FUNCTION(this);
+    for (const std::unique_ptr<utils::Arena>& slot : m_slots) {
+        NS_ASSERT_MSG(slot->liveObjects() == 0, "Vanetza stacks outlive the factory that created them");
+    }
+}
+
+ns3::TypeId
+VanetzaStackFactory::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::VanetzaStackFactory")
+        .SetParent<ns3::Object>()
+        .SetGroupName("VANET")
+        .AddConstructor<VanetzaStackFactory>()
+        .AddAttribute("ArenaBlockSize",
+                      "Size of the memory block of the first stack slot in bytes, later slots are sized to the first stack",
+                      ns3::UintegerValue(64 * 1024),
+                      ns3::MakeUintegerAccessor(&VanetzaStackFactory::m_arenaBlockSize),
+                      ns3::MakeUintegerChecker<uint32_t>(4096));
+    return tid;
+}
+
+void
+VanetzaStackFactory::SetConfig(const VanetzaStackConfig& config)
+{
+    NS_LOG_FUNCTION(this);
+    m_config = std::make_shared<const VanetzaStackConfig>(config);
+}
+
+std::shared_ptr<const VanetzaStackConfig>
+VanetzaStackFactory::GetConfig() const
+{
+    return m_config;
+}
+
+utils::ArenaPtr<VanetzaWrapper>
+VanetzaStackFactory::Create(vanetza::geonet::LinkLayer* linkLayer, uint32_t stationId,
+                            bool cacheStaticContainers)
+{
+    NS_LOG_FUNCTION(this << linkLayer << stationId << cacheStaticContainers);
+    
+    // Reuse the slot of a released stack, otherwise open a new one
+    utils::Arena* slot = nullptr;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        m_slots.push_back(std::make_unique<utils::Arena>(m_slotBlockSize > 0 ? m_slotBlockSize : m_arenaBlockSize));
+        slot = m_slots.back().get();
+    }
+    
+    ++m_stacks;
+    utils::ArenaPtr<VanetzaWrapper> stack = utils::makeArenaPtr<VanetzaWrapper>(slot, linkLayer, stationId, m_config,
+                                                                                slot, cacheStaticContainers);
+    
+    // All stacks have the same layout, so the first one sizes the others,
+    // with room for the alignment padding of each component
+    if (m_slotBlockSize == 0) {
+        m_slotBlockSize = slot->bytesUsed() + slot->allocations() * alignof(std::max_align_t);
+    }
+    return stack;
+}
+
+void
+VanetzaStackFactory::Release(utils::ArenaPtr<VanetzaWrapper> stack)
+{
+    NS_LOG_FUNCTION(this << stack.get());
+    if (!stack) {
+        return;
+    }
+    utils::Arena* slot = stack.get_deleter().arena;
+    NS_ASSERT_MSG(slot, "Stack was not created by a factory");
+    stack.reset();
+    NS_ASSERT_MSG(slot->liveObjects() == 0, "Stack slot still holds objects after its stack was destroyed");
+    slot->reset();
+    m_freeSlots.push_back(slot);
+}
+
+uint32_t
+VanetzaStackFactory::GetNStacks() const
+{
+    return m_stacks;
+}
+
+double
+VanetzaStackFactory::GetBytesPerStack() const
+{
+    const std::size_t live = m_slots.size() - m_freeSlots.size();
+    if (live == 0) {
+        return 0.0;
+    }
+    std::size_t used = 0;
+    for (const std::unique_ptr<utils::Arena>& slot : m_slots) {
+        used += slot->bytesUsed();
+    }
+    return static_cast<double>(used) / live;
+}
+
+void
+VanetzaStackFactory::WriteMemoryReport(std::ostream& os) const
+{
+    // Only the component objects are counted, memory they allocate
+    // internally (queues, buffers) comes from the general heap
+    std::size_t used = 0;
+    std::size_t reserved = 0;
+    std::size_t allocations = 0;
+    std::size_t blocks = 0;
+    for (const std::unique_ptr<utils::Arena>& slot : m_slots) {
+        used += slot->bytesUsed();
+        reserved += slot->bytesReserved();
+        allocations += slot->allocations();
+        blocks += slot->blocks();
+    }
+    
+    os << "Vanetza stack memory (shallow sizes, without memory the components allocate themselves):" << std::endl
+       << "  stacks created:         " << m_stacks << std::endl
+       << "  stack slots:            " << m_slots.size() << " (" << m_freeSlots.size() << " free)" << std::endl
+       << "  shared config:          " << sizeof(VanetzaStackConfig) << " bytes (once per fleet)" << std::endl
+       << "  slots used:             " << used << " bytes in " << allocations << " allocations" << std::endl
+       << "  slots reserved:         " << reserved << " bytes in " << blocks << " blocks" << std::endl
+       << "  bytes per live station: " << GetBytesPerStack() << std::endl
+       << "  per-station components: wrapper " << sizeof(VanetzaWrapper)
+       << ", router " << sizeof(vanetza::geonet::Router)
+       << ", dispatcher " << sizeof(vanetza::btp::PortDispatcher)
+       << ", access control " << sizeof(vanetza::dcc::AccessControl)
+       << ", timer " << sizeof(vanetza::facilities::Timer)
+       << ", CAM service " << sizeof(vanetza::facilities::CamService)
+       << ", encoder " << sizeof(messages::UperCamEncoder) << std::endl;
+}
+
+} // namespace vanetza_ns3
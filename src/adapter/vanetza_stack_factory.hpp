@@ -0,0 +1,113 @@
+#ifndef VANETZA_STACK_FACTORY_HPP
+#define VANETZA_STACK_FACTORY_HPP
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+#include <ns3/object.h>
+#include <vanetza/geonet/link_layer.hpp>
+
+#include "utils/arena.hpp"
+#include "vanetza_stack_config.hpp"
+
+namespace vanetza_ns3 {
+
+// Forward declarations
+class VanetzaWrapper;
+
+/**
+ * @brief Creates the Vanetza stacks of all stations of a simulation
+ * 
+ * All stacks created by one factory share a single immutable
+ * VanetzaStackConfig, so the MIB and CAM parameters exist once instead of
+ * once per station. The per-station components (router, dispatcher, DCC
+ * access control, timer, CAM service and encoder) of a stack are placed
+ * together in a slot, a small arena owned by the factory, which allows the
+ * memory per station to be reported. The first slot is sized by
+ * ArenaBlockSize, later slots by the footprint of the first stack.
+ * 
+ * A stack handed back with Release() frees its slot for the next station,
+ * so the memory follows the number of concurrently running stations
+ * rather than the number of stations ever started. Adapters keep a
+ * reference to the factory, so the slots outlive every stack created
+ * from them.
+ */
+class VanetzaStackFactory : public ns3::Object {
+public:
+    /**
+     * @brief Constructor
+     */
+    VanetzaStackFactory();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~VanetzaStackFactory();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    /**
+     * @brief Replace the shared configuration
+     * 
+     * Stacks created before keep the configuration they were created with.
+     * @param config The new configuration
+     */
+    void SetConfig(const VanetzaStackConfig& config);
+
+    /**
+     * @brief Get the shared configuration
+     * @return The configuration
+     */
+    std::shared_ptr<const VanetzaStackConfig> GetConfig() const;
+
+    /**
+     * @brief Create the Vanetza stack of a station
+     * @param linkLayer The link layer interface of the station
+     * @param stationId The station ID
+     * @param cacheStaticContainers Reuse the static CAM containers between CAMs
+     * @return The stack, living in a slot of the factory
+     */
+    utils::ArenaPtr<VanetzaWrapper> Create(vanetza::geonet::LinkLayer* linkLayer, uint32_t stationId,
+                                           bool cacheStaticContainers);
+
+    /**
+     * @brief Destroy a stack and make its slot available to the next station
+     * @param stack A stack created by this factory, may be empty
+     */
+    void Release(utils::ArenaPtr<VanetzaWrapper> stack);
+
+    /**
+     * @brief Get the number of stacks created so far
+     * @return The number of stacks
+     */
+    uint32_t GetNStacks() const;
+
+    /**
+     * @brief Get the slot bytes used per live stack
+     * @return The average number of bytes, 0 without live stacks
+     */
+    double GetBytesPerStack() const;
+
+    /**
+     * @brief Write the memory accounting of the created stacks
+     * @param os The output stream
+     */
+    void WriteMemoryReport(std::ostream& os) const;
+
+private:
+    std::shared_ptr<const VanetzaStackConfig> m_config;  ///< Shared configuration
+    std::vector<std::unique_ptr<utils::Arena> > m_slots; ///< Slots of the per-station components
+    std::vector<utils::Arena*> m_freeSlots;              ///< Slots of released stacks
+    uint32_t m_arenaBlockSize;                           ///< Block size of the first slot in bytes
+    std::size_t m_slotBlockSize;                         ///< Block size of later slots, 0 before the first stack
+    uint32_t m_stacks;                                   ///< Number of stacks created
+};
+
+} // namespace vanetza_ns3
+
+#endif // VANETZA_STACK_FACTORY_HPP
@@ -1,7 +1,9 @@
 #include "vanetza_wrapper.hpp"
 #include "ns3_interface.hpp"
+#include "btp_b_header.hpp"
 
 #include <ns3/log.h>
+#include <ns3/packet.h>
 #include <ns3/simulator.h>
 #include <vanetza/common/clock.hpp>
 
@@ -13,11 +15,24 @@ namespace vanetza_ns3 {
 
 NS_LOG_COMPONENT_DEFINE("VanetzaWrapper");
 
-VanetzaWrapper::VanetzaWrapper(vanetza::geonet::LinkLayer* link_layer, uint32_t station_id) :
+VanetzaWrapper::VanetzaWrapper(vanetza::geonet::LinkLayer* link_layer, uint32_t station_id,
+                               bool cache_static_containers) :
+    VanetzaWrapper(link_layer, station_id, std::make_shared<const VanetzaStackConfig>(),
+                   nullptr, cache_static_containers)
+{
+}
+
+VanetzaWrapper::VanetzaWrapper(vanetza::geonet::LinkLayer* link_layer, uint32_t station_id,
+                               std::shared_ptr<const VanetzaStackConfig> config, utils::Arena* arena,
+                               bool cache_static_containers) :
+    m_config(std::move(config)),
+    m_arena(arena),
     m_linkLayer(link_layer),
-    m_stationId(station_id)
+    m_stationId(station_id),
+    m_cacheStaticContainers(cache_static_containers),
+    m_lastLowFrequencyMs(-1)
 {
-    NS_LOG_FUNCTION(this << link_layer << station_id);
+    NS_LOG_FUNCTION(this << link_layer << station_id << arena << cache_static_containers);
     
     // Initialize Vanetza components
     initializeComponents();
@@ -28,7 +43,8 @@ VanetzaWrapper::~VanetzaWrapper()
     NS_LOG_FUNCTION(this);
     
     // Clean up Vanetza components
-    // The unique_ptr members will automatically clean up their resources
+    // The ArenaPtr members destroy the components in reverse dependency order,
+    // their memory is returned together with the arena
 }
 
 void
@@ -39,45 +55,50 @@ VanetzaWrapper::initializeComponents()
     // In a real implementation, these would be initialized with actual Vanetza components
     // For now, we'll use placeholders that would be replaced with actual initialization code
     
-    // Initialize Management Information Base (MIB)
-    m_mib = std::make_unique<vanetza::geonet::MIB>();
-    m_mib->itsGnLocalGnAddr.mid = m_stationId;
-    m_mib->itsGnLocalAddrConfMethod = vanetza::geonet::AddrConfMethod::MANAGED;
-    m_mib->itsGnProtocolVersion = 1;
+    // The MIB is shared by all stations, only the local address is our own
+    vanetza::geonet::Address address = m_config->mib.itsGnLocalGnAddr;
+    address.mid = m_stationId;
+    
+    // The link layer fills the source position vector of outgoing packets
+    if (m_linkLayer) {
+        static_cast<NS3Interface*>(m_linkLayer)->setVehicleProfile(m_config->vehicle);
+    }
     
     // Initialize DCC Access Control
-    m_accessControl = std::make_unique<vanetza::dcc::AccessControl>();
+    m_accessControl = utils::makeArenaPtr<vanetza::dcc::AccessControl>(m_arena);
     
     // Initialize GeoNetworking Router
-    m_router = std::make_unique<vanetza::geonet::Router>(*m_mib, *m_linkLayer, *m_accessControl);
+    m_router = utils::makeArenaPtr<vanetza::geonet::Router>(m_arena, m_config->mib, *m_linkLayer, *m_accessControl);
+    m_router->set_address(address);
     
     // Initialize BTP Port Dispatcher
-    m_dispatcher = std::make_unique<vanetza::btp::PortDispatcher>(*m_router);
+    m_dispatcher = utils::makeArenaPtr<vanetza::btp::PortDispatcher>(m_arena, *m_router);
     
     // Initialize Timer service
-    m_timer = std::make_unique<vanetza::facilities::Timer>();
-    
-    // Initialize CAM Service
-    m_camService = std::make_unique<vanetza::facilities::CamService>(*m_timer, *m_dispatcher);
-    
-    // Register for CAM indications
-    m_camService->set_cam_received_callback([this](const vanetza::facilities::CamService::cam_t& cam) {
-        // Convert CAM to binary format and forward to registered callback
-        if (m_camReceiverCallback) {
-            // In a real implementation, this would convert the CAM to binary format
-            // For now, we'll use a placeholder
-            uint8_t buffer[1024];
-            std::size_t length = 100; // Would be set to actual length
-            
-            // Fill buffer with CAM data (simplified example)
-            // In a real implementation, this would properly encode the CAM
-            uint32_t* station_id_ptr = reinterpret_cast<uint32_t*>(&buffer[0]);
-            *station_id_ptr = cam.station_id;
-            
-            // Forward to callback
-            m_camReceiverCallback(buffer, length);
-        }
-    });
+    m_timer = utils::makeArenaPtr<vanetza::facilities::Timer>(m_arena);
+    
+    // Initialize CAM Service. Its CAM indications are not subscribed to:
+    // they do not carry the decoded CAM content, so received CAMs reach the
+    // application through the adapter's receive path only.
+    m_camService = utils::makeArenaPtr<vanetza::facilities::CamService>(m_arena, *m_timer, *m_dispatcher);
+    
+    // Initialize UPER CAM encoder
+    m_camEncoder = utils::makeArenaPtr<messages::UperCamEncoder>(
+        m_arena, m_stationId, m_config->vehicle, m_cacheStaticContainers);
+}
+
+void
+VanetzaWrapper::reset(uint32_t station_id)
+{
+    NS_LOG_FUNCTION(this << station_id);
+    
+    m_stationId = station_id;
+    m_lastLowFrequencyMs = -1;
+    
+    vanetza::geonet::Address address = m_config->mib.itsGnLocalGnAddr;
+    address.mid = m_stationId;
+    m_router->set_address(address);
+    m_camEncoder->setStationId(m_stationId);
 }
 
 void
@@ -89,41 +110,50 @@ VanetzaWrapper::receivePacket(const uint8_t* buffer, std::size_t length)
     if (m_router) {
         // Create a clock time point for the current time
         vanetza::Clock::time_point now = vanetza::at_milliseconds(ns3::Simulator::Now().GetMilliSeconds());
+        
         m_router->indicate(buffer, length, now);
     }
 }
 
-void
-VanetzaWrapper::triggerCamTransmission()
+bool
+VanetzaWrapper::triggerCamTransmission(const messages::CamMessage& ego)
 {
     NS_LOG_FUNCTION(this);
     
-    // In a real implementation, this would trigger the CAM service to generate and send a CAM
-    if (m_camService) {
-        m_camService->trigger();
-    } else {
-        // For demonstration purposes, we'll create a dummy CAM message
-        // In a real implementation, this would be generated by the CAM service
-        uint8_t dummy_cam[100] = {0}; // Dummy CAM message
-        std::size_t dummy_cam_size = 100;
-        
-        // Set station ID in the dummy CAM
-        uint32_t* station_id_ptr = reinterpret_cast<uint32_t*>(&dummy_cam[0]);
-        *station_id_ptr = m_stationId;
-        
-        // Send the dummy CAM message using the link layer
-        if (m_linkLayer) {
-            // In a real implementation, this would be sent through the GeoNetworking router
-            static_cast<NS3Interface*>(m_linkLayer)->sendPacket(dummy_cam, dummy_cam_size);
-        }
+    // Low-frequency container at most every 500 ms (ETSI EN 302 637-2), always in the first CAM
+    int64_t now = ns3::Simulator::Now().GetMilliSeconds();
+    bool low_frequency = m_lastLowFrequencyMs < 0 || now - m_lastLowFrequencyMs >= m_config->lowFrequencyIntervalMs;
+    if (low_frequency) {
+        m_lastLowFrequencyMs = now;
     }
+    
+    vanetza::ByteBuffer cam = m_camEncoder->encode(ego, static_cast<uint64_t>(now), low_frequency);
+    
+    // Send the encoded CAM as Single-Hop Broadcast to the CA basic service port,
+    // the GeoNetworking and BTP headers are added to the packet in place
+    if (!m_linkLayer) {
+        return false;
+    }
+    ns3::Ptr<ns3::Packet> packet = ns3::Create<ns3::Packet>(cam.data(), cam.size());
+    return static_cast<NS3Interface*>(m_linkLayer)->sendShb(packet, BtpBHeader::kCamPort);
+}
+
+const messages::CamEncodingStats&
+VanetzaWrapper::getCamEncodingStats() const
+{
+    return m_camEncoder->stats();
+}
+
+int64_t
+VanetzaWrapper::getLastLowFrequencyMs() const
+{
+    return m_lastLowFrequencyMs;
 }
 
 void
-VanetzaWrapper::registerCamReceiver(std::function<void(const uint8_t*, std::size_t)> cb)
+VanetzaWrapper::setLastLowFrequencyMs(int64_t ms)
 {
-    NS_LOG_FUNCTION(this);
-    m_camReceiverCallback = cb;
+    m_lastLowFrequencyMs = ms;
 }
 
 } // namespace vanetza_ns3
\ No newline at end of file
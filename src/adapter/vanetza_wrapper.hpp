@@ -11,6 +11,11 @@
 #include <vanetza/facilities/timer.hpp>
 #include <vanetza/facilities/cam_service.hpp>
 
+#include "messages/cam_codec.hpp"
+#include "messages/uper_cam_encoder.hpp"
+#include "utils/arena.hpp"
+#include "vanetza_stack_config.hpp"
+
 // Forward declarations for Vanetza components
 namespace vanetza {
     namespace btp {
@@ -39,6 +44,11 @@ namespace vanetza_ns3 {
  * and provides a simplified interface for the NS3 adapter to use.
  * It manages the lifecycle of Vanetza components and handles
  * message passing between the adapter and Vanetza.
+ * 
+ * The immutable configuration (MIB defaults, CAM parameters) is shared
+ * with the other stations through VanetzaStackConfig. The mutable
+ * per-station components are allocated from an arena when one is given,
+ * see VanetzaStackFactory.
  */
 class VanetzaWrapper {
 public:
@@ -46,14 +56,38 @@ public:
      * @brief Constructor
      * @param link_layer The link layer interface to use
      * @param station_id The station ID to use
+     * @param cache_static_containers Reuse the static CAM containers between CAMs
      */
-    VanetzaWrapper(vanetza::geonet::LinkLayer* link_layer, uint32_t station_id);
+    VanetzaWrapper(vanetza::geonet::LinkLayer* link_layer, uint32_t station_id,
+                   bool cache_static_containers = true);
+
+    /**
+     * @brief Constructor for stacks sharing their configuration
+     * @param link_layer The link layer interface to use
+     * @param station_id The station ID to use
+     * @param config The shared configuration
+     * @param arena Arena for the per-station components, or nullptr for the heap
+     * @param cache_static_containers Reuse the static CAM containers between CAMs
+     */
+    VanetzaWrapper(vanetza::geonet::LinkLayer* link_layer, uint32_t station_id,
+                   std::shared_ptr<const VanetzaStackConfig> config, utils::Arena* arena,
+                   bool cache_static_containers = true);
 
     /**
      * @brief Destructor
      */
     ~VanetzaWrapper();
 
+    /**
+     * @brief Hand the stack to another station
+     * 
+     * Changes the GeoNetworking address and the station ID in the CAMs and
+     * forgets the per-station CAM state, keeping the components and their
+     * memory. Used when a pooled station slot is reused.
+     * @param station_id The new station ID
+     */
+    void reset(uint32_t station_id);
+
     /**
      * @brief Receive a packet from the network
      * @param buffer The packet data
@@ -62,15 +96,29 @@ public:
     void receivePacket(const uint8_t* buffer, std::size_t length);
 
     /**
-     * @brief Trigger the transmission of a CAM message
+     * @brief Trigger the transmission of a UPER encoded CAM message
+     * @param ego The current state of this station
+     * @return True if the link layer accepted the CAM
      */
-    void triggerCamTransmission();
+    bool triggerCamTransmission(const messages::CamMessage& ego);
 
     /**
-     * @brief Register a callback for received CAM messages
-     * @param cb The callback function
+     * @brief Get the cost of encoding the CAMs sent so far
+     * @return The encoding statistics
      */
-    void registerCamReceiver(std::function<void(const uint8_t*, std::size_t)> cb);
+    const messages::CamEncodingStats& getCamEncodingStats() const;
+
+    /**
+     * @brief Get the time of the last CAM carrying a low-frequency container
+     * @return The time in milliseconds, -1 if none was sent yet
+     */
+    int64_t getLastLowFrequencyMs() const;
+
+    /**
+     * @brief Set the time of the last low-frequency container, e.g. from a snapshot
+     * @param ms The time in milliseconds, -1 if none was sent yet
+     */
+    void setLastLowFrequencyMs(int64_t ms);
 
 private:
     /**
@@ -78,20 +126,23 @@ private:
      */
     void initializeComponents();
 
-    // Vanetza components
-    std::unique_ptr<vanetza::geonet::MIB> m_mib;                  ///< Management Information Base
-    std::unique_ptr<vanetza::geonet::Router> m_router;            ///< GeoNetworking router
-    std::unique_ptr<vanetza::btp::PortDispatcher> m_dispatcher;   ///< BTP port dispatcher
-    std::unique_ptr<vanetza::dcc::AccessControl> m_accessControl; ///< DCC access control
-    std::unique_ptr<vanetza::facilities::Timer> m_timer;          ///< Timer service
-    std::unique_ptr<vanetza::facilities::CamService> m_camService; ///< CAM service
+    // Shared configuration, outlives the components referring to it
+    std::shared_ptr<const VanetzaStackConfig> m_config;  ///< Fleet-wide configuration
+    utils::Arena* m_arena;                               ///< Arena of the components (nullptr: heap)
+
+    // Vanetza components, declared in dependency order
+    utils::ArenaPtr<vanetza::dcc::AccessControl> m_accessControl; ///< DCC access control
+    utils::ArenaPtr<vanetza::geonet::Router> m_router;            ///< GeoNetworking router
+    utils::ArenaPtr<vanetza::btp::PortDispatcher> m_dispatcher;   ///< BTP port dispatcher
+    utils::ArenaPtr<vanetza::facilities::Timer> m_timer;          ///< Timer service
+    utils::ArenaPtr<vanetza::facilities::CamService> m_camService; ///< CAM service
+    utils::ArenaPtr<messages::UperCamEncoder> m_camEncoder;        ///< UPER CAM encoder
 
     // Configuration
     vanetza::geonet::LinkLayer* m_linkLayer; ///< Link layer interface
     uint32_t m_stationId;                    ///< Station ID
-
-    // Callbacks
-    std::function<void(const uint8_t*, std::size_t)> m_camReceiverCallback; ///< Callback for received CAM messages
+    bool m_cacheStaticContainers;            ///< Reuse static CAM containers
+    int64_t m_lastLowFrequencyMs;            ///< Time of the last low-frequency container
 };
 
 } // namespace vanetza_ns3
@@ -0,0 +1,47 @@
+#include "cam_codec.hpp"
+
+namespace vanetza_ns3 {
+namespace messages {
+
+std::size_t
+encodeCam(const CamMessage& cam, uint8_t* buffer, std::size_t capacity)
+{
+    if (capacity < CamLayout::size) {
+        return 0;
+    }
+    
+    CamLayout::Version::store(buffer, kCamWireVersion);
+    CamLayout::MessageId::store(buffer, kCamMessageId);
+    CamLayout::StationId::store(buffer, cam.stationId);
+    CamLayout::Timestamp::store(buffer, cam.timestamp);
+    CamLayout::PosX::store(buffer, cam.posX);
+    CamLayout::PosY::store(buffer, cam.posY);
+    CamLayout::Speed::store(buffer, cam.speed);
+    CamLayout::Heading::store(buffer, cam.heading);
+    return CamLayout::size;
+}
+
+bool
+decodeCam(const uint8_t* buffer, std::size_t length, CamMessage& cam)
+{
+    if (length < CamLayout::size) {
+        return false;
+    }
+    
+    // Version and message ID are checked together to keep a single branch
+    if ((CamLayout::Version::load(buffer) != kCamWireVersion) |
+        (CamLayout::MessageId::load(buffer) != kCamMessageId)) {
+        return false;
+    }
+    
+    cam.stationId = CamLayout::StationId::load(buffer);
+    cam.timestamp = CamLayout::Timestamp::load(buffer);
+    cam.posX = CamLayout::PosX::load(buffer);
+    cam.posY = CamLayout::PosY::load(buffer);
+    cam.speed = CamLayout::Speed::load(buffer);
+    cam.heading = CamLayout::Heading::load(buffer);
+    return true;
+}
+
+} // namespace messages
+} // namespace vanetza_ns3
@@ -0,0 +1,146 @@
+/**
+ * @file cam_codec.hpp
+ * @brief Wire format of the simplified CAM exchanged by the adapter
+ */
+
+#ifndef CAM_CODEC_HPP
+#define CAM_CODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace vanetza_ns3 {
+namespace messages {
+
+/**
+ * @brief Decoded content of a simplified CAM
+ */
+struct CamMessage {
+    uint32_t stationId = 0;   ///< Station ID of the originator
+    uint32_t timestamp = 0;   ///< Generation time in seconds since simulation start
+    float posX = 0.0f;        ///< X position in meters
+    float posY = 0.0f;        ///< Y position in meters
+    float speed = 0.0f;       ///< Speed in m/s
+    float heading = 0.0f;     ///< Heading in degrees
+};
+
+namespace wire {
+
+/**
+ * @brief Big-endian encoding of a single value type
+ */
+template<typename T>
+struct Codec;
+
+template<>
+struct Codec<uint8_t> {
+    static void store(uint8_t* p, uint8_t v) { p[0] = v; }
+    static uint8_t load(const uint8_t* p) { return p[0]; }
+};
+
+template<>
+struct Codec<uint32_t> {
+    static void store(uint8_t* p, uint32_t v)
+    {
+        p[0] = static_cast<uint8_t>(v >> 24);
+        p[1] = static_cast<uint8_t>(v >> 16);
+        p[2] = static_cast<uint8_t>(v >> 8);
+        p[3] = static_cast<uint8_t>(v);
+    }
+    static uint32_t load(const uint8_t* p)
+    {
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+               (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+    }
+};
+
+template<>
+struct Codec<float> {
+    static_assert(sizeof(float) == sizeof(uint32_t), "IEEE 754 single precision float required");
+    static void store(uint8_t* p, float v)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        Codec<uint32_t>::store(p, bits);
+    }
+    static float load(const uint8_t* p)
+    {
+        uint32_t bits = Codec<uint32_t>::load(p);
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+};
+
+/**
+ * @brief A field of type T located at a fixed byte offset
+ */
+template<typename T, std::size_t Offset>
+struct Field {
+    using type = T;
+    static constexpr std::size_t offset = Offset;
+    static constexpr std::size_t end = Offset + sizeof(T);
+
+    static void store(uint8_t* buffer, T value) { Codec<T>::store(buffer + offset, value); }
+    static T load(const uint8_t* buffer) { return Codec<T>::load(buffer + offset); }
+};
+
+/**
+ * @brief Field that directly follows another field
+ */
+template<typename T, typename Previous>
+using Next = Field<T, Previous::end>;
+
+} // namespace wire
+
+/**
+ * @brief Version of the wire format written by encodeCam
+ */
+constexpr uint8_t kCamWireVersion = 1;
+
+/**
+ * @brief Message ID of a CAM (ETSI TS 102 894-2 ItsPduHeader)
+ */
+constexpr uint8_t kCamMessageId = 2;
+
+/**
+ * @brief Byte layout of the simplified CAM, all fields big-endian
+ */
+struct CamLayout {
+    using Version   = wire::Field<uint8_t, 0>;
+    using MessageId = wire::Next<uint8_t, Version>;
+    using StationId = wire::Next<uint32_t, MessageId>;
+    using Timestamp = wire::Next<uint32_t, StationId>;
+    using PosX      = wire::Next<float, Timestamp>;
+    using PosY      = wire::Next<float, PosX>;
+    using Speed     = wire::Next<float, PosY>;
+    using Heading   = wire::Next<float, Speed>;
+
+    static constexpr std::size_t size = Heading::end;  ///< Encoded size in bytes
+};
+
+static_assert(CamLayout::size == 26, "unexpected CAM wire size");
+
+/**
+ * @brief Encode a CAM into a caller-provided buffer
+ * @param cam The CAM to encode
+ * @param buffer The output buffer
+ * @param capacity The size of the output buffer
+ * @return The number of bytes written, or 0 if the buffer is too small
+ */
+std::size_t encodeCam(const CamMessage& cam, uint8_t* buffer, std::size_t capacity);
+
+/**
+ * @brief Decode a CAM from a received buffer
+ * @param buffer The received data
+ * @param length The length of the received data
+ * @param cam The decoded CAM (only valid if true is returned)
+ * @return True if the buffer holds a CAM of a supported version
+ */
+bool decodeCam(const uint8_t* buffer, std::size_t length, CamMessage& cam);
+
+} // namespace messages
+} // namespace vanetza_ns3
+
+#endif // CAM_CODEC_HPP
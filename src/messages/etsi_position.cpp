@@ -0,0 +1,39 @@
+#include "etsi_position.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vanetza_ns3 {
+namespace messages {
+
+namespace {
+
+constexpr double kMetersPerDegree = 111320.0;
+constexpr double kPi = 3.14159265358979323846;
+
+} // namespace
+
+EtsiPosition
+toEtsiPosition(double x, double y, double originLatitude, double originLongitude)
+{
+    const double latitude = originLatitude + y / kMetersPerDegree;
+    const double longitude = originLongitude + x / (kMetersPerDegree * std::cos(originLatitude * kPi / 180.0));
+    EtsiPosition position;
+    position.latitude = static_cast<int32_t>(std::lround(latitude * 1e7));
+    position.longitude = static_cast<int32_t>(std::lround(longitude * 1e7));
+    return position;
+}
+
+uint16_t
+toEtsiHeading(double heading)
+{
+    // Counter-clockwise from east to clockwise from north, fmod keeps the sign
+    double etsi = std::fmod(450.0 - heading, 360.0);
+    if (etsi < 0.0) {
+        etsi += 360.0;
+    }
+    return static_cast<uint16_t>(std::min(std::lround(etsi * 10.0), 3599L));
+}
+
+} // namespace messages
+} // namespace vanetza_ns3
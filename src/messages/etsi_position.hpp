@@ -0,0 +1,46 @@
+/**
+ * @file etsi_position.hpp
+ * @brief Conversion of simulation coordinates into ETSI position units
+ */
+
+#ifndef ETSI_POSITION_HPP
+#define ETSI_POSITION_HPP
+
+#include <cstdint>
+
+namespace vanetza_ns3 {
+namespace messages {
+
+/**
+ * @brief Geographic position in the units of CAMs and GeoNetworking
+ */
+struct EtsiPosition {
+    int32_t latitude = 0;     ///< Latitude in 1/10 micro degree
+    int32_t longitude = 0;    ///< Longitude in 1/10 micro degree
+};
+
+/**
+ * @brief Map simulation coordinates to a geographic position
+ * 
+ * The simulation plane is a local tangent plane around the origin, with X
+ * pointing east and Y pointing north. CAM reference positions and
+ * GeoNetworking position vectors both use this mapping.
+ * @param x X coordinate in meters
+ * @param y Y coordinate in meters
+ * @param originLatitude Latitude of the simulation origin in degrees
+ * @param originLongitude Longitude of the simulation origin in degrees
+ * @return The position
+ */
+EtsiPosition toEtsiPosition(double x, double y, double originLatitude, double originLongitude);
+
+/**
+ * @brief Map a simulation heading to an ETSI heading
+ * @param heading Heading in degrees, counter-clockwise from east
+ * @return Heading in 0.1 degree clockwise from north, 0 to 3599
+ */
+uint16_t toEtsiHeading(double heading);
+
+} // namespace messages
+} // namespace vanetza_ns3
+
+#endif // ETSI_POSITION_HPP
@@ -0,0 +1,177 @@
+#include "uper_cam_encoder.hpp"
+#include "etsi_position.hpp"
+
+#include <vanetza/asn1/asn1c_wrapper.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace vanetza_ns3 {
+namespace messages {
+
+namespace {
+
+/**
+ * @brief Detaches the cached low-frequency container after encoding
+ */
+class LowFrequencyAttachment {
+public:
+    LowFrequencyAttachment(vanetza::asn1::Cam& message, LowFrequencyContainer_t* lf) :
+        m_slot(message->cam.camParameters.lowFrequencyContainer)
+    {
+        m_slot = lf;
+    }
+
+    ~LowFrequencyAttachment()
+    {
+        m_slot = nullptr;
+    }
+
+private:
+    LowFrequencyContainer_t*& m_slot;
+};
+
+} // namespace
+
+UperCamEncoder::UperCamEncoder(uint32_t stationId, const CamVehicleProfile& profile, bool cacheStaticContainers) :
+    m_stationId(stationId),
+    m_profile(profile),
+    m_cache(cacheStaticContainers)
+{
+    if (m_cache) {
+        fillStatic(m_message);
+        m_lowFrequency.reset(buildLowFrequency());
+    }
+}
+
+UperCamEncoder::~UperCamEncoder()
+{
+}
+
+void
+UperCamEncoder::LowFrequencyDeleter::operator()(LowFrequencyContainer_t* lf) const
+{
+    ASN_STRUCT_FREE(asn_DEF_LowFrequencyContainer, lf);
+}
+
+vanetza::ByteBuffer
+UperCamEncoder::encode(const CamMessage& ego, uint64_t generationTimeMs, bool lowFrequency)
+{
+    auto start = std::chrono::steady_clock::now();
+    vanetza::ByteBuffer buffer;
+    
+    if (m_cache) {
+        fillDynamic(m_message, ego, generationTimeMs);
+        LowFrequencyAttachment attachment(m_message, lowFrequency ? m_lowFrequency.get() : nullptr);
+        buffer = m_message.encode();
+    } else {
+        vanetza::asn1::Cam message;
+        fillStatic(message);
+        fillDynamic(message, ego, generationTimeMs);
+        if (lowFrequency) {
+            message->cam.camParameters.lowFrequencyContainer = buildLowFrequency();
+        }
+        buffer = message.encode();
+    }
+    
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    m_stats.cams += 1;
+    m_stats.lowFrequency += lowFrequency ? 1 : 0;
+    m_stats.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    m_stats.bytes += buffer.size();
+    return buffer;
+}
+
+void
+UperCamEncoder::setStationId(uint32_t stationId)
+{
+    m_stationId = stationId;
+    if (m_cache) {
+        m_message->header.stationID = m_stationId;
+    }
+}
+
+const CamEncodingStats&
+UperCamEncoder::stats() const
+{
+    return m_stats;
+}
+
+bool
+UperCamEncoder::cachesStaticContainers() const
+{
+    return m_cache;
+}
+
+void
+UperCamEncoder::fillStatic(vanetza::asn1::Cam& message) const
+{
+    ItsPduHeader_t& header = message->header;
+    header.protocolVersion = 2;
+    header.messageID = ItsPduHeader__messageID_cam;
+    header.stationID = m_stationId;
+    
+    BasicContainer_t& basic = message->cam.camParameters.basicContainer;
+    basic.stationType = m_profile.stationType;
+    basic.referencePosition.altitude.altitudeValue = AltitudeValue_unavailable;
+    basic.referencePosition.altitude.altitudeConfidence = AltitudeConfidence_unavailable;
+    basic.referencePosition.positionConfidenceEllipse.semiMajorConfidence = SemiAxisLength_unavailable;
+    basic.referencePosition.positionConfidenceEllipse.semiMinorConfidence = SemiAxisLength_unavailable;
+    basic.referencePosition.positionConfidenceEllipse.semiMajorOrientation = HeadingValue_unavailable;
+    
+    HighFrequencyContainer_t& hfc = message->cam.camParameters.highFrequencyContainer;
+    hfc.present = HighFrequencyContainer_PR_basicVehicleContainerHighFrequency;
+    BasicVehicleContainerHighFrequency_t& bvc = hfc.choice.basicVehicleContainerHighFrequency;
+    bvc.headingConfidence = HeadingConfidence_equalOrWithinOneDegree;
+    bvc.speedConfidence = SpeedConfidence_equalOrWithinOneCentimeterPerSec;
+    bvc.vehicleLength.vehicleLengthValue = m_profile.vehicleLength;
+    bvc.vehicleLength.vehicleLengthConfidenceIndication = VehicleLengthConfidenceIndication_noTrailerPresent;
+    bvc.vehicleWidth = m_profile.vehicleWidth;
+    bvc.longitudinalAcceleration.longitudinalAccelerationValue = LongitudinalAccelerationValue_unavailable;
+    bvc.longitudinalAcceleration.longitudinalAccelerationConfidence = AccelerationConfidence_unavailable;
+    bvc.curvature.curvatureValue = CurvatureValue_unavailable;
+    bvc.curvature.curvatureConfidence = CurvatureConfidence_unavailable;
+    bvc.curvatureCalculationMode = CurvatureCalculationMode_unavailable;
+    bvc.yawRate.yawRateValue = YawRateValue_unavailable;
+    bvc.yawRate.yawRateConfidence = YawRateConfidence_unavailable;
+}
+
+void
+UperCamEncoder::fillDynamic(vanetza::asn1::Cam& message, const CamMessage& ego, uint64_t generationTimeMs) const
+{
+    message->cam.generationDeltaTime = static_cast<long>((generationTimeMs * GenerationDeltaTime_oneMilliSec) % 65536);
+    
+    // Local tangent plane around the configured origin
+    const EtsiPosition position = toEtsiPosition(ego.posX, ego.posY,
+                                                 m_profile.originLatitude, m_profile.originLongitude);
+    BasicContainer_t& basic = message->cam.camParameters.basicContainer;
+    basic.referencePosition.latitude = position.latitude;
+    basic.referencePosition.longitude = position.longitude;
+    
+    BasicVehicleContainerHighFrequency_t& bvc =
+        message->cam.camParameters.highFrequencyContainer.choice.basicVehicleContainerHighFrequency;
+    bvc.heading.headingValue = toEtsiHeading(ego.heading);
+    bvc.speed.speedValue = std::min(std::lround(std::fabs(ego.speed) * 100.0), 16382L);
+    bvc.driveDirection = DriveDirection_forward;
+}
+
+LowFrequencyContainer_t*
+UperCamEncoder::buildLowFrequency() const
+{
+    LowFrequencyContainer_t* lf = vanetza::asn1::allocate<LowFrequencyContainer_t>();
+    lf->present = LowFrequencyContainer_PR_basicVehicleContainerLowFrequency;
+    BasicVehicleContainerLowFrequency_t& bvlf = lf->choice.basicVehicleContainerLowFrequency;
+    bvlf.vehicleRole = m_profile.vehicleRole;
+    
+    // ExteriorLights is a fixed 8 bit string, all lights off
+    bvlf.exteriorLights.buf = static_cast<uint8_t*>(vanetza::asn1::allocate(1));
+    bvlf.exteriorLights.size = 1;
+    bvlf.exteriorLights.bits_unused = 0;
+    
+    // The path history stays empty: no recorded trajectory points
+    return lf;
+}
+
+} // namespace messages
+} // namespace vanetza_ns3
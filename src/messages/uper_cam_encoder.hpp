@@ -0,0 +1,117 @@
+/**
+ * @file uper_cam_encoder.hpp
+ * @brief UPER encoding of ETSI CAMs through Vanetza's ASN.1 layer
+ */
+
+#ifndef UPER_CAM_ENCODER_HPP
+#define UPER_CAM_ENCODER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vanetza/asn1/cam.hpp>
+#include <vanetza/common/byte_buffer.hpp>
+
+#include "cam_codec.hpp"
+
+namespace vanetza_ns3 {
+namespace messages {
+
+/**
+ * @brief Static vehicle properties carried in every CAM
+ */
+struct CamVehicleProfile {
+    long stationType = 5;          ///< StationType (5 = passenger car)
+    long vehicleRole = 0;          ///< VehicleRole (0 = default)
+    long vehicleLength = 45;       ///< VehicleLengthValue in 0.1 m
+    long vehicleWidth = 18;        ///< VehicleWidth in 0.1 m
+    double originLatitude = 48.7;  ///< Latitude of the simulation origin in degrees
+    double originLongitude = 11.4; ///< Longitude of the simulation origin in degrees
+};
+
+/**
+ * @brief Encoding cost accumulated by an encoder
+ */
+struct CamEncodingStats {
+    uint64_t cams = 0;             ///< Number of encoded CAMs
+    uint64_t lowFrequency = 0;     ///< CAMs carrying a low-frequency container
+    uint64_t nanoseconds = 0;      ///< Total wall-clock time spent encoding
+    uint64_t bytes = 0;            ///< Total encoded bytes
+};
+
+/**
+ * @brief Encodes real ETSI CAMs (UPER) for one station
+ * 
+ * With caching enabled the encoder keeps one ASN.1 message whose basic
+ * container and low-frequency container (vehicle role, exterior lights)
+ * are built once. The path history is always sent empty, the station
+ * records no trajectory points. Per CAM only the high-frequency container
+ * and generation time are rewritten before encoding, so the ASN.1 tree is
+ * neither rebuilt nor reallocated. Without caching every CAM is built from
+ * scratch, which matches a naive facility implementation.
+ */
+class UperCamEncoder {
+public:
+    /**
+     * @brief Constructor
+     * @param stationId The station ID written into the ITS PDU header
+     * @param profile The static vehicle properties
+     * @param cacheStaticContainers Whether to reuse the static containers
+     */
+    UperCamEncoder(uint32_t stationId, const CamVehicleProfile& profile, bool cacheStaticContainers);
+
+    /**
+     * @brief Destructor
+     */
+    ~UperCamEncoder();
+
+    UperCamEncoder(const UperCamEncoder&) = delete;
+    UperCamEncoder& operator=(const UperCamEncoder&) = delete;
+
+    /**
+     * @brief Encode a CAM
+     * @param ego The current state of the station
+     * @param generationTimeMs The generation time in milliseconds
+     * @param lowFrequency Whether to include the low-frequency container
+     * @return The UPER encoded CAM
+     */
+    vanetza::ByteBuffer encode(const CamMessage& ego, uint64_t generationTimeMs, bool lowFrequency);
+
+    /**
+     * @brief Change the station ID written into the ITS PDU header
+     * @param stationId The new station ID
+     */
+    void setStationId(uint32_t stationId);
+
+    /**
+     * @brief Get the accumulated encoding cost
+     * @return The statistics
+     */
+    const CamEncodingStats& stats() const;
+
+    /**
+     * @brief Check whether static containers are cached
+     * @return True if caching is enabled
+     */
+    bool cachesStaticContainers() const;
+
+private:
+    struct LowFrequencyDeleter {
+        void operator()(LowFrequencyContainer_t* lf) const;
+    };
+
+    void fillStatic(vanetza::asn1::Cam& message) const;
+    void fillDynamic(vanetza::asn1::Cam& message, const CamMessage& ego, uint64_t generationTimeMs) const;
+    LowFrequencyContainer_t* buildLowFrequency() const;
+
+    uint32_t m_stationId;                   ///< Station ID
+    CamVehicleProfile m_profile;            ///< Static vehicle properties
+    bool m_cache;                           ///< Reuse static containers
+    vanetza::asn1::Cam m_message;           ///< Cached message (cache enabled only)
+    std::unique_ptr<LowFrequencyContainer_t, LowFrequencyDeleter> m_lowFrequency; ///< Cached LF container
+    CamEncodingStats m_stats;               ///< Accumulated encoding cost
+};
+
+} // namespace messages
+} // namespace vanetza_ns3
+
+#endif // UPER_CAM_ENCODER_HPP
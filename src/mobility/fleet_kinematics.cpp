@@ -0,0 +1,189 @@
+#include "fleet_kinematics.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace vanetza_ns3 {
+namespace mobility {
+
+namespace {
+
+constexpr double kForever = std::numeric_limits<double>::infinity();
+
+// p = p0 + v * min(t - t0, span), written so that the compiler vectorises it
+void
+advancePositions(std::size_t n, double time, const double* __restrict__ t0, const double* __restrict__ span,
+                 const double* __restrict__ x0, const double* __restrict__ y0, const double* __restrict__ z0,
+                 const double* __restrict__ vx, const double* __restrict__ vy, const double* __restrict__ vz,
+                 double* __restrict__ x, double* __restrict__ y, double* __restrict__ z)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        double dt = time - t0[i];
+        dt = dt < span[i] ? dt : span[i];
+        x[i] = x0[i] + vx[i] * dt;
+        y[i] = y0[i] + vy[i] * dt;
+        z[i] = z0[i] + vz[i] * dt;
+    }
+}
+
+} // namespace
+
+FleetKinematics::FleetKinematics() :
+    m_time(-1.0),
+    m_current(false),
+    m_nextBoundary(kForever)
+{
+}
+
+uint32_t
+FleetKinematics::add(double time, double x, double y, double z, double vx, double vy, double vz)
+{
+    const uint32_t index = static_cast<uint32_t>(size());
+    m_t0.push_back(time);
+    m_span.push_back(kForever);
+    m_x0.push_back(x);
+    m_y0.push_back(y);
+    m_z0.push_back(z);
+    m_vx.push_back(vx);
+    m_vy.push_back(vy);
+    m_vz.push_back(vz);
+    m_x.push_back(x);
+    m_y.push_back(y);
+    m_z.push_back(z);
+    m_waypoints.emplace_back();
+    m_nextWaypoint.push_back(0);
+    m_current = false;
+    return index;
+}
+
+void
+FleetKinematics::rebase(uint32_t index, double time)
+{
+    position(index, time, m_x0[index], m_y0[index], m_z0[index]);
+    m_t0[index] = time;
+}
+
+void
+FleetKinematics::setPosition(uint32_t index, double time, double x, double y, double z)
+{
+    m_t0[index] = time;
+    m_x0[index] = x;
+    m_y0[index] = y;
+    m_z0[index] = z;
+    if (m_span[index] != kForever) {
+        m_waypoints[index].clear();
+        m_nextWaypoint[index] = 0;
+        m_span[index] = kForever;
+        m_vx[index] = m_vy[index] = m_vz[index] = 0.0;
+    }
+    m_current = false;
+}
+
+void
+FleetKinematics::setVelocity(uint32_t index, double time, double vx, double vy, double vz)
+{
+    rebase(index, time);
+    m_span[index] = kForever;
+    m_vx[index] = vx;
+    m_vy[index] = vy;
+    m_vz[index] = vz;
+    m_waypoints[index].clear();
+    m_nextWaypoint[index] = 0;
+    m_current = false;
+}
+
+void
+FleetKinematics::addWaypoint(uint32_t index, double time, const FleetWaypoint& waypoint)
+{
+    if (m_span[index] == kForever) {
+        // End the open segment now, the next update heads for the waypoint
+        rebase(index, time);
+        m_span[index] = 0.0;
+        m_vx[index] = m_vy[index] = m_vz[index] = 0.0;
+        m_nextBoundary = std::min(m_nextBoundary, time);
+        m_current = false;
+    }
+    m_waypoints[index].push_back(waypoint);
+}
+
+std::size_t
+FleetKinematics::pendingWaypoints(uint32_t index) const
+{
+    return m_waypoints[index].size() - m_nextWaypoint[index];
+}
+
+bool
+FleetKinematics::nextSegments(uint32_t index, double time)
+{
+    bool changed = false;
+    while (m_t0[index] + m_span[index] <= time && m_span[index] != kForever) {
+        const double end = m_t0[index] + m_span[index];
+        rebase(index, end);
+        
+        std::vector<FleetWaypoint>& waypoints = m_waypoints[index];
+        uint32_t& next = m_nextWaypoint[index];
+        if (next < waypoints.size()) {
+            const FleetWaypoint& waypoint = waypoints[next++];
+            const double span = std::max(waypoint.time - end, 0.0);
+            m_span[index] = span;
+            if (span > 0.0) {
+                m_vx[index] = (waypoint.x - m_x0[index]) / span;
+                m_vy[index] = (waypoint.y - m_y0[index]) / span;
+                m_vz[index] = (waypoint.z - m_z0[index]) / span;
+            } else {
+                // Late waypoint: jump there
+                m_x0[index] = waypoint.x;
+                m_y0[index] = waypoint.y;
+                m_z0[index] = waypoint.z;
+                m_vx[index] = m_vy[index] = m_vz[index] = 0.0;
+            }
+        } else {
+            // Last waypoint reached: stand still
+            waypoints.clear();
+            next = 0;
+            m_span[index] = kForever;
+            m_vx[index] = m_vy[index] = m_vz[index] = 0.0;
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+bool
+FleetKinematics::update(uint32_t index, double time)
+{
+    if (time < m_nextBoundary || !nextSegments(index, time)) {
+        return false;
+    }
+    m_current = false;
+    return true;
+}
+
+void
+FleetKinematics::advance(double time)
+{
+    m_changed.clear();
+    
+    // Scalar pass over segment ends, only when one may have been reached
+    if (time >= m_nextBoundary) {
+        double boundary = kForever;
+        for (uint32_t i = 0; i < size(); ++i) {
+            if (nextSegments(i, time)) {
+                m_changed.push_back(i);
+            }
+            boundary = std::min(boundary, m_t0[i] + m_span[i]);
+        }
+        m_nextBoundary = boundary;
+    }
+    
+    // Vectorised kernel over all vehicles
+    advancePositions(size(), time, m_t0.data(), m_span.data(),
+                     m_x0.data(), m_y0.data(), m_z0.data(), m_vx.data(), m_vy.data(), m_vz.data(),
+                     m_x.data(), m_y.data(), m_z.data());
+    
+    m_time = time;
+    m_current = true;
+}
+
+} // namespace mobility
+} // namespace vanetza_ns3
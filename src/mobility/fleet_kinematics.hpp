@@ -0,0 +1,205 @@
+#ifndef FLEET_KINEMATICS_HPP
+#define FLEET_KINEMATICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vanetza_ns3 {
+namespace mobility {
+
+/**
+ * @brief Waypoint of a vehicle driven by FleetKinematics
+ */
+struct FleetWaypoint {
+    double time;  ///< Time the waypoint is reached in seconds
+    double x;     ///< X coordinate in meters
+    double y;     ///< Y coordinate in meters
+    double z;     ///< Z coordinate in meters
+};
+
+/**
+ * @brief Piecewise linear motion of a fleet in structure-of-arrays form
+ * 
+ * Every vehicle moves along one linear segment at a time: it is at p0 at
+ * time t0 and moves with velocity v until t0 + span. Constant-velocity
+ * vehicles have an infinite span; waypoint vehicles start a new segment
+ * towards their next waypoint when a segment ends, and stop after the
+ * last one.
+ * 
+ * advance() evaluates all positions for one time in a branch-free loop
+ * over contiguous arrays that the compiler vectorises, after which a
+ * position lookup is a plain load. position() evaluates a single vehicle
+ * for queries between batches. Positions are always computed from the
+ * segment start, so no error accumulates over many steps.
+ */
+class FleetKinematics {
+public:
+    /**
+     * @brief Constructor
+     */
+    FleetKinematics();
+
+    /**
+     * @brief Get the number of vehicles
+     * @return The number of vehicles
+     */
+    std::size_t size() const { return m_t0.size(); }
+
+    /**
+     * @brief Add a vehicle moving with constant velocity
+     * @param time Current time in seconds
+     * @param x,y,z Position in meters
+     * @param vx,vy,vz Velocity in m/s
+     * @return The vehicle index
+     */
+    uint32_t add(double time, double x, double y, double z, double vx, double vy, double vz);
+
+    /**
+     * @brief Place a vehicle
+     * 
+     * A constant-velocity vehicle keeps its velocity, a waypoint vehicle
+     * drops its remaining waypoints and stops.
+     * @param index The vehicle index
+     * @param time Current time in seconds
+     * @param x,y,z Position in meters
+     */
+    void setPosition(uint32_t index, double time, double x, double y, double z);
+
+    /**
+     * @brief Let a vehicle move with constant velocity from its current position
+     * 
+     * Drops the remaining waypoints of the vehicle.
+     * @param index The vehicle index
+     * @param time Current time in seconds
+     * @param vx,vy,vz Velocity in m/s
+     */
+    void setVelocity(uint32_t index, double time, double vx, double vy, double vz);
+
+    /**
+     * @brief Append a waypoint to a vehicle
+     * 
+     * A vehicle without pending waypoints heads from its current position
+     * to the new one. Waypoints must be added in time order.
+     * @param index The vehicle index
+     * @param time Current time in seconds
+     * @param waypoint The waypoint, not before time
+     */
+    void addWaypoint(uint32_t index, double time, const FleetWaypoint& waypoint);
+
+    /**
+     * @brief Get the number of waypoints a vehicle has not started towards
+     * @param index The vehicle index
+     * @return The number of waypoints
+     */
+    std::size_t pendingWaypoints(uint32_t index) const;
+
+    /**
+     * @brief Move a single vehicle to the segment containing a time
+     * @param index The vehicle index
+     * @param time The time in seconds, not before previous calls
+     * @return True if the vehicle changed its segment
+     */
+    bool update(uint32_t index, double time);
+
+    /**
+     * @brief Evaluate the positions of all vehicles at a time
+     * 
+     * Vehicles that changed their segment are listed in changed().
+     * @param time The time in seconds, not before previous calls
+     */
+    void advance(double time);
+
+    /**
+     * @brief Get the time of the last advance()
+     * @return The time in seconds, negative before the first advance()
+     */
+    double time() const { return m_time; }
+
+    /**
+     * @brief Check whether the position arrays hold the positions at a time
+     * 
+     * Changes to a vehicle invalidate the arrays until the next advance().
+     * @param time The time in seconds
+     * @return True if x(), y() and z() are current
+     */
+    bool isCurrent(double time) const { return m_current && time == m_time; }
+
+    /**
+     * @brief Get the vehicles that changed their segment in the last advance()
+     * @return The vehicle indices
+     */
+    const std::vector<uint32_t>& changed() const { return m_changed; }
+
+    /**
+     * @brief Position arrays, valid while isCurrent()
+     * @return Coordinate per vehicle
+     */
+    const double* x() const { return m_x.data(); }
+    const double* y() const { return m_y.data(); }
+    const double* z() const { return m_z.data(); }
+
+    /**
+     * @brief Velocity arrays of the current segments
+     * @return Velocity component per vehicle
+     */
+    const double* vx() const { return m_vx.data(); }
+    const double* vy() const { return m_vy.data(); }
+    const double* vz() const { return m_vz.data(); }
+
+    /**
+     * @brief Evaluate the position of a vehicle in its current segment
+     * @param index The vehicle index
+     * @param time The time in seconds, see update()
+     * @param[out] x,y,z Position in meters
+     */
+    void position(uint32_t index, double time, double& x, double& y, double& z) const
+    {
+        double dt = time - m_t0[index];
+        dt = dt < m_span[index] ? dt : m_span[index];
+        x = m_x0[index] + m_vx[index] * dt;
+        y = m_y0[index] + m_vy[index] * dt;
+        z = m_z0[index] + m_vz[index] * dt;
+    }
+
+private:
+    /**
+     * @brief Start a segment of a vehicle at its current position
+     */
+    void rebase(uint32_t index, double time);
+
+    /**
+     * @brief Start the segments until the one containing a time
+     * @return True if the vehicle changed its segment
+     */
+    bool nextSegments(uint32_t index, double time);
+
+    // Current segment, one entry per vehicle
+    std::vector<double> m_t0;     ///< Segment start time
+    std::vector<double> m_span;   ///< Segment duration, infinite for constant velocity
+    std::vector<double> m_x0;     ///< Position at segment start
+    std::vector<double> m_y0;
+    std::vector<double> m_z0;
+    std::vector<double> m_vx;     ///< Velocity during the segment
+    std::vector<double> m_vy;
+    std::vector<double> m_vz;
+
+    // Positions at m_time, one entry per vehicle
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_z;
+
+    // Waypoints
+    std::vector<std::vector<FleetWaypoint>> m_waypoints;  ///< Waypoints per vehicle
+    std::vector<uint32_t> m_nextWaypoint;                 ///< Next waypoint per vehicle
+
+    double m_time;                    ///< Time of the last advance()
+    bool m_current;                   ///< Position arrays match the segments at m_time
+    double m_nextBoundary;            ///< No segment ends before this time
+    std::vector<uint32_t> m_changed;  ///< Vehicles that changed segment in the last advance()
+};
+
+} // namespace mobility
+} // namespace vanetza_ns3
+
+#endif // FLEET_KINEMATICS_HPP
@@ -0,0 +1,248 @@
+#include "fleet_mobility_store.hpp"
+
+#include <ns3/log.h>
+#include <ns3/node.h>
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+
+#include <algorithm>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("FleetMobilityStore");
+
+NS_OBJECT_ENSURE_REGISTERED(FleetMobilityModel);
+NS_OBJECT_ENSURE_REGISTERED(FleetMobilityStore);
+
+FleetMobilityModel::FleetMobilityModel() :
+    m_index(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FleetMobilityModel::~FleetMobilityModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ns3::TypeId
+FleetMobilityModel::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::FleetMobilityModel")
+        .SetParent<ns3::MobilityModel>()
+        .SetGroupName("VANET");
+    return tid;
+}
+
+void
+FleetMobilityModel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_store) {
+        m_store->m_models[m_index] = nullptr;
+        m_store = nullptr;
+    }
+    ns3::MobilityModel::DoDispose();
+}
+
+uint32_t
+FleetMobilityModel::GetIndex() const
+{
+    return m_index;
+}
+
+void
+FleetMobilityModel::SetVelocity(const ns3::Vector& velocity)
+{
+    NS_LOG_FUNCTION(this << velocity);
+    // Advance past ended waypoint segments first, the rebase starts from the current position
+    const double now = m_store->Prepare(m_index);
+    m_store->m_kinematics.setVelocity(m_index, now, velocity.x, velocity.y, velocity.z);
+    NotifyCourseChange();
+}
+
+void
+FleetMobilityModel::AddWaypoint(const ns3::Waypoint& waypoint)
+{
+    NS_LOG_FUNCTION(this << waypoint);
+    const double now = m_store->Prepare(m_index);
+    NS_ASSERT_MSG(waypoint.time.GetSeconds() >= now, "Waypoint lies in the past");
+    m_store->m_kinematics.addWaypoint(m_index, now,
+        mobility::FleetWaypoint{waypoint.time.GetSeconds(),
+                                waypoint.position.x, waypoint.position.y, waypoint.position.z});
+}
+
+uint32_t
+FleetMobilityModel::GetPendingWaypoints() const
+{
+    return static_cast<uint32_t>(m_store->m_kinematics.pendingWaypoints(m_index));
+}
+
+ns3::Vector
+FleetMobilityModel::DoGetPosition() const
+{
+    return m_store->GetPosition(m_index);
+}
+
+void
+FleetMobilityModel::DoSetPosition(const ns3::Vector& position)
+{
+    // Advance past ended waypoint segments first, as SetVelocity does
+    const double now = m_store->Prepare(m_index);
+    m_store->m_kinematics.setPosition(m_index, now, position.x, position.y, position.z);
+    NotifyCourseChange();
+}
+
+ns3::Vector
+FleetMobilityModel::DoGetVelocity() const
+{
+    return m_store->GetVelocity(m_index);
+}
+
+FleetMobilityStore::FleetMobilityStore() :
+    m_batchQueries(16),
+    m_queryTime(-1.0),
+    m_queries(0),
+    m_batchUpdates(0),
+    m_arrayHits(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FleetMobilityStore::~FleetMobilityStore()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ns3::TypeId
+FleetMobilityStore::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::FleetMobilityStore")
+        .SetParent<ns3::Object>()
+        .SetGroupName("VANET")
+        .AddConstructor<FleetMobilityStore>()
+        .AddAttribute("BatchQueries",
+                      "Queries at one simulation time after which the whole fleet is advanced at once",
+                      ns3::UintegerValue(16),
+                      ns3::MakeUintegerAccessor(&FleetMobilityStore::m_batchQueries),
+                      ns3::MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+void
+FleetMobilityStore::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    for (FleetMobilityModel* model : m_models) {
+        if (model) {
+            model->m_store = nullptr;
+        }
+    }
+    m_models.clear();
+    ns3::Object::DoDispose();
+}
+
+ns3::Ptr<FleetMobilityModel>
+FleetMobilityStore::Install(ns3::Ptr<ns3::Node> node, const ns3::Vector& position, const ns3::Vector& velocity)
+{
+    NS_LOG_FUNCTION(this << node << position << velocity);
+    ns3::Ptr<FleetMobilityModel> model = ns3::CreateObject<FleetMobilityModel>();
+    model->m_store = this;
+    model->m_index = m_kinematics.add(ns3::Simulator::Now().GetSeconds(),
+                                      position.x, position.y, position.z,
+                                      velocity.x, velocity.y, velocity.z);
+    m_models.push_back(ns3::PeekPointer(model));
+    node->AggregateObject(model);
+    return model;
+}
+
+uint32_t
+FleetMobilityStore::GetN() const
+{
+    return static_cast<uint32_t>(m_kinematics.size());
+}
+
+const mobility::FleetKinematics&
+FleetMobilityStore::GetKinematics() const
+{
+    return m_kinematics;
+}
+
+uint64_t
+FleetMobilityStore::GetBatchUpdates() const
+{
+    return m_batchUpdates;
+}
+
+uint64_t
+FleetMobilityStore::GetArrayHits() const
+{
+    return m_arrayHits;
+}
+
+void
+FleetMobilityStore::Update()
+{
+    const double now = ns3::Simulator::Now().GetSeconds();
+    if (m_kinematics.isCurrent(now)) {
+        return;
+    }
+    
+    m_kinematics.advance(now);
+    ++m_batchUpdates;
+    for (uint32_t index : m_kinematics.changed()) {
+        NotifyCourseChange(index);
+    }
+}
+
+double
+FleetMobilityStore::Prepare(uint32_t index)
+{
+    const double now = ns3::Simulator::Now().GetSeconds();
+    if (m_kinematics.isCurrent(now)) {
+        ++m_arrayHits;
+        return now;
+    }
+    
+    if (now != m_queryTime) {
+        m_queryTime = now;
+        m_queries = 0;
+    }
+    if (++m_queries >= std::max<std::size_t>(m_batchQueries, m_kinematics.size() / 8)) {
+        // Enough queries at this time to pay for a pass over the whole fleet
+        Update();
+    } else if (m_kinematics.update(index, now)) {
+        NotifyCourseChange(index);
+    }
+    return now;
+}
+
+ns3::Vector
+FleetMobilityStore::GetPosition(uint32_t index)
+{
+    const double now = Prepare(index);
+    if (m_kinematics.isCurrent(now)) {
+        return ns3::Vector(m_kinematics.x()[index], m_kinematics.y()[index], m_kinematics.z()[index]);
+    }
+    
+    ns3::Vector position;
+    m_kinematics.position(index, now, position.x, position.y, position.z);
+    return position;
+}
+
+ns3::Vector
+FleetMobilityStore::GetVelocity(uint32_t index)
+{
+    Prepare(index);
+    return ns3::Vector(m_kinematics.vx()[index], m_kinematics.vy()[index], m_kinematics.vz()[index]);
+}
+
+void
+FleetMobilityStore::NotifyCourseChange(uint32_t index) const
+{
+    if (m_models[index]) {
+        m_models[index]->NotifyCourseChange();
+    }
+}
+
+} // namespace vanetza_ns3
@@ -0,0 +1,198 @@
+#ifndef FLEET_MOBILITY_STORE_HPP
+#define FLEET_MOBILITY_STORE_HPP
+
+#include <cstdint>
+#include <vector>
+#include <ns3/object.h>
+#include <ns3/mobility-model.h>
+#include <ns3/node-container.h>
+#include <ns3/waypoint.h>
+
+#include "fleet_kinematics.hpp"
+
+namespace vanetza_ns3 {
+
+class FleetMobilityStore;
+
+/**
+ * @brief Mobility model facade over one vehicle of a FleetMobilityStore
+ * 
+ * Behaves like ns3::ConstantVelocityMobilityModel, and like
+ * ns3::WaypointMobilityModel once waypoints are added, so existing code
+ * keeps using the MobilityModel interface. The state lives in the store's
+ * arrays; CourseChange fires when a waypoint is reached and noticed by a
+ * query or a store update.
+ */
+class FleetMobilityModel : public ns3::MobilityModel {
+public:
+    /**
+     * @brief Constructor
+     */
+    FleetMobilityModel();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~FleetMobilityModel();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    /**
+     * @brief Move with constant velocity from the current position
+     * 
+     * Drops the remaining waypoints.
+     * @param velocity The velocity in m/s
+     */
+    void SetVelocity(const ns3::Vector& velocity);
+
+    /**
+     * @brief Append a waypoint
+     * @param waypoint The waypoint, not before the current time and the previous waypoint
+     */
+    void AddWaypoint(const ns3::Waypoint& waypoint);
+
+    /**
+     * @brief Get the number of waypoints not yet started towards
+     * @return The number of waypoints
+     */
+    uint32_t GetPendingWaypoints() const;
+
+    /**
+     * @brief Get the vehicle index in the store
+     * @return The vehicle index
+     */
+    uint32_t GetIndex() const;
+
+protected:
+    /**
+     * @brief Detach from the store
+     */
+    virtual void DoDispose() override;
+
+private:
+    friend class FleetMobilityStore;
+
+    // ns3::MobilityModel interface
+    virtual ns3::Vector DoGetPosition() const override;
+    virtual void DoSetPosition(const ns3::Vector& position) override;
+    virtual ns3::Vector DoGetVelocity() const override;
+
+    ns3::Ptr<FleetMobilityStore> m_store;  ///< The store holding the state
+    uint32_t m_index;                      ///< Vehicle index in the store
+};
+
+/**
+ * @brief Positions and velocities of a fleet in contiguous arrays
+ * 
+ * Nodes get a FleetMobilityModel on Install(). The first queries at a new
+ * simulation time evaluate the queried vehicle only; once BatchQueries
+ * queries (or an eighth of the fleet, if more) hit the same time, the
+ * whole fleet is advanced in one vectorised pass and further queries at
+ * that time are array loads. Code that reads many positions at once can
+ * call Update() and read the arrays directly.
+ */
+class FleetMobilityStore : public ns3::Object {
+public:
+    /**
+     * @brief Constructor
+     */
+    FleetMobilityStore();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~FleetMobilityStore();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    /**
+     * @brief Add a vehicle to a node
+     * @param node The node, must not have a mobility model yet
+     * @param position Initial position
+     * @param velocity Initial velocity
+     * @return The installed model
+     */
+    ns3::Ptr<FleetMobilityModel> Install(ns3::Ptr<ns3::Node> node, const ns3::Vector& position,
+                                         const ns3::Vector& velocity = ns3::Vector());
+
+    /**
+     * @brief Get the number of vehicles
+     * @return The number of vehicles
+     */
+    uint32_t GetN() const;
+
+    /**
+     * @brief Advance all vehicles to the current simulation time
+     * 
+     * Fires CourseChange for the vehicles that reached a waypoint.
+     */
+    void Update();
+
+    /**
+     * @brief Get the fleet state, current after Update()
+     * @return The kinematics arrays
+     */
+    const mobility::FleetKinematics& GetKinematics() const;
+
+    /**
+     * @brief Get the number of whole-fleet updates
+     * @return The number of vectorised passes
+     */
+    uint64_t GetBatchUpdates() const;
+
+    /**
+     * @brief Get the number of queries answered from the arrays
+     * @return The number of queries
+     */
+    uint64_t GetArrayHits() const;
+
+protected:
+    /**
+     * @brief Dispose of the store
+     */
+    virtual void DoDispose() override;
+
+private:
+    friend class FleetMobilityModel;
+
+    /**
+     * @brief Get the position of a vehicle at the current time
+     */
+    ns3::Vector GetPosition(uint32_t index);
+
+    /**
+     * @brief Get the velocity of a vehicle at the current time
+     */
+    ns3::Vector GetVelocity(uint32_t index);
+
+    /**
+     * @brief Bring a vehicle to the current time, batching if queries pile up
+     * @return The current time in seconds
+     */
+    double Prepare(uint32_t index);
+
+    /**
+     * @brief Fire CourseChange of a vehicle
+     */
+    void NotifyCourseChange(uint32_t index) const;
+
+    mobility::FleetKinematics m_kinematics;        ///< Fleet state
+    std::vector<FleetMobilityModel*> m_models;     ///< Facade per vehicle, nullptr once disposed
+    uint32_t m_batchQueries;                       ///< Queries at one time that trigger a batch
+    double m_queryTime;                            ///< Time of the counted queries
+    uint32_t m_queries;                            ///< Queries at m_queryTime
+    uint64_t m_batchUpdates;                       ///< Whole-fleet updates
+    uint64_t m_arrayHits;                          ///< Queries answered from the arrays
+};
+
+} // namespace vanetza_ns3
+
+#endif // FLEET_MOBILITY_STORE_HPP
@@ -0,0 +1,141 @@
+#include "mobility_trace.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace vanetza_ns3 {
+namespace mobility {
+
+MobilityTrace::MobilityTrace(const std::string& path) :
+    m_data(nullptr),
+    m_size(0),
+    m_header(nullptr),
+    m_samples(nullptr),
+    m_vehicles(nullptr),
+    m_names(nullptr),
+    m_timeIndex(nullptr),
+    m_released(0)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        m_error = "cannot open " + path;
+        return;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(MobilityTraceHeader)) {
+        m_error = path + " is not a mobility trace";
+        ::close(fd);
+        return;
+    }
+    
+    m_size = static_cast<std::size_t>(info.st_size);
+    void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        m_error = "cannot map " + path;
+        return;
+    }
+    
+    // Validate the header and that every table lies within the file
+    const MobilityTraceHeader* header = static_cast<const MobilityTraceHeader*>(data);
+    const uint64_t samplesEnd = sizeof(MobilityTraceHeader) + header->sampleCount * sizeof(TraceSample);
+    const bool valid =
+        std::memcmp(header->magic, kMobilityTraceMagic, sizeof(header->magic)) == 0 &&
+        header->version == kMobilityTraceVersion &&
+        header->vehicleTableOffset == samplesEnd &&
+        header->namesOffset == samplesEnd + header->vehicleCount * sizeof(TraceVehicle) &&
+        header->timeIndexOffset >= header->namesOffset &&
+        header->timeIndexOffset % 8 == 0 &&
+        header->timeIndexOffset + header->timeIndexCount * sizeof(TraceTimeIndex) <= m_size;
+    if (!valid) {
+        m_error = path + " is not a valid mobility trace (version " + std::to_string(kMobilityTraceVersion) + ")";
+        ::munmap(data, m_size);
+        return;
+    }
+    
+    const char* base = static_cast<const char*>(data);
+    m_data = data;
+    m_header = header;
+    m_samples = reinterpret_cast<const TraceSample*>(base + sizeof(MobilityTraceHeader));
+    m_vehicles = reinterpret_cast<const TraceVehicle*>(base + header->vehicleTableOffset);
+    m_names = base + header->namesOffset;
+    m_timeIndex = reinterpret_cast<const TraceTimeIndex*>(base + header->timeIndexOffset);
+}
+
+MobilityTrace::~MobilityTrace()
+{
+    if (m_data) {
+        ::munmap(m_data, m_size);
+    }
+}
+
+std::string
+MobilityTrace::vehicleName(uint32_t vehicle) const
+{
+    const TraceVehicle& entry = m_vehicles[vehicle];
+    return std::string(m_names + entry.nameOffset, entry.nameLength);
+}
+
+uint64_t
+MobilityTrace::firstSampleAt(double time) const
+{
+    const uint64_t count = m_header->sampleCount;
+    if (count == 0 || time <= m_header->startTime) {
+        return 0;
+    }
+    if (time > m_header->endTime) {
+        return count;
+    }
+    
+    // Start at the last index entry not after time, then scan forward
+    const TraceTimeIndex* begin = m_timeIndex;
+    const TraceTimeIndex* end = m_timeIndex + m_header->timeIndexCount;
+    const TraceTimeIndex* entry = std::upper_bound(begin, end, time,
+        [](double t, const TraceTimeIndex& e) { return t < e.time; });
+    uint64_t index = entry == begin ? 0 : (entry - 1)->firstSample;
+    while (index < count && m_samples[index].time < time) {
+        ++index;
+    }
+    return index;
+}
+
+void
+MobilityTrace::advise(uint64_t first, uint64_t last, int advice) const
+{
+    if (first >= last) {
+        return;
+    }
+    const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t begin = (sizeof(MobilityTraceHeader) + first * sizeof(TraceSample)) / page * page;
+    const std::size_t end = sizeof(MobilityTraceHeader) + last * sizeof(TraceSample);
+    if (end > begin) {
+        ::madvise(static_cast<char*>(m_data) + begin, end - begin, advice);
+    }
+}
+
+void
+MobilityTrace::prefetch(double from, double to) const
+{
+    advise(firstSampleAt(from), firstSampleAt(to), MADV_WILLNEED);
+}
+
+void
+MobilityTrace::release(double before)
+{
+    // Only whole pages before the first needed sample may be dropped
+    const uint64_t first = firstSampleAt(before);
+    const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t end = (sizeof(MobilityTraceHeader) + first * sizeof(TraceSample)) / page * page;
+    const std::size_t begin = (sizeof(MobilityTraceHeader) + m_released * sizeof(TraceSample)) / page * page;
+    if (end > begin) {
+        ::madvise(static_cast<char*>(m_data) + begin, end - begin, MADV_DONTNEED);
+    }
+    m_released = std::max(m_released, first);
+}
+
+} // namespace mobility
+} // namespace vanetza_ns3
@@ -0,0 +1,143 @@
+#ifndef MOBILITY_TRACE_HPP
+#define MOBILITY_TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "mobility_trace_format.hpp"
+
+namespace vanetza_ns3 {
+namespace mobility {
+
+/**
+ * @brief Memory-mapped binary mobility trace
+ * 
+ * Opening a trace maps the file and checks its header. Nothing is parsed
+ * or copied: samples, vehicle table and time index are read in place, and
+ * the kernel pages the file in as they are touched. prefetch() and
+ * release() keep the resident part of the trace to a time window, so
+ * memory stays flat however long the trace is.
+ */
+class MobilityTrace {
+public:
+    /**
+     * @brief Map a trace file
+     * @param path The trace file, written by MobilityTraceWriter
+     */
+    explicit MobilityTrace(const std::string& path);
+
+    /**
+     * @brief Destructor, unmaps the file
+     */
+    ~MobilityTrace();
+
+    MobilityTrace(const MobilityTrace&) = delete;
+    MobilityTrace& operator=(const MobilityTrace&) = delete;
+
+    /**
+     * @brief Check whether the file is a valid trace
+     * @return True if the trace can be read
+     */
+    bool isOpen() const { return m_data != nullptr; }
+
+    /**
+     * @brief Get the reason the trace could not be opened
+     * @return The error message, empty if open
+     */
+    const std::string& error() const { return m_error; }
+
+    /**
+     * @brief Get the number of vehicles
+     * @return The number of vehicles
+     */
+    uint32_t vehicleCount() const { return m_header->vehicleCount; }
+
+    /**
+     * @brief Get the number of samples
+     * @return The number of samples
+     */
+    uint64_t sampleCount() const { return m_header->sampleCount; }
+
+    /**
+     * @brief Get the time of the first sample
+     * @return The time in seconds
+     */
+    double startTime() const { return m_header->startTime; }
+
+    /**
+     * @brief Get the time of the last sample
+     * @return The time in seconds
+     */
+    double endTime() const { return m_header->endTime; }
+
+    /**
+     * @brief Get the table entry of a vehicle
+     * @param vehicle The vehicle index
+     * @return The entry
+     */
+    const TraceVehicle& vehicle(uint32_t vehicle) const { return m_vehicles[vehicle]; }
+
+    /**
+     * @brief Get the ID of a vehicle
+     * @param vehicle The vehicle index
+     * @return The vehicle ID from the source trace
+     */
+    std::string vehicleName(uint32_t vehicle) const;
+
+    /**
+     * @brief Get a sample
+     * @param index The sample index
+     * @return The sample
+     */
+    const TraceSample& sample(uint64_t index) const { return m_samples[index]; }
+
+    /**
+     * @brief Find the first sample at or after a time
+     * @param time The time in seconds
+     * @return The sample index, sampleCount() if there is none
+     */
+    uint64_t firstSampleAt(double time) const;
+
+    /**
+     * @brief Ask the kernel to read the samples of a time window ahead
+     * @param from Begin of the window in seconds
+     * @param to End of the window in seconds
+     */
+    void prefetch(double from, double to) const;
+
+    /**
+     * @brief Drop the samples before a time from memory
+     * 
+     * The pages are read again from the file should they be accessed later.
+     * @param before Samples before this time are released
+     */
+    void release(double before);
+
+    /**
+     * @brief Get the size of the mapped file
+     * @return The size in bytes
+     */
+    std::size_t mappedBytes() const { return m_size; }
+
+private:
+    /**
+     * @brief Apply madvise to the pages covering a range of samples
+     */
+    void advise(uint64_t first, uint64_t last, int advice) const;
+
+    std::string m_error;                    ///< Reason opening failed
+    void* m_data;                           ///< Mapped file
+    std::size_t m_size;                     ///< Size of the mapping
+    const MobilityTraceHeader* m_header;    ///< Header in the mapping
+    const TraceSample* m_samples;           ///< Samples in the mapping
+    const TraceVehicle* m_vehicles;         ///< Vehicle table in the mapping
+    const char* m_names;                    ///< Vehicle names in the mapping
+    const TraceTimeIndex* m_timeIndex;      ///< Time index in the mapping
+    uint64_t m_released;                    ///< Samples before this index were released
+};
+
+} // namespace mobility
+} // namespace vanetza_ns3
+
+#endif // MOBILITY_TRACE_HPP
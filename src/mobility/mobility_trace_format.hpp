@@ -0,0 +1,83 @@
+/**
+ * @file mobility_trace_format.hpp
+ * @brief On-disk layout of binary mobility traces
+ */
+
+#ifndef MOBILITY_TRACE_FORMAT_HPP
+#define MOBILITY_TRACE_FORMAT_HPP
+
+#include <cstdint>
+
+namespace vanetza_ns3 {
+namespace mobility {
+
+/**
+ * Binary mobility trace (host byte order):
+ * 
+ * - MobilityTraceHeader
+ * - samples: TraceSample[sampleCount], ordered by time. Each sample links
+ *   to the next sample of the same vehicle, so a vehicle's waypoints are
+ *   found without an index while all vehicles active in a time window
+ *   share one contiguous file region.
+ * - vehicle table: TraceVehicle[vehicleCount], then the vehicle names
+ * - time index: TraceTimeIndex[timeIndexCount], the first sample at or
+ *   after every TimeIndexStep seconds
+ */
+struct MobilityTraceHeader {
+    char magic[8];                ///< "VNMOBTR1"
+    uint32_t version;             ///< Format version
+    uint32_t vehicleCount;        ///< Number of vehicles
+    uint64_t sampleCount;         ///< Number of samples
+    double startTime;             ///< Time of the first sample in seconds
+    double endTime;               ///< Time of the last sample in seconds
+    uint64_t vehicleTableOffset;  ///< File offset of the vehicle table
+    uint64_t namesOffset;         ///< File offset of the vehicle names
+    uint64_t timeIndexOffset;     ///< File offset of the time index
+    uint32_t timeIndexCount;      ///< Entries of the time index
+    uint32_t reserved;            ///< Zero
+};
+
+/**
+ * @brief One waypoint of one vehicle
+ */
+struct TraceSample {
+    double time;                  ///< Time in seconds
+    float x;                      ///< X coordinate in meters
+    float y;                      ///< Y coordinate in meters
+    float speed;                  ///< Speed in m/s
+    float angle;                  ///< Heading in degrees, clockwise from north (SUMO convention)
+    uint32_t vehicle;             ///< Vehicle index
+    uint32_t next;                ///< Samples to the vehicle's next sample, 0 for its last one
+};
+
+/**
+ * @brief Vehicle table entry
+ */
+struct TraceVehicle {
+    uint64_t firstSample;         ///< Index of the vehicle's first sample
+    uint64_t sampleCount;         ///< Number of samples of the vehicle
+    double firstTime;             ///< Time of the first sample
+    double lastTime;              ///< Time of the last sample
+    uint32_t nameOffset;          ///< Offset of the name in the name block
+    uint32_t nameLength;          ///< Length of the name
+};
+
+/**
+ * @brief Time index entry
+ */
+struct TraceTimeIndex {
+    double time;                  ///< Time in seconds
+    uint64_t firstSample;         ///< Index of the first sample at or after time
+};
+
+static const char kMobilityTraceMagic[8] = { 'V', 'N', 'M', 'O', 'B', 'T', 'R', '1' };
+static const uint32_t kMobilityTraceVersion = 1;
+static const double kTimeIndexStep = 1.0;  ///< Seconds between time index entries
+
+static_assert(sizeof(TraceSample) == 32, "TraceSample must be 32 bytes");
+static_assert(sizeof(MobilityTraceHeader) == 72, "MobilityTraceHeader must be 72 bytes");
+
+} // namespace mobility
+} // namespace vanetza_ns3
+
+#endif // MOBILITY_TRACE_FORMAT_HPP
@@ -0,0 +1,129 @@
+#include "mobility_trace_loader.hpp"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+
+#include <algorithm>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("MobilityTraceLoader");
+
+NS_OBJECT_ENSURE_REGISTERED(MobilityTraceLoader);
+
+MobilityTraceLoader::MobilityTraceLoader() :
+    m_window(ns3::Seconds(10)),
+    m_timeOffset(ns3::Seconds(0))
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MobilityTraceLoader::~MobilityTraceLoader()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ns3::TypeId
+MobilityTraceLoader::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::MobilityTraceLoader")
+        .SetParent<ns3::Object>()
+        .SetGroupName("VANET")
+        .AddConstructor<MobilityTraceLoader>()
+        .AddAttribute("TraceFile",
+                      "Binary mobility trace written by fcd_to_mobility_trace",
+                      ns3::StringValue(""),
+                      ns3::MakeStringAccessor(&MobilityTraceLoader::m_traceFile),
+                      ns3::MakeStringChecker())
+        .AddAttribute("PrefetchWindow",
+                      "Span of trace time read ahead of the simulation",
+                      ns3::TimeValue(ns3::Seconds(10)),
+                      ns3::MakeTimeAccessor(&MobilityTraceLoader::m_window),
+                      ns3::MakeTimeChecker(ns3::MilliSeconds(100)))
+        .AddAttribute("TimeOffset",
+                      "Trace time at simulation time zero",
+                      ns3::TimeValue(ns3::Seconds(0)),
+                      ns3::MakeTimeAccessor(&MobilityTraceLoader::m_timeOffset),
+                      ns3::MakeTimeChecker());
+    return tid;
+}
+
+void
+MobilityTraceLoader::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    ns3::Simulator::Cancel(m_prefetchEvent);
+    ns3::Object::DoDispose();
+}
+
+bool
+MobilityTraceLoader::Open()
+{
+    NS_LOG_FUNCTION(this << m_traceFile);
+    m_trace = std::make_shared<mobility::MobilityTrace>(m_traceFile);
+    if (!m_trace->isOpen()) {
+        NS_LOG_ERROR("Cannot load mobility trace: " << m_trace->error());
+        m_trace.reset();
+        return false;
+    }
+    NS_LOG_INFO("Mapped " << m_trace->vehicleCount() << " vehicles, " << m_trace->sampleCount()
+                << " samples (" << m_trace->mappedBytes() << " bytes) from " << m_traceFile);
+    return true;
+}
+
+std::shared_ptr<const mobility::MobilityTrace>
+MobilityTraceLoader::GetTrace() const
+{
+    return m_trace;
+}
+
+uint32_t
+MobilityTraceLoader::GetNVehicles() const
+{
+    return m_trace ? m_trace->vehicleCount() : 0;
+}
+
+ns3::Ptr<TraceMobilityModel>
+MobilityTraceLoader::Install(ns3::Ptr<ns3::Node> node, uint32_t vehicle)
+{
+    NS_LOG_FUNCTION(this << node << vehicle);
+    NS_ASSERT_MSG(m_trace, "MobilityTraceLoader::Open() must succeed before Install()");
+    
+    ns3::Ptr<TraceMobilityModel> model = ns3::CreateObject<TraceMobilityModel>();
+    model->SetTrace(m_trace, vehicle, m_timeOffset.GetSeconds());
+    node->AggregateObject(model);
+    
+    if (!m_prefetchEvent.IsRunning()) {
+        m_prefetchEvent = ns3::Simulator::ScheduleNow(&MobilityTraceLoader::Prefetch, this);
+    }
+    return model;
+}
+
+uint32_t
+MobilityTraceLoader::Install(const ns3::NodeContainer& nodes)
+{
+    const uint32_t count = std::min(nodes.GetN(), GetNVehicles());
+    for (uint32_t i = 0; i < count; ++i) {
+        Install(nodes.Get(i), i);
+    }
+    return count;
+}
+
+void
+MobilityTraceLoader::Prefetch()
+{
+    NS_LOG_FUNCTION(this);
+    const double now = ns3::Simulator::Now().GetSeconds() + m_timeOffset.GetSeconds();
+    const double window = m_window.GetSeconds();
+    
+    // Read the next window ahead and drop what lies more than half a window behind
+    m_trace->prefetch(now, now + window);
+    m_trace->release(now - 0.5 * window);
+    
+    if (now < m_trace->endTime()) {
+        m_prefetchEvent = ns3::Simulator::Schedule(m_window / 2, &MobilityTraceLoader::Prefetch, this);
+    }
+}
+
+} // namespace vanetza_ns3
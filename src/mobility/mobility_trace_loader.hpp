@@ -0,0 +1,98 @@
+#ifndef MOBILITY_TRACE_LOADER_HPP
+#define MOBILITY_TRACE_LOADER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/event-id.h>
+#include <ns3/node-container.h>
+
+#include "mobility_trace.hpp"
+#include "trace_mobility_model.hpp"
+
+namespace vanetza_ns3 {
+
+/**
+ * @brief Replays a binary mobility trace on a set of nodes
+ * 
+ * Maps the TraceFile (see fcd_to_mobility_trace) without parsing it and
+ * installs a TraceMobilityModel per vehicle. While the simulation runs,
+ * the loader asks the kernel to read the next PrefetchWindow of samples
+ * ahead and drops the samples that lie behind, so the resident part of
+ * the trace stays about two windows long.
+ */
+class MobilityTraceLoader : public ns3::Object {
+public:
+    /**
+     * @brief Constructor
+     */
+    MobilityTraceLoader();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~MobilityTraceLoader();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    /**
+     * @brief Map the TraceFile
+     * @return False if the file is missing or not a valid trace
+     */
+    bool Open();
+
+    /**
+     * @brief Get the mapped trace
+     * @return The trace, nullptr before Open()
+     */
+    std::shared_ptr<const mobility::MobilityTrace> GetTrace() const;
+
+    /**
+     * @brief Get the number of vehicles in the trace
+     * @return The number of vehicles
+     */
+    uint32_t GetNVehicles() const;
+
+    /**
+     * @brief Replay one vehicle on a node
+     * @param node The node, must not have a mobility model yet
+     * @param vehicle The vehicle index in the trace
+     * @return The installed model
+     */
+    ns3::Ptr<TraceMobilityModel> Install(ns3::Ptr<ns3::Node> node, uint32_t vehicle);
+
+    /**
+     * @brief Replay the first vehicles of the trace on a set of nodes
+     * @param nodes The nodes, node i gets vehicle i
+     * @return The number of nodes that got a vehicle
+     */
+    uint32_t Install(const ns3::NodeContainer& nodes);
+
+protected:
+    /**
+     * @brief Dispose of the loader
+     */
+    virtual void DoDispose() override;
+
+private:
+    /**
+     * @brief Prefetch the next window, release the past and reschedule
+     */
+    void Prefetch();
+
+    std::string m_traceFile;                               ///< Trace file
+    ns3::Time m_window;                                    ///< Prefetch window
+    ns3::Time m_timeOffset;                                ///< Trace time at simulation time zero
+    std::shared_ptr<mobility::MobilityTrace> m_trace;      ///< Mapped trace
+    ns3::EventId m_prefetchEvent;                          ///< Next prefetch
+};
+
+} // namespace vanetza_ns3
+
+#endif // MOBILITY_TRACE_LOADER_HPP
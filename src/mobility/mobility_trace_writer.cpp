@@ -0,0 +1,165 @@
+#include "mobility_trace_writer.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace vanetza_ns3 {
+namespace mobility {
+
+MobilityTraceWriter::MobilityTraceWriter(const std::string& path, std::size_t bufferSamples) :
+    m_fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)),
+    m_ok(m_fd >= 0),
+    m_bufferSamples(bufferSamples > 0 ? bufferSamples : 1),
+    m_bufferStart(0),
+    m_samples(0),
+    m_startTime(0.0),
+    m_lastTime(0.0)
+{
+    m_buffer.reserve(m_bufferSamples);
+}
+
+MobilityTraceWriter::~MobilityTraceWriter()
+{
+    if (m_fd >= 0) {
+        finish();
+    }
+}
+
+uint32_t
+MobilityTraceWriter::vehicle(const std::string& name)
+{
+    auto it = m_ids.find(name);
+    if (it != m_ids.end()) {
+        return it->second;
+    }
+    
+    const uint32_t index = static_cast<uint32_t>(m_vehicles.size());
+    TraceVehicle entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.nameOffset = static_cast<uint32_t>(m_names.size());
+    entry.nameLength = static_cast<uint32_t>(name.size());
+    m_names += name;
+    m_vehicles.push_back(entry);
+    m_lastSample.push_back(0);
+    m_ids.emplace(name, index);
+    return index;
+}
+
+bool
+MobilityTraceWriter::add(uint32_t vehicle, double time, float x, float y, float speed, float angle)
+{
+    if (!m_ok || vehicle >= m_vehicles.size() || (m_samples > 0 && time < m_lastTime)) {
+        return false;
+    }
+    
+    const uint64_t index = m_samples;
+    if (index == 0) {
+        m_startTime = time;
+    }
+    
+    // First sample at or after every index step
+    while (m_timeIndex.empty() || time >= m_timeIndex.back().time + kTimeIndexStep) {
+        const double step = m_timeIndex.empty() ?
+            std::floor(time / kTimeIndexStep) * kTimeIndexStep : m_timeIndex.back().time + kTimeIndexStep;
+        m_timeIndex.push_back(TraceTimeIndex { step, index });
+    }
+    
+    // Link the vehicle's previous sample to this one
+    TraceVehicle& entry = m_vehicles[vehicle];
+    if (entry.sampleCount == 0) {
+        entry.firstSample = index;
+        entry.firstTime = time;
+    } else {
+        const uint64_t previous = m_lastSample[vehicle];
+        const uint32_t next = static_cast<uint32_t>(index - previous);
+        if (previous >= m_bufferStart) {
+            m_buffer[previous - m_bufferStart].next = next;
+        } else if (!writeAt(&next, sizeof(next),
+                            sizeof(MobilityTraceHeader) + previous * sizeof(TraceSample) + offsetof(TraceSample, next))) {
+            return false;
+        }
+    }
+    ++entry.sampleCount;
+    entry.lastTime = time;
+    m_lastSample[vehicle] = index;
+    
+    m_buffer.push_back(TraceSample { time, x, y, speed, angle, vehicle, 0 });
+    ++m_samples;
+    m_lastTime = time;
+    
+    if (m_buffer.size() == m_bufferSamples) {
+        return flush();
+    }
+    return true;
+}
+
+bool
+MobilityTraceWriter::flush()
+{
+    if (m_buffer.empty()) {
+        return m_ok;
+    }
+    writeAt(m_buffer.data(), m_buffer.size() * sizeof(TraceSample),
+            sizeof(MobilityTraceHeader) + m_bufferStart * sizeof(TraceSample));
+    m_bufferStart += m_buffer.size();
+    m_buffer.clear();
+    return m_ok;
+}
+
+bool
+MobilityTraceWriter::writeAt(const void* data, std::size_t size, uint64_t offset)
+{
+    const char* bytes = static_cast<const char*>(data);
+    while (m_ok && size > 0) {
+        const ssize_t n = ::pwrite(m_fd, bytes, size, static_cast<off_t>(offset));
+        if (n <= 0) {
+            m_ok = false;
+            break;
+        }
+        bytes += n;
+        size -= static_cast<std::size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return m_ok;
+}
+
+bool
+MobilityTraceWriter::finish()
+{
+    if (m_fd < 0) {
+        return false;
+    }
+    flush();
+    
+    MobilityTraceHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMobilityTraceMagic, sizeof(header.magic));
+    header.version = kMobilityTraceVersion;
+    header.vehicleCount = static_cast<uint32_t>(m_vehicles.size());
+    header.sampleCount = m_samples;
+    header.startTime = m_startTime;
+    header.endTime = m_lastTime;
+    header.vehicleTableOffset = sizeof(MobilityTraceHeader) + m_samples * sizeof(TraceSample);
+    header.namesOffset = header.vehicleTableOffset + m_vehicles.size() * sizeof(TraceVehicle);
+    // Keep the time index 8-byte aligned for the memory-mapped reader
+    header.timeIndexOffset = (header.namesOffset + m_names.size() + 7) & ~uint64_t(7);
+    header.timeIndexCount = static_cast<uint32_t>(m_timeIndex.size());
+    
+    const uint64_t padding = 0;
+    writeAt(m_vehicles.data(), m_vehicles.size() * sizeof(TraceVehicle), header.vehicleTableOffset);
+    writeAt(m_names.data(), m_names.size(), header.namesOffset);
+    writeAt(&padding, header.timeIndexOffset - header.namesOffset - m_names.size(), header.namesOffset + m_names.size());
+    writeAt(m_timeIndex.data(), m_timeIndex.size() * sizeof(TraceTimeIndex), header.timeIndexOffset);
+    writeAt(&header, sizeof(header), 0);
+    
+    const bool ok = m_ok && ::close(m_fd) == 0;
+    m_fd = -1;
+    m_ok = false;
+    return ok;
+}
+
+} // namespace mobility
+} // namespace vanetza_ns3
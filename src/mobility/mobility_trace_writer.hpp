@@ -0,0 +1,113 @@
+#ifndef MOBILITY_TRACE_WRITER_HPP
+#define MOBILITY_TRACE_WRITER_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mobility_trace_format.hpp"
+
+namespace vanetza_ns3 {
+namespace mobility {
+
+/**
+ * @brief Streaming writer of binary mobility traces
+ * 
+ * Samples are added in time order and written through a fixed-size buffer.
+ * The link from a vehicle's previous sample to the new one is patched in
+ * the buffer or, for older samples, directly in the file, so memory grows
+ * with the number of vehicles but not with the number of samples.
+ */
+class MobilityTraceWriter {
+public:
+    /**
+     * @brief Create the trace file
+     * @param path The trace file
+     * @param bufferSamples Samples buffered before they are written
+     */
+    explicit MobilityTraceWriter(const std::string& path, std::size_t bufferSamples = 1 << 16);
+
+    /**
+     * @brief Destructor, finishes the trace if that was not done
+     */
+    ~MobilityTraceWriter();
+
+    MobilityTraceWriter(const MobilityTraceWriter&) = delete;
+    MobilityTraceWriter& operator=(const MobilityTraceWriter&) = delete;
+
+    /**
+     * @brief Check whether the file could be created
+     * @return True if samples can be added
+     */
+    bool isOpen() const { return m_fd >= 0; }
+
+    /**
+     * @brief Get the index of a vehicle, registering it on first use
+     * @param name The vehicle ID
+     * @return The vehicle index
+     */
+    uint32_t vehicle(const std::string& name);
+
+    /**
+     * @brief Append a sample
+     * @param vehicle Index from vehicle()
+     * @param time Time in seconds, not before the previous sample
+     * @param x X coordinate in meters
+     * @param y Y coordinate in meters
+     * @param speed Speed in m/s
+     * @param angle Heading in degrees, clockwise from north
+     * @return False if the time went backwards or writing failed
+     */
+    bool add(uint32_t vehicle, double time, float x, float y, float speed, float angle);
+
+    /**
+     * @brief Write the tables and the header and close the file
+     * @return True if the trace is complete
+     */
+    bool finish();
+
+    /**
+     * @brief Get the number of samples added
+     * @return The number of samples
+     */
+    uint64_t samples() const { return m_samples; }
+
+    /**
+     * @brief Get the number of vehicles
+     * @return The number of vehicles
+     */
+    uint32_t vehicles() const { return static_cast<uint32_t>(m_vehicles.size()); }
+
+private:
+    /**
+     * @brief Write the buffered samples to the file
+     * @return True on success
+     */
+    bool flush();
+
+    /**
+     * @brief Write bytes at a file offset
+     * @return True on success
+     */
+    bool writeAt(const void* data, std::size_t size, uint64_t offset);
+
+    int m_fd;                                          ///< Trace file
+    bool m_ok;                                         ///< No write failed
+    std::vector<TraceSample> m_buffer;                 ///< Samples not yet written
+    std::size_t m_bufferSamples;                       ///< Capacity of the buffer
+    uint64_t m_bufferStart;                            ///< Index of the first buffered sample
+    uint64_t m_samples;                                ///< Samples added
+    double m_startTime;                                ///< Time of the first sample
+    double m_lastTime;                                 ///< Time of the last sample
+    std::vector<TraceVehicle> m_vehicles;              ///< Vehicle table
+    std::vector<uint64_t> m_lastSample;                ///< Last sample per vehicle
+    std::string m_names;                               ///< Name block
+    std::unordered_map<std::string, uint32_t> m_ids;   ///< Vehicle index per name
+    std::vector<TraceTimeIndex> m_timeIndex;           ///< Time index
+};
+
+} // namespace mobility
+} // namespace vanetza_ns3
+
+#endif // MOBILITY_TRACE_WRITER_HPP
@@ -0,0 +1,143 @@
+#include "trace_mobility_model.hpp"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+
+#include <algorithm>
+
+namespace vanetza_ns3 {
+
+NS_LOG_COMPONENT_DEFINE("TraceMobilityModel");
+
+NS_OBJECT_ENSURE_REGISTERED(TraceMobilityModel);
+
+TraceMobilityModel::TraceMobilityModel() :
+    m_vehicle(0),
+    m_timeOffset(0.0),
+    m_current(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TraceMobilityModel::~TraceMobilityModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ns3::TypeId
+TraceMobilityModel::GetTypeId()
+{
+    static ns3::TypeId tid = ns3::TypeId("vanetza_ns3::TraceMobilityModel")
+        .SetParent<ns3::MobilityModel>()
+        .SetGroupName("VANET")
+        .AddConstructor<TraceMobilityModel>();
+    return tid;
+}
+
+void
+TraceMobilityModel::SetTrace(std::shared_ptr<const mobility::MobilityTrace> trace, uint32_t vehicle,
+                             double timeOffset)
+{
+    NS_LOG_FUNCTION(this << vehicle << timeOffset);
+    NS_ASSERT(trace && vehicle < trace->vehicleCount());
+    m_trace = trace;
+    m_vehicle = vehicle;
+    m_timeOffset = timeOffset;
+    m_current = trace->vehicle(vehicle).firstSample;
+    NotifyCourseChange();
+}
+
+uint32_t
+TraceMobilityModel::GetVehicle() const
+{
+    return m_vehicle;
+}
+
+double
+TraceMobilityModel::Update() const
+{
+    const double now = ns3::Simulator::Now().GetSeconds() + m_timeOffset;
+    bool moved = false;
+    const mobility::TraceSample* sample = &m_trace->sample(m_current);
+    while (sample->next != 0) {
+        const mobility::TraceSample* next = &m_trace->sample(m_current + sample->next);
+        if (next->time > now) {
+            break;
+        }
+        m_current += sample->next;
+        sample = next;
+        moved = true;
+    }
+    if (moved) {
+        // The cursor is already updated, so listeners querying us do not recurse
+        NotifyCourseChange();
+    }
+    return now;
+}
+
+bool
+TraceMobilityModel::IsActive() const
+{
+    if (!m_trace) {
+        return false;
+    }
+    const mobility::TraceVehicle& vehicle = m_trace->vehicle(m_vehicle);
+    const double now = ns3::Simulator::Now().GetSeconds() + m_timeOffset;
+    return now >= vehicle.firstTime && now <= vehicle.lastTime;
+}
+
+ns3::Time
+TraceMobilityModel::GetFirstTime() const
+{
+    NS_ASSERT(m_trace);
+    return ns3::Seconds(m_trace->vehicle(m_vehicle).firstTime - m_timeOffset);
+}
+
+ns3::Time
+TraceMobilityModel::GetLastTime() const
+{
+    NS_ASSERT(m_trace);
+    return ns3::Seconds(m_trace->vehicle(m_vehicle).lastTime - m_timeOffset);
+}
+
+ns3::Vector
+TraceMobilityModel::DoGetPosition() const
+{
+    if (!m_trace) {
+        return ns3::Vector();
+    }
+    const double now = Update();
+    const mobility::TraceSample& sample = m_trace->sample(m_current);
+    if (sample.next == 0 || now <= sample.time) {
+        return ns3::Vector(sample.x, sample.y, 0.0);
+    }
+    
+    const mobility::TraceSample& next = m_trace->sample(m_current + sample.next);
+    const double a = std::min(1.0, (now - sample.time) / (next.time - sample.time));
+    return ns3::Vector(sample.x + a * (next.x - sample.x), sample.y + a * (next.y - sample.y), 0.0);
+}
+
+void
+TraceMobilityModel::DoSetPosition(const ns3::Vector& position)
+{
+    NS_LOG_WARN("Position " << position << " ignored, positions come from the trace");
+}
+
+ns3::Vector
+TraceMobilityModel::DoGetVelocity() const
+{
+    if (!m_trace) {
+        return ns3::Vector();
+    }
+    const double now = Update();
+    const mobility::TraceSample& sample = m_trace->sample(m_current);
+    if (sample.next == 0 || now < sample.time) {
+        return ns3::Vector();
+    }
+    
+    const mobility::TraceSample& next = m_trace->sample(m_current + sample.next);
+    const double dt = next.time - sample.time;
+    return ns3::Vector((next.x - sample.x) / dt, (next.y - sample.y) / dt, 0.0);
+}
+
+} // namespace vanetza_ns3
@@ -0,0 +1,95 @@
+#ifndef TRACE_MOBILITY_MODEL_HPP
+#define TRACE_MOBILITY_MODEL_HPP
+
+#include <cstdint>
+#include <memory>
+#include <ns3/mobility-model.h>
+#include <ns3/nstime.h>
+
+#include "mobility_trace.hpp"
+
+namespace vanetza_ns3 {
+
+/**
+ * @brief Mobility model replaying one vehicle of a memory-mapped trace
+ * 
+ * The model keeps a cursor into the trace and follows the vehicle's
+ * sample links as simulation time advances, so it only ever touches the
+ * samples around the current time. Positions are interpolated linearly
+ * between waypoints. Before its first and after its last sample the
+ * vehicle stands still at that sample's position.
+ * 
+ * No events are scheduled per waypoint: the cursor moves when the model
+ * is queried, and CourseChange fires when a query passes a waypoint.
+ */
+class TraceMobilityModel : public ns3::MobilityModel {
+public:
+    /**
+     * @brief Constructor
+     */
+    TraceMobilityModel();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~TraceMobilityModel();
+
+    /**
+     * @brief Get the TypeId for this class
+     * @return The TypeId
+     */
+    static ns3::TypeId GetTypeId();
+
+    /**
+     * @brief Attach the model to a vehicle of a trace
+     * @param trace The trace
+     * @param vehicle The vehicle index
+     * @param timeOffset Trace time at simulation time zero, in seconds
+     */
+    void SetTrace(std::shared_ptr<const mobility::MobilityTrace> trace, uint32_t vehicle, double timeOffset);
+
+    /**
+     * @brief Get the vehicle index in the trace
+     * @return The vehicle index
+     */
+    uint32_t GetVehicle() const;
+
+    /**
+     * @brief Check whether the vehicle is on the road at the current time
+     * @return True between the vehicle's first and last sample
+     */
+    bool IsActive() const;
+
+    /**
+     * @brief Get the time the vehicle enters the road
+     * @return Simulation time of the vehicle's first sample, negative if it lies before zero
+     */
+    ns3::Time GetFirstTime() const;
+
+    /**
+     * @brief Get the time the vehicle leaves the road
+     * @return Simulation time of the vehicle's last sample
+     */
+    ns3::Time GetLastTime() const;
+
+private:
+    // ns3::MobilityModel interface
+    virtual ns3::Vector DoGetPosition() const override;
+    virtual void DoSetPosition(const ns3::Vector& position) override;
+    virtual ns3::Vector DoGetVelocity() const override;
+
+    /**
+     * @brief Move the cursor to the last sample not after the current time
+     * @return The trace time
+     */
+    double Update() const;
+
+    std::shared_ptr<const mobility::MobilityTrace> m_trace;  ///< The trace
+    uint32_t m_vehicle;                                      ///< Vehicle index
+    double m_timeOffset;                                     ///< Trace time at simulation time zero
+    mutable uint64_t m_current;                              ///< Last sample not after the current time
+};
+
+} // namespace vanetza_ns3
+
+#endif // TRACE_MOBILITY_MODEL_HPP
@@ -0,0 +1,92 @@
+#include "trace_reader.hpp"
+#include "trace_writer.hpp"
+
+#include <cstring>
+
+namespace vanetza_ns3 {
+namespace trace {
+
+namespace {
+
+template<typename T>
+bool
+ReadColumn(std::FILE* file, std::vector<T>& column, uint32_t count)
+{
+    column.resize(count);
+    return std::fread(column.data(), sizeof(T), count, file) == count;
+}
+
+} // namespace
+
+TraceReader::TraceReader(const std::string& path) :
+    m_file(std::fopen(path.c_str(), "rb")),
+    m_blockRecords(0),
+    m_position(0)
+{
+    if (!m_file) {
+        return;
+    }
+    
+    char magic[8];
+    uint32_t header[2];
+    if (std::fread(magic, 1, 8, m_file) != 8 || std::memcmp(magic, "VNTRACE1", 8) != 0 ||
+        std::fread(header, sizeof(uint32_t), 2, m_file) != 2 || header[0] != TraceWriter::kVersion) {
+        std::fclose(m_file);
+        m_file = nullptr;
+        return;
+    }
+    m_blockRecords = header[1];
+}
+
+TraceReader::~TraceReader()
+{
+    if (m_file) {
+        std::fclose(m_file);
+    }
+}
+
+bool
+TraceReader::next(TraceRecord& record)
+{
+    if (m_position == m_time.size() && !readBlock()) {
+        return false;
+    }
+    
+    record.timeNs = m_time[m_position];
+    record.event = static_cast<TraceEvent>(m_event[m_position]);
+    record.station = m_station[m_position];
+    record.peer = m_peer[m_position];
+    record.x = m_x[m_position];
+    record.y = m_y[m_position];
+    record.speed = m_speed[m_position];
+    record.heading = m_heading[m_position];
+    ++m_position;
+    return true;
+}
+
+bool
+TraceReader::readBlock()
+{
+    uint32_t count = 0;
+    if (!m_file || std::fread(&count, sizeof(count), 1, m_file) != 1 || count == 0 || count > m_blockRecords) {
+        return false;
+    }
+    
+    m_position = 0;
+    const bool complete = ReadColumn(m_file, m_time, count) &&
+                          ReadColumn(m_file, m_event, count) &&
+                          ReadColumn(m_file, m_station, count) &&
+                          ReadColumn(m_file, m_peer, count) &&
+                          ReadColumn(m_file, m_x, count) &&
+                          ReadColumn(m_file, m_y, count) &&
+                          ReadColumn(m_file, m_speed, count) &&
+                          ReadColumn(m_file, m_heading, count);
+    if (!complete) {
+        m_time.clear();
+        return false;
+    }
+    return true;
+}
+
+} // namespace trace
+} // namespace vanetza_ns3
@@ -0,0 +1,71 @@
+#ifndef TRACE_READER_HPP
+#define TRACE_READER_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "trace_record.hpp"
+
+namespace vanetza_ns3 {
+namespace trace {
+
+/**
+ * @brief Sequential reader of trace files written by TraceWriter
+ */
+class TraceReader {
+public:
+    /**
+     * @brief Open a trace file and check its header
+     * @param path The trace file
+     */
+    explicit TraceReader(const std::string& path);
+
+    /**
+     * @brief Destructor
+     */
+    ~TraceReader();
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    /**
+     * @brief Check whether the file is a readable trace
+     * @return True if the header was valid
+     */
+    bool isOpen() const { return m_file != nullptr; }
+
+    /**
+     * @brief Read the next record
+     * @param record Receives the record
+     * @return False at the end of the file or on a truncated block
+     */
+    bool next(TraceRecord& record);
+
+private:
+    /**
+     * @brief Read the next column block
+     * @return False at the end of the file or on a truncated block
+     */
+    bool readBlock();
+
+    std::FILE* m_file;              ///< Trace file
+    uint32_t m_blockRecords;        ///< Records per block from the header
+    std::size_t m_position;         ///< Next record in the current block
+
+    // Current block, one vector per column
+    std::vector<int64_t> m_time;
+    std::vector<uint8_t> m_event;
+    std::vector<uint32_t> m_station;
+    std::vector<uint32_t> m_peer;
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_speed;
+    std::vector<float> m_heading;
+};
+
+} // namespace trace
+} // namespace vanetza_ns3
+
+#endif // TRACE_READER_HPP
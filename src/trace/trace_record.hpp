@@ -0,0 +1,57 @@
+#ifndef TRACE_RECORD_HPP
+#define TRACE_RECORD_HPP
+
+#include <cstdint>
+
+namespace vanetza_ns3 {
+namespace trace {
+
+/**
+ * @brief Kind of a trace record
+ */
+enum class TraceEvent : uint8_t {
+    CamReceived = 1,   ///< station received a CAM from peer; x, y, speed, heading as sent
+    CourseChange = 2,  ///< station changed course; x, y, speed, heading after the change
+    SimTime = 3,       ///< Progress marker, no station
+};
+
+/**
+ * @brief Fixed-size trace record
+ * 
+ * Filled on the simulation thread without any formatting and stored
+ * column by column in the trace file, see TraceWriter.
+ */
+struct TraceRecord {
+    int64_t timeNs = 0;                       ///< Simulation time in nanoseconds
+    uint32_t station = 0;                     ///< Station the event happened at
+    uint32_t peer = 0;                        ///< Other station involved, 0 if none
+    float x = 0.0f;                           ///< X coordinate in meters
+    float y = 0.0f;                           ///< Y coordinate in meters
+    float speed = 0.0f;                       ///< Speed in m/s
+    float heading = 0.0f;                     ///< Heading in degrees
+    TraceEvent event = TraceEvent::SimTime;   ///< Kind of the record
+};
+
+/**
+ * @brief Get the name of a trace event
+ * @param event The event
+ * @return The name as written by trace_to_csv
+ */
+inline const char*
+traceEventName(TraceEvent event)
+{
+    switch (event) {
+    case TraceEvent::CamReceived:
+        return "cam_received";
+    case TraceEvent::CourseChange:
+        return "course_change";
+    case TraceEvent::SimTime:
+        return "sim_time";
+    }
+    return "unknown";
+}
+
+} // namespace trace
+} // namespace vanetza_ns3
+
+#endif // TRACE_RECORD_HPP
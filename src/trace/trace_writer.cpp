@@ -0,0 +1,139 @@
+#include "trace_writer.hpp"
+
+#include <chrono>
+
+namespace vanetza_ns3 {
+namespace trace {
+
+constexpr uint32_t TraceWriter::kVersion;
+
+namespace {
+
+template<typename T>
+void
+WriteColumn(std::FILE* file, const std::vector<T>& column)
+{
+    std::fwrite(column.data(), sizeof(T), column.size(), file);
+}
+
+} // namespace
+
+TraceWriter::TraceWriter(const std::string& path, std::size_t ringCapacity, std::size_t blockRecords) :
+    m_file(std::fopen(path.c_str(), "wb")),
+    m_ring(ringCapacity),
+    m_blockRecords(blockRecords > 0 ? blockRecords : 1),
+    m_dropped(0),
+    m_written(0),
+    m_stop(false)
+{
+    if (!m_file) {
+        return;
+    }
+    
+    // Large stdio buffer: blocks are written with a few big fwrite calls
+    std::setvbuf(m_file, nullptr, _IOFBF, 1 << 20);
+    const uint32_t header[2] = { kVersion, static_cast<uint32_t>(m_blockRecords) };
+    std::fwrite("VNTRACE1", 1, 8, m_file);
+    std::fwrite(header, sizeof(uint32_t), 2, m_file);
+    
+    m_time.reserve(m_blockRecords);
+    m_event.reserve(m_blockRecords);
+    m_station.reserve(m_blockRecords);
+    m_peer.reserve(m_blockRecords);
+    m_x.reserve(m_blockRecords);
+    m_y.reserve(m_blockRecords);
+    m_speed.reserve(m_blockRecords);
+    m_heading.reserve(m_blockRecords);
+    
+    m_thread = std::thread(&TraceWriter::run, this);
+}
+
+TraceWriter::~TraceWriter()
+{
+    close();
+}
+
+void
+TraceWriter::close()
+{
+    if (!m_file) {
+        return;
+    }
+    m_stop.store(true, std::memory_order_release);
+    m_thread.join();
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+void
+TraceWriter::run()
+{
+    for (;;) {
+        if (drain()) {
+            continue;
+        }
+        // The producer stops pushing before it sets m_stop, so one more
+        // pass after seeing it collects everything
+        if (m_stop.load(std::memory_order_acquire)) {
+            drain();
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    writeBlock();
+    std::fflush(m_file);
+}
+
+bool
+TraceWriter::drain()
+{
+    bool any = false;
+    TraceRecord record;
+    while (m_ring.tryPop(record)) {
+        m_time.push_back(record.timeNs);
+        m_event.push_back(static_cast<uint8_t>(record.event));
+        m_station.push_back(record.station);
+        m_peer.push_back(record.peer);
+        m_x.push_back(record.x);
+        m_y.push_back(record.y);
+        m_speed.push_back(record.speed);
+        m_heading.push_back(record.heading);
+        if (m_time.size() == m_blockRecords) {
+            writeBlock();
+        }
+        any = true;
+    }
+    return any;
+}
+
+void
+TraceWriter::writeBlock()
+{
+    if (m_time.empty()) {
+        return;
+    }
+    
+    const uint32_t count = static_cast<uint32_t>(m_time.size());
+    std::fwrite(&count, sizeof(count), 1, m_file);
+    WriteColumn(m_file, m_time);
+    WriteColumn(m_file, m_event);
+    WriteColumn(m_file, m_station);
+    WriteColumn(m_file, m_peer);
+    WriteColumn(m_file, m_x);
+    WriteColumn(m_file, m_y);
+    WriteColumn(m_file, m_speed);
+    WriteColumn(m_file, m_heading);
+    m_written.fetch_add(count, std::memory_order_relaxed);
+    
+    m_time.clear();
+    m_event.clear();
+    m_station.clear();
+    m_peer.clear();
+    m_x.clear();
+    m_y.clear();
+    m_speed.clear();
+    m_heading.clear();
+}
+
+} // namespace trace
+} // namespace vanetza_ns3
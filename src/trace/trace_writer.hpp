@@ -0,0 +1,132 @@
+#ifndef TRACE_WRITER_HPP
+#define TRACE_WRITER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "trace_record.hpp"
+#include "utils/spsc_ring.hpp"
+
+namespace vanetza_ns3 {
+namespace trace {
+
+/**
+ * @brief Asynchronous writer of binary trace records
+ * 
+ * The simulation thread pushes fixed-size records into a lock-free ring;
+ * a background thread drains the ring into column blocks and writes them
+ * to the file. push() never blocks, allocates or formats: if the writer
+ * falls behind and the ring is full, the record is dropped and counted.
+ * 
+ * File layout (host byte order):
+ * - header: magic "VNTRACE1", uint32 format version, uint32 records per block
+ * - blocks: uint32 record count n, then the columns
+ *   int64 timeNs[n], uint8 event[n], uint32 station[n], uint32 peer[n],
+ *   float x[n], y[n], speed[n], heading[n]
+ * 
+ * Use TraceReader or the trace_to_csv tool to read the file back.
+ */
+class TraceWriter {
+public:
+    static constexpr uint32_t kVersion = 1;  ///< File format version
+
+    /**
+     * @brief Open the trace file and start the writer thread
+     * @param path The trace file
+     * @param ringCapacity Records buffered between the threads
+     * @param blockRecords Records per column block
+     */
+    explicit TraceWriter(const std::string& path, std::size_t ringCapacity = 1 << 16,
+                         std::size_t blockRecords = 4096);
+
+    /**
+     * @brief Destructor, closes the writer
+     */
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    /**
+     * @brief Check whether the file could be opened
+     * @return True if records are written
+     */
+    bool isOpen() const { return m_file != nullptr; }
+
+    /**
+     * @brief Queue a record (simulation thread only)
+     * @param record The record
+     * @return False if the ring was full and the record was dropped
+     */
+    bool push(const TraceRecord& record)
+    {
+        if (m_ring.tryPush(record)) {
+            return true;
+        }
+        ++m_dropped;
+        return false;
+    }
+
+    /**
+     * @brief Write all queued records, stop the writer thread and close the file
+     * 
+     * Must be called from the thread that pushes. Records pushed later are dropped.
+     */
+    void close();
+
+    /**
+     * @brief Get the number of records written to the file
+     * @return The number of records
+     */
+    uint64_t written() const { return m_written.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of records dropped because the ring was full
+     * @return The number of records
+     */
+    uint64_t dropped() const { return m_dropped; }
+
+private:
+    /**
+     * @brief Writer thread: drain the ring into blocks until stopped
+     */
+    void run();
+
+    /**
+     * @brief Move all queued records into the current block
+     * @return True if any record was taken
+     */
+    bool drain();
+
+    /**
+     * @brief Write the current block to the file
+     */
+    void writeBlock();
+
+    std::FILE* m_file;                        ///< Trace file
+    utils::SpscRing<TraceRecord> m_ring;      ///< Records on their way to the writer
+    const std::size_t m_blockRecords;         ///< Records per block
+    uint64_t m_dropped;                       ///< Records dropped on a full ring (producer side)
+    std::atomic<uint64_t> m_written;          ///< Records written (writer side)
+    std::atomic<bool> m_stop;                 ///< Writer thread should finish
+    std::thread m_thread;                     ///< Writer thread
+
+    // Current block, one vector per column (writer thread only)
+    std::vector<int64_t> m_time;
+    std::vector<uint8_t> m_event;
+    std::vector<uint32_t> m_station;
+    std::vector<uint32_t> m_peer;
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_speed;
+    std::vector<float> m_heading;
+};
+
+} // namespace trace
+} // namespace vanetza_ns3
+
+#endif // TRACE_WRITER_HPP
@@ -0,0 +1,340 @@
+/**
+ * @file arena.hpp
+ * @brief Monotonic arena for objects that live as long as a simulation
+ */
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace vanetza_ns3 {
+namespace utils {
+
+/**
+ * @brief Monotonic (bump) allocator backed by large blocks
+ *
+ * Allocation advances a pointer inside the current block and opens a new
+ * block when it runs out; requests larger than a block get a block of
+ * their own. Individual allocations are never freed: the memory is
+ * returned when the arena is reset or destroyed. This suits objects that
+ * are created together and share a lifetime, such as the per-station
+ * protocol stacks of one simulation, and packs them densely instead of
+ * scattering them over the general heap.
+ *
+ * The arena does not run destructors by itself. Objects created with
+ * create() must be destroyed with destroy() (or through an ArenaPtr)
+ * before the arena goes away.
+ *
+ * mark() and rewind() turn the arena into a scratch stack: everything
+ * allocated after a mark is released at once by rewinding to it, while
+ * the blocks stay reserved for the next round (see ArenaScope).
+ */
+class Arena {
+public:
+    /**
+     * @brief Position in the arena returned by mark()
+     */
+    struct Marker {
+        std::size_t block;        ///< Block index
+        std::size_t offset;       ///< Offset inside the block
+        std::size_t bytesUsed;    ///< Bytes used at the mark
+        std::size_t allocations;  ///< Allocations at the mark
+    };
+
+    /**
+     * @brief Constructor
+     * @param blockSize Size of the blocks requested from the heap in bytes
+     */
+    explicit Arena(std::size_t blockSize = 64 * 1024) :
+        m_blockSize(blockSize),
+        m_current(0),
+        m_offset(0),
+        m_bytesUsed(0),
+        m_allocations(0),
+        m_peakBytes(0),
+        m_liveObjects(0)
+    {
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Allocate raw memory
+     * @param size Number of bytes
+     * @param alignment Alignment of the returned pointer (power of two)
+     * @return Pointer to uninitialized memory owned by the arena
+     */
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+        while (m_current < m_blocks.size()) {
+            Block& block = m_blocks[m_current];
+            const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data.get());
+            const std::size_t start = alignUp(base + m_offset, alignment) - base;
+            if (start + size <= block.size) {
+                m_offset = start + size;
+                m_bytesUsed += size;
+                m_peakBytes = std::max(m_peakBytes, m_bytesUsed);
+                ++m_allocations;
+                return block.data.get() + start;
+            }
+            // Move on to the next (previously reserved) block
+            ++m_current;
+            m_offset = 0;
+        }
+
+        Block block;
+        block.size = std::max(m_blockSize, size + alignment);
+        block.data.reset(new uint8_t[block.size]);
+        m_blocks.push_back(std::move(block));
+        m_current = m_blocks.size() - 1;
+        m_offset = 0;
+        return allocate(size, alignment);
+    }
+
+    /**
+     * @brief Construct an object inside the arena
+     * @param args Constructor arguments
+     * @return Pointer to the new object
+     */
+    template<typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        void* memory = allocate(sizeof(T), alignof(T));
+        T* object = new (memory) T(std::forward<Args>(args)...);
+        ++m_liveObjects;
+        return object;
+    }
+
+    /**
+     * @brief Destroy an object created with create()
+     *
+     * Runs the destructor only; the memory stays with the arena.
+     * @param object The object (may be nullptr)
+     */
+    template<typename T>
+    void destroy(T* object)
+    {
+        if (object) {
+            object->~T();
+            --m_liveObjects;
+        }
+    }
+
+    /**
+     * @brief Make all memory available again, keeping the blocks
+     *
+     * All objects must have been destroyed before.
+     */
+    void reset()
+    {
+        m_current = 0;
+        m_offset = 0;
+        m_bytesUsed = 0;
+        m_allocations = 0;
+    }
+
+    /**
+     * @brief Remember the current position
+     * @return Marker to pass to rewind()
+     */
+    Marker mark() const
+    {
+        return Marker { m_current, m_offset, m_bytesUsed, m_allocations };
+    }
+
+    /**
+     * @brief Release everything allocated after a mark
+     *
+     * Objects created after the mark must have been destroyed before.
+     * @param marker Marker returned by mark()
+     */
+    void rewind(const Marker& marker)
+    {
+        m_current = marker.block;
+        m_offset = marker.offset;
+        m_bytesUsed = marker.bytesUsed;
+        m_allocations = marker.allocations;
+    }
+
+    /**
+     * @brief Get the number of bytes handed out since the last reset
+     * @return The number of bytes (excluding alignment padding)
+     */
+    std::size_t bytesUsed() const { return m_bytesUsed; }
+
+    /**
+     * @brief Get the number of bytes reserved from the heap
+     * @return The number of bytes in all blocks
+     */
+    std::size_t bytesReserved() const
+    {
+        std::size_t total = 0;
+        for (const Block& block : m_blocks) {
+            total += block.size;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Get the number of allocations since the last reset
+     * @return The number of allocations
+     */
+    std::size_t allocations() const { return m_allocations; }
+
+    /**
+     * @brief Get the largest number of bytes in use at any time
+     * @return The high-water mark in bytes
+     */
+    std::size_t peakBytes() const { return m_peakBytes; }
+
+    /**
+     * @brief Get the number of objects created and not yet destroyed
+     * @return The number of live objects
+     */
+    std::size_t liveObjects() const { return m_liveObjects; }
+
+    /**
+     * @brief Get the number of blocks reserved from the heap
+     * @return The number of blocks
+     */
+    std::size_t blocks() const { return m_blocks.size(); }
+
+private:
+    struct Block {
+        std::unique_ptr<uint8_t[]> data;  ///< Block memory
+        std::size_t size = 0;             ///< Block size in bytes
+    };
+
+    static std::uintptr_t alignUp(std::uintptr_t offset, std::size_t alignment)
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    std::size_t m_blockSize;     ///< Default size of new blocks
+    std::vector<Block> m_blocks; ///< Reserved blocks
+    std::size_t m_current;       ///< Block currently allocated from
+    std::size_t m_offset;        ///< Next free byte in the current block
+    std::size_t m_bytesUsed;     ///< Bytes handed out since the last reset
+    std::size_t m_allocations;   ///< Allocations since the last reset
+    std::size_t m_peakBytes;     ///< High-water mark of m_bytesUsed
+    std::size_t m_liveObjects;   ///< Objects created and not yet destroyed
+};
+
+/**
+ * @brief Scratch region of an arena released at the end of a scope
+ *
+ * Marks the arena on construction and rewinds it on destruction, so all
+ * memory taken inside the scope is released in O(1). Scopes nest.
+ */
+class ArenaScope {
+public:
+    /**
+     * @brief Constructor
+     * @param arena The arena
+     */
+    explicit ArenaScope(Arena& arena) :
+        m_arena(arena),
+        m_marker(arena.mark())
+    {
+    }
+
+    ~ArenaScope()
+    {
+        m_arena.rewind(m_marker);
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    /**
+     * @brief Get the arena of this scope
+     * @return The arena
+     */
+    Arena& arena() { return m_arena; }
+
+    /**
+     * @brief Get the number of bytes allocated inside this scope
+     * @return The number of bytes
+     */
+    std::size_t bytesUsed() const { return m_arena.bytesUsed() - m_marker.bytesUsed; }
+
+    /**
+     * @brief Get the number of allocations made inside this scope
+     * @return The number of allocations
+     */
+    std::size_t allocations() const { return m_arena.allocations() - m_marker.allocations; }
+
+private:
+    Arena& m_arena;          ///< The arena
+    Arena::Marker m_marker;  ///< Position at construction
+};
+
+/**
+ * @brief Scratch arena for the simulator event being processed
+ *
+ * Scratch memory of one handler is taken from this arena inside an
+ * ArenaScope opened by that handler, so it is released when the handler
+ * returns. Only the adapter's frame copies (receive path and capture)
+ * use it; packets, the TX encoding and the router's PDUs are still
+ * allocated on the heap. The ns-3 scheduler runs events one at a time,
+ * so a single arena per thread is enough.
+ * @return The arena of the calling thread
+ */
+inline Arena&
+eventArena()
+{
+    static thread_local Arena arena(16 * 1024);
+    return arena;
+}
+
+/**
+ * @brief Deleter for objects created either in an arena or on the heap
+ */
+template<typename T>
+struct ArenaDeleter {
+    Arena* arena = nullptr;  ///< Owning arena, nullptr for heap objects
+
+    void operator()(T* object) const
+    {
+        if (arena) {
+            arena->destroy(object);
+        } else {
+            delete object;
+        }
+    }
+};
+
+/**
+ * @brief Owning pointer to an object in an arena (or on the heap)
+ */
+template<typename T>
+using ArenaPtr = std::unique_ptr<T, ArenaDeleter<T> >;
+
+/**
+ * @brief Create an object in an arena, or on the heap if there is none
+ * @param arena The arena, or nullptr
+ * @param args Constructor arguments
+ * @return Owning pointer to the object
+ */
+template<typename T, typename... Args>
+ArenaPtr<T> makeArenaPtr(Arena* arena, Args&&... args)
+{
+    ArenaDeleter<T> deleter;
+    deleter.arena = arena;
+    T* object = arena ? arena->create<T>(std::forward<Args>(args)...)
+                      : new T(std::forward<Args>(args)...);
+    return ArenaPtr<T>(object, deleter);
+}
+
+} // namespace utils
+} // namespace vanetza_ns3
+
+#endif // ARENA_HPP
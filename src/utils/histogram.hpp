@@ -0,0 +1,170 @@
+/**
+ * @file histogram.hpp
+ * @brief Fixed-bucket histogram for streaming statistics
+ */
+
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vanetza_ns3 {
+namespace utils {
+
+/**
+ * @brief Histogram over equally wide bins starting at zero
+ * 
+ * The bins are allocated once, so memory does not grow with the number of
+ * samples. Values at or above the last bin are counted in an overflow
+ * bin; negative values are clamped into the first bin. The exact sum,
+ * minimum and maximum are kept besides the bins, so the mean is exact and
+ * quantiles are accurate to one bin width.
+ */
+class Histogram {
+public:
+    /**
+     * @brief Constructor
+     * @param binWidth Width of a bin
+     * @param bins Number of bins, not counting the overflow bin
+     */
+    explicit Histogram(double binWidth = 1.0, std::size_t bins = 100) :
+        m_binWidth(binWidth),
+        m_inverseBinWidth(1.0 / binWidth),
+        m_counts(bins + 1, 0),
+        m_samples(0),
+        m_sum(0.0),
+        m_min(0.0),
+        m_max(0.0)
+    {
+    }
+
+    /**
+     * @brief Add a sample
+     * @param value The sample
+     */
+    void add(double value)
+    {
+        ++m_counts[binOf(value)];
+        if (m_samples == 0 || value < m_min) {
+            m_min = value;
+        }
+        if (m_samples == 0 || value > m_max) {
+            m_max = value;
+        }
+        ++m_samples;
+        m_sum += value;
+    }
+
+    /**
+     * @brief Get the bin a value falls into
+     * @param value The value
+     * @return The bin index, bins() for the overflow bin
+     */
+    std::size_t binOf(double value) const
+    {
+        if (!(value > 0.0)) {
+            return 0;
+        }
+        const double bin = std::floor(value * m_inverseBinWidth);
+        return bin < static_cast<double>(bins()) ? static_cast<std::size_t>(bin) : bins();
+    }
+
+    /**
+     * @brief Get the width of a bin
+     * @return The bin width
+     */
+    double binWidth() const { return m_binWidth; }
+
+    /**
+     * @brief Get the number of bins, not counting the overflow bin
+     * @return The number of bins
+     */
+    std::size_t bins() const { return m_counts.size() - 1; }
+
+    /**
+     * @brief Get the number of samples in a bin
+     * @param bin The bin index, bins() for the overflow bin
+     * @return The number of samples
+     */
+    uint64_t count(std::size_t bin) const { return m_counts[bin]; }
+
+    /**
+     * @brief Get the number of samples
+     * @return The number of samples
+     */
+    uint64_t samples() const { return m_samples; }
+
+    /**
+     * @brief Get the mean of all samples
+     * @return The mean, 0 without samples
+     */
+    double mean() const { return m_samples ? m_sum / m_samples : 0.0; }
+
+    /**
+     * @brief Get the smallest sample
+     * @return The minimum, 0 without samples
+     */
+    double min() const { return m_min; }
+
+    /**
+     * @brief Get the largest sample
+     * @return The maximum, 0 without samples
+     */
+    double max() const { return m_max; }
+
+    /**
+     * @brief Estimate a quantile from the bins
+     * 
+     * Interpolates linearly within the bin holding the quantile. Quantiles
+     * in the overflow bin are reported as the maximum.
+     * @param q The quantile in [0, 1]
+     * @return The estimate, 0 without samples
+     */
+    double quantile(double q) const
+    {
+        if (m_samples == 0) {
+            return 0.0;
+        }
+        const double rank = q * static_cast<double>(m_samples);
+        double seen = 0.0;
+        for (std::size_t bin = 0; bin < bins(); ++bin) {
+            const double next = seen + static_cast<double>(m_counts[bin]);
+            if (m_counts[bin] > 0 && next >= rank) {
+                const double within = (rank - seen) / static_cast<double>(m_counts[bin]);
+                return (static_cast<double>(bin) + within) * m_binWidth;
+            }
+            seen = next;
+        }
+        return m_max;
+    }
+
+    /**
+     * @brief Remove all samples, keeping the bins
+     */
+    void clear()
+    {
+        std::fill(m_counts.begin(), m_counts.end(), 0);
+        m_samples = 0;
+        m_sum = 0.0;
+        m_min = 0.0;
+        m_max = 0.0;
+    }
+
+private:
+    double m_binWidth;               ///< Width of a bin
+    double m_inverseBinWidth;        ///< 1 / bin width
+    std::vector<uint64_t> m_counts;  ///< Samples per bin, the last one is the overflow bin
+    uint64_t m_samples;              ///< Number of samples
+    double m_sum;                    ///< Sum of all samples
+    double m_min;                    ///< Smallest sample
+    double m_max;                    ///< Largest sample
+};
+
+} // namespace utils
+} // namespace vanetza_ns3
+
+#endif // HISTOGRAM_HPP
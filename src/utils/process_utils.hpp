@@ -0,0 +1,173 @@
+/**
+ * @file process_utils.hpp
+ * @brief Spawning worker processes and process resource usage (POSIX)
+ */
+
+#ifndef PROCESS_UTILS_HPP
+#define PROCESS_UTILS_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace vanetza_ns3 {
+namespace utils {
+
+/**
+ * @brief A running child process whose stdout is read through a pipe
+ */
+struct ChildProcess {
+    pid_t pid = -1;      ///< Process ID, -1 if spawning failed
+    int stdoutFd = -1;   ///< Read end of the child's stdout
+    std::string output;  ///< Output read so far
+};
+
+/**
+ * @brief Start a program with its stdout connected to a pipe
+ *
+ * The child's stderr is discarded unless keepStderr is set. The read end
+ * of the pipe is non-blocking, see readAvailable().
+ * @param argv Program path followed by its arguments
+ * @param keepStderr Pass the child's stderr through to ours
+ * @return The child, with pid -1 on failure
+ */
+inline ChildProcess
+spawnProcess(const std::vector<std::string>& argv, bool keepStderr = false)
+{
+    ChildProcess child;
+    int fds[2];
+    if (argv.empty() || pipe(fds) != 0) {
+        return child;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return child;
+    }
+
+    if (pid == 0) {
+        // Child: stdout into the pipe, then replace the process image
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        if (!keepStderr) {
+            int null = open("/dev/null", O_WRONLY);
+            if (null >= 0) {
+                dup2(null, STDERR_FILENO);
+                close(null);
+            }
+        }
+        std::vector<char*> args;
+        for (const std::string& arg : argv) {
+            args.push_back(const_cast<char*>(arg.c_str()));
+        }
+        args.push_back(nullptr);
+        execv(args[0], args.data());
+        _exit(127);
+    }
+
+    close(fds[1]);
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    child.pid = pid;
+    child.stdoutFd = fds[0];
+    return child;
+}
+
+/**
+ * @brief Append whatever the child has written to its output
+ * @param child The child
+ * @return False once the child closed its stdout
+ */
+inline bool
+readAvailable(ChildProcess& child)
+{
+    char buffer[4096];
+    for (;;) {
+        ssize_t n = read(child.stdoutFd, buffer, sizeof(buffer));
+        if (n > 0) {
+            child.output.append(buffer, static_cast<std::size_t>(n));
+        } else if (n == 0) {
+            return false;
+        } else {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+    }
+}
+
+/**
+ * @brief Close the pipe and reap the child
+ * @param child The child
+ * @return The exit status, or -1 if the child did not exit normally
+ */
+inline int
+waitProcess(ChildProcess& child)
+{
+    if (child.stdoutFd >= 0) {
+        close(child.stdoutFd);
+        child.stdoutFd = -1;
+    }
+    int status = 0;
+    while (waitpid(child.pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/**
+ * @brief Get the resident set size of this process (Linux)
+ * @return The RSS in bytes, 0 if unavailable
+ */
+inline uint64_t
+currentRssBytes()
+{
+    unsigned long long pages = 0;
+    unsigned long long resident = 0;
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return 0;
+    }
+    int fields = std::fscanf(statm, "%llu %llu", &pages, &resident);
+    std::fclose(statm);
+    return fields == 2 ? resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) : 0;
+}
+
+/**
+ * @brief Get the peak resident set size of this process
+ * @return The peak RSS in bytes
+ */
+inline uint64_t
+peakRssBytes()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;  // kilobytes on Linux
+}
+
+/**
+ * @brief 64-bit FNV-1a hash
+ * @param text The text to hash
+ * @return The hash value
+ */
+inline uint64_t
+fnv1a64(const std::string& text)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace utils
+} // namespace vanetza_ns3
+
+#endif // PROCESS_UTILS_HPP
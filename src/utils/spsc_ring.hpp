@@ -0,0 +1,124 @@
+/**
+ * @file spsc_ring.hpp
+ * @brief Bounded lock-free single-producer single-consumer ring buffer
+ */
+
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace vanetza_ns3 {
+namespace utils {
+
+/**
+ * @brief Fixed-capacity ring buffer for one producer and one consumer thread
+ * 
+ * Neither side ever blocks or allocates: tryPush() fails when the ring is
+ * full and tryPop() fails when it is empty. Each side keeps a cached copy
+ * of the other side's index and only reloads it when the cached value says
+ * full (or empty), so in steady state an operation touches a single shared
+ * cache line. Elements are copied, so T should be a small trivially
+ * copyable record.
+ */
+template<typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing elements must be trivially copyable");
+
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Minimum number of elements, rounded up to a power of two
+     */
+    explicit SpscRing(std::size_t capacity) :
+        m_mask(roundUp(capacity) - 1),
+        m_slots(new T[m_mask + 1]),
+        m_head(0),
+        m_tail(0),
+        m_cachedTail(0),
+        m_cachedHead(0)
+    {
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Append an element (producer thread only)
+     * @param value The element
+     * @return False if the ring is full and the element was not added
+     */
+    bool tryPush(const T& value)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail > m_mask) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail > m_mask) {
+                return false;
+            }
+        }
+        m_slots[head & m_mask] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element (consumer thread only)
+     * @param value Receives the element
+     * @return False if the ring is empty
+     */
+    bool tryPop(T& value)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_cachedHead) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail == m_cachedHead) {
+                return false;
+            }
+        }
+        value = m_slots[tail & m_mask];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Check whether the ring is empty (approximate while both sides run)
+     * @return True if no element is queued
+     */
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Get the number of slots
+     * @return The capacity
+     */
+    std::size_t capacity() const { return m_mask + 1; }
+
+private:
+    static std::size_t roundUp(std::size_t n)
+    {
+        std::size_t capacity = 2;
+        while (capacity < n) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    const std::size_t m_mask;                   ///< Capacity - 1
+    std::unique_ptr<T[]> m_slots;               ///< Element storage
+
+    alignas(64) std::atomic<std::size_t> m_head;  ///< Next slot to write, owned by the producer
+    alignas(64) std::atomic<std::size_t> m_tail;  ///< Next slot to read, owned by the consumer
+    alignas(64) std::size_t m_cachedTail;         ///< Producer's copy of m_tail
+    alignas(64) std::size_t m_cachedHead;         ///< Consumer's copy of m_head
+};
+
+} // namespace utils
+} // namespace vanetza_ns3
+
+#endif // SPSC_RING_HPP
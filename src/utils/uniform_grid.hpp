@@ -0,0 +1,190 @@
+/**
+ * @file uniform_grid.hpp
+ * @brief Uniform grid spatial index over a set of 2D points
+ */
+
+#ifndef UNIFORM_GRID_HPP
+#define UNIFORM_GRID_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vanetza_ns3 {
+namespace utils {
+
+/**
+ * @brief Bucketed uniform grid rebuilt in bulk from point arrays
+ * 
+ * Points are sorted into hashed grid cells with a counting sort, so the
+ * index is stored as a few flat arrays (compressed rows) and a rebuild is
+ * a linear pass. Cells are hashed into a power-of-two bucket table, which
+ * keeps memory proportional to the number of points rather than to the
+ * covered area. Queries visit each bucket at most once and check the exact
+ * distance, so hash collisions only cost time, never correctness.
+ */
+class UniformGrid {
+public:
+    /**
+     * @brief Constructor
+     * @param cellSize Edge length of a grid cell in meters
+     */
+    explicit UniformGrid(double cellSize = 100.0) :
+        m_cellSize(cellSize),
+        m_inverseCellSize(1.0 / cellSize),
+        m_mask(0),
+        m_stamp(0)
+    {
+    }
+
+    /**
+     * @brief Set the edge length of a grid cell (takes effect on the next build)
+     * @param cellSize Edge length in meters
+     */
+    void setCellSize(double cellSize)
+    {
+        m_cellSize = cellSize;
+        m_inverseCellSize = 1.0 / cellSize;
+    }
+
+    /**
+     * @brief Get the edge length of a grid cell
+     * @return Edge length in meters
+     */
+    double cellSize() const { return m_cellSize; }
+
+    /**
+     * @brief Get the number of indexed points
+     * @return The number of points
+     */
+    std::size_t size() const { return m_index.size(); }
+
+    /**
+     * @brief Rebuild the index from point arrays
+     * @param x X coordinates
+     * @param y Y coordinates
+     * @param n Number of points; point i is reported as index i by queries
+     */
+    void build(const float* x, const float* y, std::size_t n)
+    {
+        std::size_t buckets = 16;
+        while (buckets < n) {
+            buckets <<= 1;
+        }
+        m_mask = buckets - 1;
+        
+        m_start.assign(buckets + 1, 0);
+        m_bucketOf.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            uint32_t b = bucket(cell(x[i]), cell(y[i]));
+            m_bucketOf[i] = b;
+            ++m_start[b + 1];
+        }
+        for (std::size_t b = 0; b < buckets; ++b) {
+            m_start[b + 1] += m_start[b];
+        }
+        
+        m_index.resize(n);
+        m_x.resize(n);
+        m_y.resize(n);
+        m_fill.assign(m_start.begin(), m_start.end() - 1);
+        for (std::size_t i = 0; i < n; ++i) {
+            uint32_t slot = m_fill[m_bucketOf[i]]++;
+            m_index[slot] = static_cast<uint32_t>(i);
+            m_x[slot] = x[i];
+            m_y[slot] = y[i];
+        }
+        
+        m_visited.assign(buckets, 0);
+        m_stamp = 0;
+    }
+
+    /**
+     * @brief Visit all points within a radius of a location
+     * @param cx X coordinate of the query center
+     * @param cy Y coordinate of the query center
+     * @param radius Query radius in meters
+     * @param visit Called as visit(index, squaredDistance) for every point in range
+     */
+    template<typename Visitor>
+    void forEachWithin(float cx, float cy, float radius, Visitor&& visit) const
+    {
+        if (m_index.empty()) {
+            return;
+        }
+        
+        if (++m_stamp == 0) {
+            std::fill(m_visited.begin(), m_visited.end(), 0);
+            m_stamp = 1;
+        }
+        
+        const float r2 = radius * radius;
+        
+        // Large radii cover more cells than there are buckets: scan everything
+        const double span = 2.0 * radius * m_inverseCellSize + 1.0;
+        if (span * span > static_cast<double>(m_mask) + 1.0) {
+            for (std::size_t s = 0; s < m_index.size(); ++s) {
+                const float dx = m_x[s] - cx;
+                const float dy = m_y[s] - cy;
+                const float d2 = dx * dx + dy * dy;
+                if (d2 <= r2) {
+                    visit(m_index[s], d2);
+                }
+            }
+            return;
+        }
+        
+        const int32_t x0 = cell(cx - radius);
+        const int32_t x1 = cell(cx + radius);
+        const int32_t y0 = cell(cy - radius);
+        const int32_t y1 = cell(cy + radius);
+        for (int32_t ix = x0; ix <= x1; ++ix) {
+            for (int32_t iy = y0; iy <= y1; ++iy) {
+                uint32_t b = bucket(ix, iy);
+                if (m_visited[b] == m_stamp) {
+                    continue;
+                }
+                m_visited[b] = m_stamp;
+                for (uint32_t s = m_start[b]; s < m_start[b + 1]; ++s) {
+                    const float dx = m_x[s] - cx;
+                    const float dy = m_y[s] - cy;
+                    const float d2 = dx * dx + dy * dy;
+                    if (d2 <= r2) {
+                        visit(m_index[s], d2);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    int32_t cell(float v) const
+    {
+        return static_cast<int32_t>(std::floor(v * m_inverseCellSize));
+    }
+
+    uint32_t bucket(int32_t ix, int32_t iy) const
+    {
+        uint32_t h = static_cast<uint32_t>(ix) * 73856093u ^ static_cast<uint32_t>(iy) * 19349663u;
+        return h & m_mask;
+    }
+
+    double m_cellSize;                       ///< Edge length of a cell
+    double m_inverseCellSize;                ///< 1 / cell size
+    uint32_t m_mask;                         ///< Bucket count - 1
+    std::vector<uint32_t> m_start;           ///< First slot of each bucket (size buckets + 1)
+    std::vector<uint32_t> m_index;           ///< Point index per slot
+    std::vector<float> m_x;                  ///< X coordinate per slot
+    std::vector<float> m_y;                  ///< Y coordinate per slot
+    std::vector<uint32_t> m_bucketOf;        ///< Build scratch: bucket per point
+    std::vector<uint32_t> m_fill;            ///< Build scratch: next free slot per bucket
+    mutable std::vector<uint32_t> m_visited; ///< Query scratch: stamp per bucket
+    mutable uint32_t m_stamp;                ///< Query scratch: current stamp
+};
+
+} // namespace utils
+} // namespace vanetza_ns3
+
+#endif // UNIFORM_GRID_HPP